@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+#
+# Netero sources under BSD-3-Clause
+# see LICENSE.txt
+#
+
+"""Compare a NeteroBench JSON report with a stored baseline.
+
+Produce the reports with:
+    NeteroBench --benchmark_out=current.json --benchmark_out_format=json
+
+Exit with 1 when at least one benchmark is slower than the baseline by more
+than the threshold, so the script can gate a CI job.
+"""
+
+import argparse
+import json
+import shutil
+import sys
+
+
+def load(path, metric):
+    with open(path) as report:
+        data = json.load(report)
+    results = {}
+    for benchmark in data.get("benchmarks", []):
+        # Repetitions produce aggregates, compare the median only when present.
+        if benchmark.get("run_type") == "aggregate" and benchmark.get("aggregate_name") != "median":
+            continue
+        if "error_occurred" in benchmark and benchmark["error_occurred"]:
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        results[name] = benchmark[metric]
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="stored baseline report")
+    parser.add_argument("current", help="report of the build under test")
+    parser.add_argument("--threshold", type=float, default=10.,
+                        help="tolerated slowdown in percent (default: 10)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="cpu_time",
+                        help="time compared (default: cpu_time)")
+    parser.add_argument("--update", action="store_true",
+                        help="replace the baseline by the current report after the comparison")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    regressions = 0
+    width = max((len(name) for name in list(baseline) + list(current)), default=0)
+    for name, time in current.items():
+        if name not in baseline:
+            print("{:<{}}  {:>12.1f}  new".format(name, width, time))
+            continue
+        reference = baseline[name]
+        delta = (time - reference) / reference * 100. if reference > 0 else 0.
+        status = ""
+        if delta > args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif delta < -args.threshold:
+            status = "improvement"
+        print("{:<{}}  {:>12.1f}  {:>12.1f}  {:>+7.1f}%  {}".format(
+            name, width, reference, time, delta, status))
+    for name in baseline:
+        if name not in current:
+            print("{:<{}}  {:>12.1f}  missing".format(name, width, baseline[name]))
+
+    if args.update:
+        shutil.copyfile(args.current, args.baseline)
+    if regressions:
+        print("{} benchmark(s) regressed by more than {}%".format(regressions, args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,179 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <Netero/Avl.hpp>
+#include <Netero/Buffer.hpp>
+#include <Netero/PerfCounters.hpp>
+#include <Netero/Set.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "perf_report.hpp"
+
+namespace {
+
+    std::vector<int> GenerateKeys(std::size_t count)
+    {
+        std::vector<int> keys(count);
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            keys[idx] = static_cast<int>(idx);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+        return keys;
+    }
+
+    std::unique_ptr<Netero::SharedBuffer<float>> g_buffer;
+
+    const bool g_perfContext = []() {
+        benchmark::AddCustomContext("perf_counters",
+                                    Netero::PerfCounters().IsAvailable()
+                                        ? "available"
+                                        : "unavailable, see /proc/sys/kernel/perf_event_paranoid");
+        return true;
+    }();
+
+} // namespace
+
+/**
+ * Even threads write blocks, odd threads read them back, a single thread does both.
+ * The counter is the amount of samples moved through the buffer.
+ */
+static void SharedBuffer_Throughput(benchmark::State& state)
+{
+    const auto         blocks = static_cast<std::size_t>(state.range(0));
+    std::vector<float> samples(blocks, 1.f);
+    if (state.thread_index() == 0) {
+        g_buffer = std::make_unique<Netero::SharedBuffer<float>>(blocks * 8);
+    }
+    const bool   writer = state.thread_index() % 2 == 0;
+    const bool   reader = state.thread_index() % 2 == 1 || state.threads() == 1;
+    std::int64_t moved = 0;
+    for (auto _ : state) {
+        if (writer) {
+            moved += g_buffer->Write(samples.data(), blocks);
+        }
+        if (reader) {
+            moved += g_buffer->Read(samples.data(), blocks);
+        }
+    }
+    state.SetItemsProcessed(moved);
+    state.SetBytesProcessed(moved * static_cast<std::int64_t>(sizeof(float)));
+    if (state.thread_index() == 0) {
+        g_buffer.reset();
+    }
+}
+BENCHMARK(SharedBuffer_Throughput)->Arg(64)->Arg(1024)->ThreadRange(1, 8)->UseRealTime();
+
+static void Avl_Insert(benchmark::State& state)
+{
+    const auto        keys = GenerateKeys(static_cast<std::size_t>(state.range(0)));
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        Netero::Avl<int> tree;
+        for (int key : keys) {
+            tree.Insert(key);
+        }
+        benchmark::DoNotOptimize(tree.Empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Avl_Insert)->RangeMultiplier(8)->Range(64, 4096);
+
+static void StdSet_Insert(benchmark::State& state)
+{
+    const auto        keys = GenerateKeys(static_cast<std::size_t>(state.range(0)));
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        std::set<int> tree;
+        for (int key : keys) {
+            tree.insert(key);
+        }
+        benchmark::DoNotOptimize(tree.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(StdSet_Insert)->RangeMultiplier(8)->Range(64, 4096);
+
+static void Avl_Find(benchmark::State& state)
+{
+    const auto       keys = GenerateKeys(static_cast<std::size_t>(state.range(0)));
+    Netero::Avl<int> tree;
+    for (int key : keys) {
+        tree.Insert(key);
+    }
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        for (int key : keys) {
+            benchmark::DoNotOptimize(tree.Find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Avl_Find)->RangeMultiplier(8)->Range(64, 32768);
+
+static void StdSet_Find(benchmark::State& state)
+{
+    const auto        keys = GenerateKeys(static_cast<std::size_t>(state.range(0)));
+    std::set<int>     tree(keys.begin(), keys.end());
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        for (int key : keys) {
+            benchmark::DoNotOptimize(tree.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(StdSet_Find)->RangeMultiplier(8)->Range(64, 32768);
+
+/**
+ * Worst case of the ECS signature match: the subset is fully contained in the other set.
+ */
+static void Set_IsSubsetOf(benchmark::State& state)
+{
+    const auto       size = static_cast<int>(state.range(0));
+    Netero::Set<int> subset;
+    std::set<int>    other;
+    for (int idx = 0; idx < size * 4; ++idx) {
+        other.insert(idx);
+        if (idx % 4 == 0) {
+            subset.insert(idx);
+        }
+    }
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(subset.IsSubsetOf(other));
+    }
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Set_IsSubsetOf)->RangeMultiplier(4)->Range(4, 1024);
+
+/**
+ * Worst case of the exclude filter: no common element.
+ */
+static void Set_InterWith(benchmark::State& state)
+{
+    const auto       size = static_cast<int>(state.range(0));
+    Netero::Set<int> odd;
+    std::set<int>    even;
+    for (int idx = 0; idx < size; ++idx) {
+        odd.insert(idx * 2 + 1);
+        even.insert(idx * 2);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(odd.InterWith(even));
+    }
+}
+BENCHMARK(Set_InterWith)->RangeMultiplier(4)->Range(4, 1024);
@@ -0,0 +1,40 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <vector>
+
+#include <Netero/Fast/Easing.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "perf_report.hpp"
+
+static void Fast_QuadScalar(benchmark::State& state)
+{
+    std::vector<float> values(static_cast<std::size_t>(state.range(0)), 0.5f);
+    Bench::PerfReport  report;
+    for (auto _ : state) {
+        for (const float value : values) {
+            benchmark::DoNotOptimize(Netero::Fast::Quad(value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Fast_QuadScalar)->RangeMultiplier(8)->Range(64, 32768);
+
+static void Fast_QuadBuffer(benchmark::State& state)
+{
+    // The kernel run in place, 1 is a fixed point of the easing.
+    std::vector<float> values(static_cast<std::size_t>(state.range(0)), 1.f);
+    Bench::PerfReport  report;
+    for (auto _ : state) {
+        Netero::Fast::Quad(values.data(), values.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Fast_QuadBuffer)->RangeMultiplier(8)->Range(64, 32768);
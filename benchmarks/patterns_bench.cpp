@@ -0,0 +1,235 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <memory>
+#include <vector>
+
+#include <Netero/ECS/Component.hpp>
+#include <Netero/ECS/Snapshot.hpp>
+#include <Netero/ECS/System.hpp>
+#include <Netero/ECS/World.hpp>
+#include <Netero/Signal.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "perf_report.hpp"
+
+namespace {
+
+    int g_accumulator = 0;
+
+    void Accumulate(int value)
+    {
+        benchmark::DoNotOptimize(g_accumulator += value);
+    }
+
+    struct Position: public Netero::ECS::Component {
+        Position(float x = 0.f, float y = 0.f): x(x), y(y) {}
+        float x;
+        float y;
+    };
+
+    struct Velocity: public Netero::ECS::Component {
+        Velocity(float dx = 0.f, float dy = 0.f): dx(dx), dy(dy) {}
+        float dx;
+        float dy;
+    };
+
+    struct Body {
+        float x;
+        float y;
+        float dx;
+        float dy;
+    };
+
+    struct Health {
+        int value;
+    };
+
+    class MoveSystem: public Netero::ECS::System<Netero::ECS::ComponentFilter<Position, Velocity>> {
+        public:
+        void exec() final
+        {
+            for (auto entity : GetActiveEntities()) {
+                auto&       position = entity->GetComponent<Position>();
+                const auto& velocity = entity->GetComponent<Velocity>();
+                position.x += velocity.dx;
+                position.y += velocity.dy;
+            }
+        }
+    };
+
+    class EachMoveSystem:
+        public Netero::ECS::System<Netero::ECS::ComponentFilter<Position, Velocity>,
+                                   Netero::ECS::ComponentFilter<>,
+                                   Netero::ECS::Access<Position, const Velocity>> {
+        public:
+        void exec() final
+        {
+            Each<Position, const Velocity>([](Position& position, const Velocity& velocity) {
+                position.x += velocity.dx;
+                position.y += velocity.dy;
+            });
+        }
+    };
+
+    class ReactSystem:
+        public Netero::ECS::System<Netero::ECS::ComponentFilter<Position>,
+                                   Netero::ECS::ComponentFilter<>,
+                                   Netero::ECS::Access<Netero::ECS::Changed<const Position>>> {
+        public:
+        void exec() final
+        {
+            Each<Netero::ECS::Changed<const Position>>(
+                [](const Position& position) { Accumulate(static_cast<int>(position.x)); });
+        }
+    };
+
+} // namespace
+
+static void Signal_Emit(benchmark::State& state)
+{
+    Netero::Signal<void(int)>                           signal;
+    std::vector<std::unique_ptr<Netero::Slot<void(int)>>> slots;
+    for (int64_t idx = 0; idx < state.range(0); ++idx) {
+        slots.push_back(std::make_unique<Netero::Slot<void(int)>>(&Accumulate));
+        signal.Connect(slots.back().get());
+    }
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        signal(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK(Signal_Emit)->RangeMultiplier(4)->Range(1, 256);
+
+/**
+ * One system over every entity, only half of them carry a Velocity and match its filter.
+ * MoveSystem look the components up per entity, EachMoveSystem walk the chunks.
+ */
+template<typename System>
+static void World_Update(benchmark::State& state)
+{
+    Netero::ECS::World world;
+    world.AddSystem<System>();
+    for (int64_t idx = 0; idx < state.range(0); ++idx) {
+        Netero::ECS::Entity entity = world.CreateEntity();
+        entity->AddComponent<Position>();
+        if (idx % 2 == 0) {
+            entity->AddComponent<Velocity>(1.f, 1.f);
+        }
+        entity.Enable();
+    }
+    world.Update();
+    Bench::PerfReport report;
+    for (auto _ : state) {
+        world.Update();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    report.Finish(state, state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(World_Update, MoveSystem)
+    ->RangeMultiplier(4)
+    ->Range(64, 65536)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(World_Update, EachMoveSystem)
+    ->RangeMultiplier(4)
+    ->Range(64, 65536)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Spawn then kill a wave of entities owning a Position and a Velocity, one by one or
+ * copied from a prototype.
+ */
+static void World_SpawnWave(benchmark::State& state)
+{
+    Netero::ECS::World  world;
+    const bool          batched = state.range(1) != 0;
+    Netero::ECS::Entity prototype = world.CreateEntity();
+    prototype->AddComponent<Position>();
+    prototype->AddComponent<Velocity>(1.f, 1.f);
+    std::vector<Netero::ECS::Entity> entities;
+    for (auto _ : state) {
+        if (batched) {
+            entities = world.CreateEntities(static_cast<std::size_t>(state.range(0)), prototype);
+        }
+        else {
+            entities.clear();
+            for (int64_t idx = 0; idx < state.range(0); ++idx) {
+                entities.push_back(world.CreateEntity());
+                entities.back()->AddComponent<Position>();
+                entities.back()->AddComponent<Velocity>(1.f, 1.f);
+            }
+        }
+        for (auto& entity : entities) {
+            world.KillEntity(entity);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(World_SpawnWave)
+    ->ArgsProduct({ { 1024, 102400 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * A system reacting to the Position changed since its last run, among 65536 entities of
+ * which range(0) are changed before each update, spread over the whole world.
+ */
+static void World_ReactUpdate(benchmark::State& state)
+{
+    Netero::ECS::World               world;
+    std::vector<Netero::ECS::Entity> entities;
+    world.AddSystem<ReactSystem>();
+    for (int idx = 0; idx < 65536; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>();
+        entities.back().Enable();
+    }
+    world.Update();
+    const std::size_t stride = entities.size() / static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        for (std::size_t idx = 0; idx < entities.size(); idx += stride) {
+            entities[idx]->GetComponent<Position>().x += 1.f;
+        }
+        world.Update();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(World_ReactUpdate)
+    ->RangeMultiplier(16)
+    ->Range(16, 65536)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Capture, or capture and restore, a world of range(0) entities owning a Body, one in
+ * four owning a Health as well.
+ */
+static void World_Snapshot(benchmark::State& state)
+{
+    Netero::ECS::SnapshotRegistry registry;
+    registry.Register<Body>("Body");
+    registry.Register<Health>("Health");
+    Netero::ECS::World  world;
+    Netero::ECS::Entity prototype = world.CreateEntity();
+    prototype->AddComponent<Body>(Body { 0.f, 0.f, 1.f, 1.f });
+    const auto count = static_cast<std::size_t>(state.range(0));
+    world.CreateEntities(count - count / 4 - 1, prototype, true);
+    prototype->AddComponent<Health>(Health { 100 });
+    world.CreateEntities(count / 4, prototype, true);
+    const bool            restore = state.range(1) != 0;
+    Netero::ECS::Snapshot checkpoint;
+    for (auto _ : state) {
+        checkpoint.Capture(world, registry);
+        if (restore) {
+            checkpoint.Restore(world, registry);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(checkpoint.GetSize()));
+}
+BENCHMARK(World_Snapshot)
+    ->ArgsProduct({ { 65536, 1048576 }, { 0, 1 } })
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,57 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <Netero/PerfCounters.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace Bench {
+
+/**
+ * @brief Count the hardware events of the benchmark loop and report them per element
+ * next to the timings, nothing is reported where perf events are not permitted.
+ * @code
+ * Bench::PerfReport report;
+ * for (auto _ : state) { ... }
+ * report.Finish(state, state.iterations() * elementsPerIteration);
+ * @endcode
+ */
+class PerfReport {
+    public:
+    PerfReport() noexcept
+    {
+        _counters.Enable();
+        _begin = _counters.Read();
+    }
+
+    void Finish(benchmark::State& state, std::int64_t elements)
+    {
+        using Event = Netero::PerfCounters::Event;
+        const auto sample = _counters.Read() - _begin;
+        const auto perElement = [&](const char* name, Event event) {
+            if (sample.IsAvailable(event) && elements > 0) {
+                state.counters[name] =
+                    static_cast<double>(sample.Get(event)) / static_cast<double>(elements);
+            }
+        };
+        if (sample.GetIpc() > 0.) {
+            state.counters["IPC"] = sample.GetIpc();
+        }
+        perElement("cycles/elem", Event::CYCLES);
+        perElement("cache_misses/elem", Event::CACHE_MISSES);
+        perElement("branch_misses/elem", Event::BRANCH_MISSES);
+        perElement("tlb_misses/elem", Event::TLB_MISSES);
+    }
+
+    private:
+    Netero::PerfCounters         _counters;
+    Netero::PerfCounters::Sample _begin;
+};
+
+} // namespace Bench
@@ -8,6 +8,14 @@
 #include <chrono>
 #include <thread>
 
+#include <Netero/Metrics.hpp>
+#include <Netero/Profiler.hpp>
+
+static Netero::Metrics::Histogram &g_processing_duration =
+    Netero::Metrics::Registry::GetDefault().GetHistogram("audio.processing_callback_ns");
+static Netero::Metrics::Histogram &g_acquisition_duration =
+    Netero::Metrics::Registry::GetDefault().GetHistogram("audio.acquisition_callback_ns");
+
 Netero::Audio::Device::~Device() = default;
 
 static std::string cf_string_to_std_string(CFStringRef &cf_str)
@@ -161,6 +169,8 @@ OSStatus DeviceImpl::NativeCallbackHandler(AudioDeviceID inDevice,
     auto *device = reinterpret_cast<DeviceImpl *>(context);
     if (device->_id == inDevice) {
         if (device->_scope == kAudioObjectPropertyScopeOutput) {
+            NETERO_PROFILE_SCOPE("Audio::ProcessingCallback");
+            Netero::Metrics::ScopedTimer timer(g_processing_duration);
             auto *buffer =
                 reinterpret_cast<float *>(outOutputData->mBuffers[device->_bufferIdx].mData);
             size_t frames = outOutputData->mBuffers[device->_bufferIdx].mDataByteSize /
@@ -169,6 +179,8 @@ OSStatus DeviceImpl::NativeCallbackHandler(AudioDeviceID inDevice,
             device->_processingCallback(buffer, frames);
         }
         else if (device->_scope == kAudioObjectPropertyScopeInput) {
+            NETERO_PROFILE_SCOPE("Audio::AcquisitionCallback");
+            Netero::Metrics::ScopedTimer timer(g_acquisition_duration);
             const auto *buffer =
                 reinterpret_cast<const float *>(inInputData->mBuffers[device->_bufferIdx].mData);
             size_t frames = inInputData->mBuffers[device->_bufferIdx].mDataByteSize /
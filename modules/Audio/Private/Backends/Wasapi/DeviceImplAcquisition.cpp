@@ -9,6 +9,12 @@
 #include <audiopolicy.h>
 #include <avrt.h>
 
+#include <Netero/Metrics.hpp>
+#include <Netero/Profiler.hpp>
+
+static Netero::Metrics::Histogram& g_acquisition_duration =
+    Netero::Metrics::Registry::GetDefault().GetHistogram("audio.acquisition_callback_ns");
+
 Netero::Audio::Device::RtCode DeviceImpl::AcquisitionNativeCallback(DeviceImpl* aContext)
 {
     REFERENCE_TIME        latency;
@@ -78,7 +84,11 @@ Netero::Audio::Device::RtCode DeviceImpl::AcquisitionNativeCallback(DeviceImpl*
             if (FAILED(result) || buffer == nullptr) {
                 goto exit_on_error;
             }
-            aContext->_acquisitionCallback(reinterpret_cast<const float*>(buffer), padding);
+            {
+                NETERO_PROFILE_SCOPE("Audio::AcquisitionCallback");
+                Netero::Metrics::ScopedTimer timer(g_acquisition_duration);
+                aContext->_acquisitionCallback(reinterpret_cast<const float*>(buffer), padding);
+            }
             result = audioCaptureClient->ReleaseBuffer(padding);
             if (FAILED(result)) {
                 goto exit_on_error;
@@ -9,6 +9,12 @@
 #include <audiopolicy.h>
 #include <avrt.h>
 
+#include <Netero/Metrics.hpp>
+#include <Netero/Profiler.hpp>
+
+static Netero::Metrics::Histogram& g_processing_duration =
+    Netero::Metrics::Registry::GetDefault().GetHistogram("audio.processing_callback_ns");
+
 Netero::Audio::Device::RtCode DeviceImpl::RenderingNativeCallback(DeviceImpl* aContext)
 {
     REFERENCE_TIME        latency;
@@ -74,7 +80,11 @@ Netero::Audio::Device::RtCode DeviceImpl::RenderingNativeCallback(DeviceImpl* aC
                 goto exit_on_error;
             }
             std::memset(buffer, 0, availableFrames * bytePerFrames);
-            aContext->_processingCallback(reinterpret_cast<float*>(buffer), availableFrames);
+            {
+                NETERO_PROFILE_SCOPE("Audio::ProcessingCallback");
+                Netero::Metrics::ScopedTimer timer(g_processing_duration);
+                aContext->_processingCallback(reinterpret_cast<float*>(buffer), availableFrames);
+            }
             result = audioRenderClient->ReleaseBuffer(availableFrames, 0);
             if (FAILED(result)) {
                 goto exit_on_error;
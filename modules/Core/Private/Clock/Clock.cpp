@@ -0,0 +1,131 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <chrono>
+#include <mutex>
+
+#include <Netero/Clock.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if NETERO_HAS_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace Netero::Detail {
+
+ClockCalibration g_clock_calibration {};
+
+static std::once_flag g_clock_calibration_flag;
+
+std::int64_t ReadMonotonicNanoseconds() noexcept
+{
+#if defined(_WIN32)
+    static const LONGLONG frequency = []() {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<std::int64_t>((counter.QuadPart / frequency) * 1000000000 +
+                                     (counter.QuadPart % frequency) * 1000000000 / frequency);
+#elif defined(CLOCK_MONOTONIC_RAW)
+    // Served by the vDSO, no system call is performed.
+    timespec time {};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+    return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+static bool HasInvariantTsc()
+{
+#if NETERO_HAS_TSC
+    unsigned int registers[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if (static_cast<unsigned int>(info[0]) < 0x80000007) {
+        return false;
+    }
+    __cpuid(info, 0x80000007);
+    registers[3] = static_cast<unsigned int>(info[3]);
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+    // EDX bit 8: the TSC run at a constant rate in every ACPI P, C and T states.
+    return (registers[3] & (1U << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Take a (cycles, nanoseconds) pair, the OS clock read is bracketed by two cycle reads
+ * and the tightest of a few attempts is kept to reduce the effect of preemption.
+ */
+static void SamplePair(std::uint64_t& cycles, std::int64_t& nanoseconds)
+{
+    std::uint64_t bestWindow = ~0ULL;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        const std::uint64_t before = Clock::ReadCyclesOrdered();
+        const std::int64_t  time = ReadMonotonicNanoseconds();
+        const std::uint64_t after = Clock::ReadCyclesOrdered();
+        if (after - before < bestWindow) {
+            bestWindow = after - before;
+            cycles = before + (after - before) / 2;
+            nanoseconds = time;
+        }
+    }
+}
+
+static void Calibrate()
+{
+    ClockCalibration& calibration = g_clock_calibration;
+    calibration.frequency = 0;
+    if (!HasInvariantTsc()) {
+        calibration.source.store(ClockSource::MONOTONIC, std::memory_order_release);
+        return;
+    }
+    constexpr std::int64_t calibrationWindow = 10000000; // 10ms
+    std::uint64_t          startCycles = 0;
+    std::int64_t           startTime = 0;
+    std::uint64_t          endCycles = 0;
+    std::int64_t           endTime = 0;
+    SamplePair(startCycles, startTime);
+    do {
+        SamplePair(endCycles, endTime);
+    } while (endTime - startTime < calibrationWindow);
+    if (endCycles <= startCycles) {
+        calibration.source.store(ClockSource::MONOTONIC, std::memory_order_release);
+        return;
+    }
+    const long double nanosecondsPerCycle = static_cast<long double>(endTime - startTime) /
+        static_cast<long double>(endCycles - startCycles);
+    calibration.multiplier = static_cast<std::uint64_t>(nanosecondsPerCycle * 4294967296.0L);
+    calibration.frequency = static_cast<double>(1e9L / nanosecondsPerCycle);
+    calibration.baseCycles = endCycles;
+    calibration.baseNanoseconds = endTime;
+    calibration.source.store(ClockSource::TSC, std::memory_order_release);
+}
+
+ClockSource CalibrateClock()
+{
+    std::call_once(g_clock_calibration_flag, Calibrate);
+    return g_clock_calibration.source.load(std::memory_order_acquire);
+}
+
+} // namespace Netero::Detail
@@ -0,0 +1,345 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+#include <Netero/Epoch.hpp>
+
+namespace Netero {
+
+struct EpochDomain::ThreadRecord {
+    std::atomic<std::uint64_t> state = 0; /**< (epoch << 1) | 1 while pinned. */
+    std::atomic<bool>          used = false;
+    ThreadRecord*              next = nullptr;
+    std::uint32_t              nesting = 0;
+    std::size_t                collectAt = 0;
+    std::vector<Retired>       garbage;
+};
+
+namespace {
+
+    /**
+     * @brief Live domains, a thread exiting after the destruction of a domain must not
+     * touch it. Leaked on purpose, threads may exit after the static destructors.
+     */
+    struct DomainRegistry {
+        std::mutex                        mutex;
+        std::unordered_set<std::uint64_t> live;
+        std::uint64_t                     nextId = 1;
+    };
+
+    DomainRegistry& GetRegistry()
+    {
+        static auto* registry = new DomainRegistry();
+        return *registry;
+    }
+
+    struct LocalRecord {
+        std::uint64_t              id;
+        EpochDomain*               domain;
+        EpochDomain::ThreadRecord* record;
+    };
+
+    /**
+     * @brief Records of the current thread, unregistered when the thread exit.
+     */
+    struct LocalRecords {
+        ~LocalRecords()
+        {
+            auto&                        registry = GetRegistry();
+            std::scoped_lock<std::mutex> lock(registry.mutex);
+            while (!entries.empty()) {
+                const LocalRecord entry = entries.back();
+                if (registry.live.count(entry.id) != 0) {
+                    entry.domain->UnregisterThread();
+                }
+                else {
+                    entries.pop_back();
+                }
+            }
+        }
+
+        std::vector<LocalRecord> entries;
+    };
+
+    thread_local LocalRecords t_records;
+
+    LocalRecord* FindLocalRecord(std::uint64_t id)
+    {
+        for (auto& entry : t_records.entries) {
+            if (entry.id == id) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+} // namespace
+
+EpochDomain::Guard::Guard(Guard&& other) noexcept: _domain(other._domain), _record(other._record)
+{
+    other._domain = nullptr;
+    other._record = nullptr;
+}
+
+EpochDomain::Guard& EpochDomain::Guard::operator=(Guard&& other) noexcept
+{
+    if (this != &other) {
+        Release();
+        std::swap(_domain, other._domain);
+        std::swap(_record, other._record);
+    }
+    return *this;
+}
+
+EpochDomain::Guard::~Guard()
+{
+    Release();
+}
+
+void EpochDomain::Guard::Release() noexcept
+{
+    if (_domain) {
+        _domain->Unpin(_record);
+        _domain = nullptr;
+        _record = nullptr;
+    }
+}
+
+static std::uint64_t RegisterDomain()
+{
+    auto&                        registry = GetRegistry();
+    std::scoped_lock<std::mutex> lock(registry.mutex);
+    const std::uint64_t          id = registry.nextId++;
+    registry.live.insert(id);
+    return id;
+}
+
+EpochDomain::EpochDomain(): EpochDomain(Options())
+{
+}
+
+EpochDomain::EpochDomain(const Options& options): _options(options), _id(RegisterDomain())
+{
+}
+
+EpochDomain::~EpochDomain()
+{
+    {
+        auto&                        registry = GetRegistry();
+        std::scoped_lock<std::mutex> lock(registry.mutex);
+        registry.live.erase(_id);
+    }
+    ThreadRecord* record = _records.load(std::memory_order_acquire);
+    while (record) {
+        for (auto& retired : record->garbage) {
+            retired.deleter(retired.ptr);
+        }
+        ThreadRecord* next = record->next;
+        delete record;
+        record = next;
+    }
+    for (auto& retired : _orphans) {
+        retired.deleter(retired.ptr);
+    }
+}
+
+EpochDomain& EpochDomain::GetDefault()
+{
+    // Leaked on purpose, threads may still retire nodes during the static destructors.
+    static auto* domain = new EpochDomain();
+    return *domain;
+}
+
+void EpochDomain::RegisterThread()
+{
+    (void)GetRecord();
+}
+
+void EpochDomain::UnregisterThread()
+{
+    LocalRecord* entry = FindLocalRecord(_id);
+    if (!entry) {
+        return;
+    }
+    ThreadRecord* record = entry->record;
+    *entry = t_records.entries.back();
+    t_records.entries.pop_back();
+
+    TryAdvance();
+    Reclaim(record->garbage);
+    if (!record->garbage.empty()) {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _orphans.insert(_orphans.end(), record->garbage.begin(), record->garbage.end());
+    }
+    record->garbage.clear();
+    record->garbage.shrink_to_fit();
+    record->collectAt = 0;
+    record->state.store(0, std::memory_order_release);
+    record->used.store(false, std::memory_order_release);
+}
+
+EpochDomain::Guard EpochDomain::Pin()
+{
+    ThreadRecord* record = GetRecord();
+    if (record->nesting++ == 0) {
+        // Publish the pin then check the epoch did not move meanwhile, an advance
+        // concurrent with the pin would otherwise miss it.
+        std::uint64_t epoch = _epoch.load();
+        while (true) {
+            record->state.store((epoch << 1) | 1);
+            const std::uint64_t current = _epoch.load();
+            if (current == epoch) {
+                break;
+            }
+            epoch = current;
+        }
+    }
+    return Guard(this, record);
+}
+
+void EpochDomain::Unpin(ThreadRecord* record) noexcept
+{
+    if (--record->nesting == 0) {
+        record->state.store(0, std::memory_order_release);
+    }
+}
+
+void EpochDomain::Retire(void* ptr, Deleter deleter)
+{
+    ThreadRecord* record = GetRecord();
+    record->garbage.push_back(Retired { ptr, deleter, _epoch.load() });
+    _garbageCount.fetch_add(1, std::memory_order_relaxed);
+    if (record->garbage.size() < std::max(record->collectAt, _options.collectThreshold)) {
+        return;
+    }
+    TryAdvance();
+    Reclaim(record->garbage);
+    if (record->garbage.size() >= _options.maxGarbage) {
+        if (record->nesting > 0) {
+            // A pinned thread cannot wait for the epoch, hand the garbage to the domain.
+            std::scoped_lock<std::mutex> lock(_mutex);
+            _orphans.insert(_orphans.end(), record->garbage.begin(), record->garbage.end());
+            record->garbage.clear();
+        }
+        else {
+            while (record->garbage.size() >= _options.maxGarbage) {
+                std::this_thread::yield();
+                TryAdvance();
+                Reclaim(record->garbage);
+            }
+        }
+    }
+    record->collectAt = record->garbage.size() + _options.collectThreshold;
+}
+
+std::size_t EpochDomain::Collect()
+{
+    ThreadRecord* record = GetRecord();
+    TryAdvance();
+    std::size_t count = Reclaim(record->garbage);
+    count += ReclaimOrphans();
+    record->collectAt = record->garbage.size() + _options.collectThreshold;
+    return count;
+}
+
+void EpochDomain::Synchronize()
+{
+    ThreadRecord* record = GetRecord();
+    while (true) {
+        TryAdvance();
+        Reclaim(record->garbage);
+        ReclaimOrphans();
+        bool done = record->garbage.empty();
+        if (done) {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            done = _orphans.empty();
+        }
+        if (done) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    record->collectAt = 0;
+}
+
+EpochDomain::ThreadRecord* EpochDomain::GetRecord()
+{
+    if (LocalRecord* entry = FindLocalRecord(_id)) {
+        return entry->record;
+    }
+    ThreadRecord* record = _records.load(std::memory_order_acquire);
+    for (; record; record = record->next) {
+        bool expected = false;
+        if (!record->used.load(std::memory_order_relaxed) &&
+            record->used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            break;
+        }
+    }
+    if (!record) {
+        record = new ThreadRecord();
+        record->used.store(true, std::memory_order_relaxed);
+        record->next = _records.load(std::memory_order_relaxed);
+        while (!_records.compare_exchange_weak(
+            record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    t_records.entries.push_back(LocalRecord { _id, this, record });
+    return record;
+}
+
+bool EpochDomain::TryAdvance()
+{
+    std::uint64_t epoch = _epoch.load();
+    for (ThreadRecord* record = _records.load(std::memory_order_acquire); record;
+         record = record->next) {
+        const std::uint64_t state = record->state.load();
+        if ((state & 1) != 0 && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+    // Failing means another thread advanced it already.
+    _epoch.compare_exchange_strong(epoch, epoch + 1);
+    return true;
+}
+
+std::size_t EpochDomain::Reclaim(std::vector<Retired>& garbage)
+{
+    // A node retired at epoch e may still be observed by threads pinned at e, all of
+    // them unpinned once the epoch reached e + 2.
+    const std::uint64_t epoch = _epoch.load();
+    const auto          end = std::find_if(garbage.begin(), garbage.end(),
+        [epoch](const Retired& retired) { return retired.epoch + 2 > epoch; });
+    // Deleters may retire nodes themselves, run them on a detached batch.
+    std::vector<Retired> ready(garbage.begin(), end);
+    garbage.erase(garbage.begin(), end);
+    for (auto& retired : ready) {
+        retired.deleter(retired.ptr);
+    }
+    _garbageCount.fetch_sub(ready.size(), std::memory_order_relaxed);
+    return ready.size();
+}
+
+std::size_t EpochDomain::ReclaimOrphans()
+{
+    const std::uint64_t  epoch = _epoch.load();
+    std::vector<Retired> ready;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        const auto                   end = std::partition(_orphans.begin(), _orphans.end(),
+            [epoch](const Retired& retired) { return retired.epoch + 2 > epoch; });
+        ready.assign(end, _orphans.end());
+        _orphans.erase(end, _orphans.end());
+    }
+    for (auto& retired : ready) {
+        retired.deleter(retired.ptr);
+    }
+    _garbageCount.fetch_sub(ready.size(), std::memory_order_relaxed);
+    return ready.size();
+}
+
+} // namespace Netero
@@ -0,0 +1,93 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Netero/IoService.hpp>
+
+namespace Netero {
+
+/**
+ * @brief Interface of the IoService backends.
+ * The base class keep track of the in flight requests, a backend call Begin before
+ * queuing requests and End once a request callback has returned.
+ */
+class IoBackend {
+    public:
+    explicit IoBackend(unsigned queueDepth): _queueDepth(queueDepth) {}
+    virtual ~IoBackend() = default;
+
+    [[nodiscard]] virtual IoService::Backend GetType() const = 0;
+    virtual void Submit(IoService::Request* requests, std::size_t count) = 0;
+    virtual bool RegisterBuffers(const std::vector<IoService::Buffer>& buffers) = 0;
+    virtual void UnregisterBuffers() = 0;
+
+    [[nodiscard]] unsigned GetQueueDepth() const noexcept { return _queueDepth; }
+
+    [[nodiscard]] std::size_t GetPendingCount() const
+    {
+        std::scoped_lock<std::mutex> lock(_pendingMutex);
+        return _pending;
+    }
+
+    void WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(_pendingMutex);
+        _pendingCondition.wait(lock, [this]() { return _pending == 0; });
+    }
+
+    protected:
+    /**
+     * @brief Reserve room for count requests, block while the queue is full.
+     * count must not exceed the queue depth, IoService::Submit split larger batches.
+     * Backend threads never block, a completion callback can chain a new request.
+     */
+    void Begin(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock(_pendingMutex);
+        if (!_isBackendThread) {
+            _pendingCondition.wait(
+                lock, [this, count]() { return _pending + count <= _queueDepth; });
+        }
+        _pending += count;
+    }
+
+    void End(std::size_t count = 1)
+    {
+        {
+            std::scoped_lock<std::mutex> lock(_pendingMutex);
+            _pending -= count;
+        }
+        _pendingCondition.notify_all();
+    }
+
+    const unsigned _queueDepth;
+
+    static inline thread_local bool _isBackendThread = false; /**< Set by backend threads. */
+
+    private:
+    mutable std::mutex      _pendingMutex;
+    std::condition_variable _pendingCondition;
+    std::size_t             _pending = 0;
+};
+
+/**
+ * @brief Create the io_uring backend.
+ * @return nullptr if io_uring is not available.
+ */
+std::unique_ptr<IoBackend> CreateUringIoBackend(unsigned queueDepth);
+
+/**
+ * @brief Create the portable backend performing blocking calls in I/O threads.
+ */
+std::unique_ptr<IoBackend> CreateThreadPoolIoBackend(unsigned queueDepth, unsigned threads);
+
+} // namespace Netero
@@ -0,0 +1,157 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "IoBackend.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Netero {
+
+IoService::IoService(): IoService(Backend::AUTO)
+{
+}
+
+IoService::IoService(Backend backend, unsigned queueDepth, unsigned threads)
+{
+    queueDepth = queueDepth == 0 ? 1 : queueDepth;
+#if defined(__linux__)
+    if (backend != Backend::THREAD_POOL) {
+        _backend = CreateUringIoBackend(queueDepth);
+    }
+#endif
+    if (!_backend) {
+        _backend = CreateThreadPoolIoBackend(queueDepth, threads);
+    }
+}
+
+IoService::~IoService()
+{
+    _backend->WaitIdle();
+}
+
+IoService::Backend IoService::GetBackend() const
+{
+    return _backend->GetType();
+}
+
+bool IoService::RegisterBuffers(const std::vector<Buffer>& buffers)
+{
+    return _backend->RegisterBuffers(buffers);
+}
+
+void IoService::UnregisterBuffers()
+{
+    _backend->UnregisterBuffers();
+}
+
+void IoService::Submit(Request request)
+{
+    _backend->Submit(&request, 1);
+}
+
+void IoService::Submit(std::vector<Request>& requests)
+{
+    const std::size_t slice = _backend->GetQueueDepth();
+    for (std::size_t first = 0; first < requests.size(); first += slice) {
+        _backend->Submit(requests.data() + first, std::min(slice, requests.size() - first));
+    }
+}
+
+void IoService::Read(FileHandle         file,
+                     void*              buffer,
+                     std::size_t        size,
+                     std::uint64_t      offset,
+                     CompletionCallback callback)
+{
+    Submit(Request { Operation::READ, file, buffer, size, offset, std::move(callback) });
+}
+
+void IoService::Write(FileHandle         file,
+                      const void*        buffer,
+                      std::size_t        size,
+                      std::uint64_t      offset,
+                      CompletionCallback callback)
+{
+    Submit(Request {
+        Operation::WRITE, file, const_cast<void*>(buffer), size, offset, std::move(callback) });
+}
+
+std::future<std::int64_t>
+IoService::Read(FileHandle file, void* buffer, std::size_t size, std::uint64_t offset)
+{
+    auto promise = std::make_shared<std::promise<std::int64_t>>();
+    auto future = promise->get_future();
+    Read(file, buffer, size, offset, [promise](std::int64_t result) {
+        promise->set_value(result);
+    });
+    return future;
+}
+
+std::future<std::int64_t>
+IoService::Write(FileHandle file, const void* buffer, std::size_t size, std::uint64_t offset)
+{
+    auto promise = std::make_shared<std::promise<std::int64_t>>();
+    auto future = promise->get_future();
+    Write(file, buffer, size, offset, [promise](std::int64_t result) {
+        promise->set_value(result);
+    });
+    return future;
+}
+
+std::size_t IoService::GetPendingCount() const
+{
+    return _backend->GetPendingCount();
+}
+
+void IoService::WaitIdle()
+{
+    _backend->WaitIdle();
+}
+
+IoService::FileHandle IoService::OpenFile(const std::string& path, bool write)
+{
+#if defined(_WIN32)
+    return CreateFileA(path.c_str(),
+                       write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                       FILE_SHARE_READ,
+                       nullptr,
+                       write ? OPEN_ALWAYS : OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL,
+                       nullptr);
+#else
+    const int flags = write ? O_RDWR | O_CREAT : O_RDONLY;
+    return open(path.c_str(), flags | O_CLOEXEC, 0644);
+#endif
+}
+
+void IoService::CloseFile(FileHandle file)
+{
+    if (IsValid(file)) {
+#if defined(_WIN32)
+        CloseHandle(file);
+#else
+        close(file);
+#endif
+    }
+}
+
+bool IoService::IsValid(FileHandle file)
+{
+#if defined(_WIN32)
+    return file != INVALID_HANDLE_VALUE && file != nullptr;
+#else
+    return file >= 0;
+#endif
+}
+
+} // namespace Netero
@@ -0,0 +1,148 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "IoBackend.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace Netero {
+
+/**
+ * @brief Portable backend, each I/O thread perform blocking positional reads and writes.
+ */
+class ThreadPoolIoBackend final: public IoBackend {
+    public:
+    ThreadPoolIoBackend(unsigned queueDepth, unsigned threads): IoBackend(queueDepth)
+    {
+        threads = threads == 0 ? 1 : threads;
+        for (unsigned idx = 0; idx < threads; ++idx) {
+            _threads.emplace_back(&ThreadPoolIoBackend::Run, this);
+        }
+    }
+
+    ~ThreadPoolIoBackend() final
+    {
+        {
+            std::scoped_lock<std::mutex> lock(_queueMutex);
+            _stop = true;
+        }
+        _queueCondition.notify_all();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    [[nodiscard]] IoService::Backend GetType() const final
+    {
+        return IoService::Backend::THREAD_POOL;
+    }
+
+    void Submit(IoService::Request* requests, std::size_t count) final
+    {
+        Begin(count);
+        {
+            std::scoped_lock<std::mutex> lock(_queueMutex);
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                _queue.push_back(std::move(requests[idx]));
+            }
+        }
+        if (count == 1) {
+            _queueCondition.notify_one();
+        }
+        else {
+            _queueCondition.notify_all();
+        }
+    }
+
+    bool RegisterBuffers(const std::vector<IoService::Buffer>&) final { return true; }
+
+    void UnregisterBuffers() final {}
+
+    private:
+    static std::int64_t Perform(const IoService::Request& request)
+    {
+#if defined(_WIN32)
+        OVERLAPPED overlapped {};
+        overlapped.Offset = static_cast<DWORD>(request.offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(request.offset >> 32);
+        DWORD      transferred = 0;
+        const BOOL success = request.operation == IoService::Operation::READ
+            ? ReadFile(request.file,
+                       request.buffer,
+                       static_cast<DWORD>(request.size),
+                       &transferred,
+                       &overlapped)
+            : WriteFile(request.file,
+                        request.buffer,
+                        static_cast<DWORD>(request.size),
+                        &transferred,
+                        &overlapped);
+        if (!success && GetLastError() != ERROR_HANDLE_EOF) {
+            return -static_cast<std::int64_t>(GetLastError());
+        }
+        return transferred;
+#else
+        ssize_t result;
+        do {
+            result = request.operation == IoService::Operation::READ
+                ? pread(request.file,
+                        request.buffer,
+                        request.size,
+                        static_cast<off_t>(request.offset))
+                : pwrite(request.file,
+                         request.buffer,
+                         request.size,
+                         static_cast<off_t>(request.offset));
+        } while (result < 0 && errno == EINTR);
+        return result < 0 ? -static_cast<std::int64_t>(errno) : result;
+#endif
+    }
+
+    void Run()
+    {
+        _isBackendThread = true;
+        while (true) {
+            IoService::Request request;
+            {
+                std::unique_lock<std::mutex> lock(_queueMutex);
+                _queueCondition.wait(lock, [this]() { return _stop || !_queue.empty(); });
+                if (_queue.empty()) {
+                    return;
+                }
+                request = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            const std::int64_t result = Perform(request);
+            if (request.callback) {
+                request.callback(result);
+            }
+            End();
+        }
+    }
+
+    std::mutex                     _queueMutex;
+    std::condition_variable        _queueCondition;
+    std::deque<IoService::Request> _queue;
+    std::vector<std::thread>       _threads;
+    bool                           _stop = false;
+};
+
+std::unique_ptr<IoBackend> CreateThreadPoolIoBackend(unsigned queueDepth, unsigned threads)
+{
+    return std::make_unique<ThreadPoolIoBackend>(queueDepth, threads);
+}
+
+} // namespace Netero
@@ -0,0 +1,302 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "IoBackend.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace Netero {
+
+/**
+ * io_uring is driven through raw system calls so the library does not depend on liburing.
+ * Submissions are serialized by a mutex, completions are reaped by a dedicated thread
+ * blocked in io_uring_enter.
+ */
+class UringIoBackend final: public IoBackend {
+    struct UringRequest {
+        IoService::Request request;
+        iovec              vector;
+    };
+
+    using FailedRequests = std::vector<std::pair<UringRequest*, int>>;
+
+    public:
+    explicit UringIoBackend(unsigned queueDepth): IoBackend(queueDepth) {}
+
+    ~UringIoBackend() final
+    {
+        if (_completionThread.joinable()) {
+            WaitIdle();
+            {
+                std::scoped_lock<std::mutex> lock(_submitMutex);
+                io_uring_sqe*                sqe = NextSqe();
+                std::memset(sqe, 0, sizeof(io_uring_sqe));
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = 0; // Stop the completion thread.
+                PushSqe();
+                FailedRequests failed;
+                Commit(1, failed);
+            }
+            _completionThread.join();
+        }
+        if (_sqes) {
+            munmap(_sqes, _sqesSize);
+        }
+        if (_cqRing && _cqRing != _sqRing) {
+            munmap(_cqRing, _cqRingSize);
+        }
+        if (_sqRing) {
+            munmap(_sqRing, _sqRingSize);
+        }
+        if (_ringFd >= 0) {
+            close(_ringFd);
+        }
+    }
+
+    bool Initialize()
+    {
+        io_uring_params params {};
+        _ringFd = static_cast<int>(syscall(__NR_io_uring_setup, _queueDepth, &params));
+        if (_ringFd < 0) {
+            return false;
+        }
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+        }
+        _sqRing = Map(_sqRingSize, IORING_OFF_SQ_RING);
+        if (!_sqRing) {
+            return false;
+        }
+        _cqRing = singleMap ? _sqRing : Map(_cqRingSize, IORING_OFF_CQ_RING);
+        if (!_cqRing) {
+            return false;
+        }
+        _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        _sqes = static_cast<io_uring_sqe*>(Map(_sqesSize, IORING_OFF_SQES));
+        if (!_sqes) {
+            return false;
+        }
+        auto* sq = static_cast<char*>(_sqRing);
+        auto* cq = static_cast<char*>(_cqRing);
+        _sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        _sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        _sqEntries = params.sq_entries;
+        _cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        _completionThread = std::thread(&UringIoBackend::Reap, this);
+        return true;
+    }
+
+    [[nodiscard]] IoService::Backend GetType() const final { return IoService::Backend::IO_URING; }
+
+    void Submit(IoService::Request* requests, std::size_t count) final
+    {
+        Begin(count);
+        FailedRequests               failed;
+        std::unique_lock<std::mutex> lock(_submitMutex);
+        unsigned                     queued = 0;
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            if (*_sqTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) == _sqEntries) {
+                Commit(queued, failed);
+                queued = 0;
+            }
+            auto* uringRequest = new UringRequest { std::move(requests[idx]), {} };
+            const IoService::Request& request = uringRequest->request;
+            io_uring_sqe*             sqe = NextSqe();
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            const bool read = request.operation == IoService::Operation::READ;
+            sqe->fd = request.file;
+            sqe->off = request.offset;
+            sqe->user_data = reinterpret_cast<std::uint64_t>(uringRequest);
+            if (request.registeredBuffer >= 0) {
+                sqe->opcode = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe->addr = reinterpret_cast<std::uint64_t>(request.buffer);
+                sqe->len = static_cast<std::uint32_t>(request.size);
+                sqe->buf_index = static_cast<std::uint16_t>(request.registeredBuffer);
+            }
+            else {
+                uringRequest->vector.iov_base = request.buffer;
+                uringRequest->vector.iov_len = request.size;
+                sqe->opcode = read ? IORING_OP_READV : IORING_OP_WRITEV;
+                sqe->addr = reinterpret_cast<std::uint64_t>(&uringRequest->vector);
+                sqe->len = 1;
+            }
+            PushSqe();
+            queued += 1;
+        }
+        Commit(queued, failed);
+        lock.unlock();
+        // Callbacks run without the lock, they may submit new requests.
+        for (auto& [uringRequest, error] : failed) {
+            Complete(uringRequest, -error);
+        }
+    }
+
+    bool RegisterBuffers(const std::vector<IoService::Buffer>& buffers) final
+    {
+        UnregisterBuffers();
+        std::vector<iovec> vectors;
+        vectors.reserve(buffers.size());
+        for (const auto& buffer : buffers) {
+            vectors.push_back({ buffer.data, buffer.size });
+        }
+        const long result = syscall(__NR_io_uring_register,
+                                    _ringFd,
+                                    IORING_REGISTER_BUFFERS,
+                                    vectors.data(),
+                                    static_cast<unsigned>(vectors.size()));
+        _hasRegisteredBuffers = result == 0;
+        return _hasRegisteredBuffers;
+    }
+
+    void UnregisterBuffers() final
+    {
+        if (_hasRegisteredBuffers) {
+            syscall(__NR_io_uring_register, _ringFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            _hasRegisteredBuffers = false;
+        }
+    }
+
+    private:
+    void* Map(std::size_t size, off_t offset) const
+    {
+        void* ptr =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    /**
+     * @brief Return the next free sqe, the submission lock must be held.
+     */
+    io_uring_sqe* NextSqe()
+    {
+        const unsigned index = *_sqTail & _sqMask;
+        _sqArray[index] = index;
+        return &_sqes[index];
+    }
+
+    /**
+     * @brief Publish the sqe returned by NextSqe once filled.
+     */
+    void PushSqe() { __atomic_store_n(_sqTail, *_sqTail + 1, __ATOMIC_RELEASE); }
+
+    /**
+     * @brief Hand the queued sqes to the kernel.
+     * If io_uring_enter fail, the sqes the kernel did not consume are taken back from the
+     * ring and appended to failed with the error, to be completed once the lock released.
+     */
+    void Commit(unsigned count, FailedRequests& failed)
+    {
+        while (count > 0) {
+            const long result = syscall(__NR_io_uring_enter, _ringFd, count, 0, 0, nullptr, 0);
+            if (result < 0) {
+                const int error = errno;
+                if (error == EINTR || error == EAGAIN || error == EBUSY) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+                for (unsigned position = head; position != *_sqTail; ++position) {
+                    const io_uring_sqe& sqe = _sqes[_sqArray[position & _sqMask]];
+                    auto* uringRequest = reinterpret_cast<UringRequest*>(sqe.user_data);
+                    if (uringRequest) {
+                        failed.emplace_back(uringRequest, error);
+                    }
+                }
+                __atomic_store_n(_sqTail, head, __ATOMIC_RELEASE);
+                return;
+            }
+            count -= static_cast<unsigned>(result);
+        }
+    }
+
+    /**
+     * @brief Run the callback of a request and release it.
+     */
+    void Complete(UringRequest* uringRequest, std::int64_t result)
+    {
+        if (uringRequest->request.callback) {
+            uringRequest->request.callback(result);
+        }
+        delete uringRequest;
+        End();
+    }
+
+    void Reap()
+    {
+        _isBackendThread = true;
+        bool stop = false;
+        while (!stop) {
+            unsigned       head = *_cqHead;
+            const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                syscall(__NR_io_uring_enter, _ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                continue;
+            }
+            while (head != tail) {
+                const io_uring_cqe& cqe = _cqes[head & _cqMask];
+                auto*               uringRequest = reinterpret_cast<UringRequest*>(cqe.user_data);
+                const std::int64_t  result = cqe.res;
+                head += 1;
+                __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+                if (!uringRequest) {
+                    stop = true;
+                    continue;
+                }
+                Complete(uringRequest, result);
+            }
+        }
+    }
+
+    int           _ringFd = -1;
+    void*         _sqRing = nullptr;
+    void*         _cqRing = nullptr;
+    io_uring_sqe* _sqes = nullptr;
+    std::size_t   _sqRingSize = 0;
+    std::size_t   _cqRingSize = 0;
+    std::size_t   _sqesSize = 0;
+    unsigned*     _sqHead = nullptr;
+    unsigned*     _sqTail = nullptr;
+    unsigned*     _sqArray = nullptr;
+    unsigned      _sqMask = 0;
+    unsigned      _sqEntries = 0;
+    unsigned*     _cqHead = nullptr;
+    unsigned*     _cqTail = nullptr;
+    unsigned      _cqMask = 0;
+    io_uring_cqe* _cqes = nullptr;
+    bool          _hasRegisteredBuffers = false;
+    std::mutex    _submitMutex;
+    std::thread   _completionThread;
+};
+
+std::unique_ptr<IoBackend> CreateUringIoBackend(unsigned queueDepth)
+{
+    auto backend = std::make_unique<UringIoBackend>(queueDepth);
+    if (!backend->Initialize()) {
+        return nullptr;
+    }
+    return backend;
+}
+
+} // namespace Netero
@@ -0,0 +1,285 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <Netero/JobSystem.hpp>
+#include <Netero/Os.hpp>
+#include <Netero/WorkStealingDeque.hpp>
+
+namespace Netero {
+
+struct JobSystem::Job {
+    JobFunction function;
+    JobCounter* counter;
+};
+
+struct JobSystem::Worker {
+    explicit Worker(std::size_t capacity): deque(capacity) {}
+
+    WorkStealingDeque<Job*> deque;
+    std::thread             thread;
+};
+
+static thread_local const JobSystem* g_worker_system = nullptr;
+static thread_local unsigned         g_worker_index = 0;
+static thread_local std::uint32_t    g_steal_seed = 0;
+
+static constexpr unsigned g_spin_before_sleep = 64;
+
+/**
+ * @brief Order the cpus so that consecutive workers land on distinct physical cores,
+ * node by node, SMT siblings come last.
+ */
+static std::vector<unsigned> GetPinningOrder()
+{
+    auto topology = Os::GetCpuTopology();
+    std::stable_sort(topology.begin(),
+                     topology.end(),
+                     [](const Os::CpuTopology& a, const Os::CpuTopology& b) {
+                         if (a.node != b.node) {
+                             return a.node < b.node;
+                         }
+                         if (a.package != b.package) {
+                             return a.package < b.package;
+                         }
+                         return a.core < b.core;
+                     });
+    std::vector<unsigned> order;
+    std::vector<unsigned> siblings;
+    for (std::size_t idx = 0; idx < topology.size(); ++idx) {
+        const auto& cpu = topology[idx];
+        const bool  sibling = idx > 0 && topology[idx - 1].node == cpu.node &&
+            topology[idx - 1].package == cpu.package && topology[idx - 1].core == cpu.core;
+        (sibling ? siblings : order).push_back(cpu.cpu);
+    }
+    order.insert(order.end(), siblings.begin(), siblings.end());
+    return order;
+}
+
+JobSystem::JobSystem(): JobSystem(Options())
+{
+}
+
+JobSystem::JobSystem(const Options& options)
+{
+    unsigned count = options.workerCount;
+    if (count == 0) {
+        const unsigned cpus = Os::GetCpuCount();
+        count = cpus > 1 ? cpus - 1 : 1;
+    }
+    _workers.reserve(count);
+    for (unsigned idx = 0; idx < count; ++idx) {
+        _workers.push_back(std::make_unique<Worker>(options.dequeCapacity));
+    }
+    const std::vector<unsigned> cpus =
+        options.pinWorkers ? GetPinningOrder() : std::vector<unsigned>();
+    for (unsigned idx = 0; idx < count; ++idx) {
+        auto& worker = *_workers[idx];
+        worker.thread = std::thread(&JobSystem::WorkerMain, this, idx);
+        if (!cpus.empty()) {
+            // The first cpu is left to the thread creating the scheduler, usually the main one.
+            Os::CpuMask mask;
+            mask.set(cpus[(idx + 1) % cpus.size()]);
+            Os::SetThreadAffinity(worker.thread, mask);
+        }
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::scoped_lock<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+    for (auto& worker : _workers) {
+        worker->thread.join();
+    }
+}
+
+JobSystem& JobSystem::GetDefault()
+{
+    static JobSystem system;
+    return system;
+}
+
+void JobSystem::Run(JobFunction job, JobCounter* counter)
+{
+    if (counter) {
+        counter->_value.fetch_add(2, std::memory_order_relaxed);
+    }
+    Schedule(new Job { std::move(job), counter });
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, JobFunction job, JobCounter* counter)
+{
+    if (counter) {
+        counter->_value.fetch_add(2, std::memory_order_relaxed);
+    }
+    auto* task = new Job { std::move(job), counter };
+    {
+        std::scoped_lock<std::mutex> lock(dependency._mutex);
+        if (dependency._value.load(std::memory_order_acquire) >= 2) {
+            dependency._continuations.push_back(task);
+            return;
+        }
+    }
+    Schedule(task);
+}
+
+void JobSystem::WaitFor(JobCounter& counter)
+{
+    while (counter._value.load(std::memory_order_acquire) != 0) {
+        if (RunPendingJob()) {
+            continue;
+        }
+        // Nothing to help with, sleep a little, new jobs may be scheduled meanwhile.
+        std::unique_lock<std::mutex> lock(counter._mutex);
+        counter._condition.wait_for(lock, std::chrono::microseconds(100), [&counter]() {
+            return counter._value.load(std::memory_order_acquire) == 0;
+        });
+    }
+    // The last job may still be releasing the counter.
+    std::scoped_lock<std::mutex> lock(counter._mutex);
+}
+
+bool JobSystem::RunPendingJob()
+{
+    Job* job = nullptr;
+    if (!TakeJob(job)) {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+unsigned JobSystem::GetWorkerCount() const
+{
+    return static_cast<unsigned>(_workers.size());
+}
+
+int JobSystem::GetCurrentWorkerIndex() const
+{
+    return g_worker_system == this ? static_cast<int>(g_worker_index) : -1;
+}
+
+void JobSystem::Schedule(Job* job)
+{
+    const int index = GetCurrentWorkerIndex();
+    if (index >= 0) {
+        _workers[index]->deque.Push(job);
+    }
+    else {
+        std::scoped_lock<std::mutex> lock(_injectionMutex);
+        _injection.push_back(job);
+    }
+    _queuedCount.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleepingCount.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::scoped_lock<std::mutex> lock(_sleepMutex);
+        }
+        _sleepCondition.notify_one();
+    }
+}
+
+bool JobSystem::TakeJob(Job*& job)
+{
+    const int index = GetCurrentWorkerIndex();
+    bool      found = index >= 0 && _workers[index]->deque.Pop(job);
+    if (!found) {
+        std::scoped_lock<std::mutex> lock(_injectionMutex);
+        if (!_injection.empty()) {
+            job = _injection.front();
+            _injection.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        // Start stealing at a random victim to spread the thieves.
+        g_steal_seed = g_steal_seed * 1664525u + 1013904223u;
+        const std::size_t count = _workers.size();
+        const std::size_t first = (g_steal_seed >> 16) % count;
+        for (std::size_t offset = 0; offset < count && !found; ++offset) {
+            const std::size_t victim = (first + offset) % count;
+            found = static_cast<int>(victim) != index && _workers[victim]->deque.Steal(job);
+        }
+    }
+    if (found) {
+        _queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    job->function();
+    JobCounter* counter = job->counter;
+    delete job;
+    if (counter) {
+        Complete(*counter);
+    }
+}
+
+void JobSystem::Complete(JobCounter& counter)
+{
+    // The last job set the low bit instead of reaching zero, so waiters do not
+    // return before the continuations are released.
+    std::int64_t value = counter._value.load(std::memory_order_relaxed);
+    while (!counter._value.compare_exchange_weak(value,
+                                                 value == 2 ? 1 : value - 2,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+    }
+    if (value != 2) {
+        return;
+    }
+    std::vector<Job*> ready;
+    {
+        std::scoped_lock<std::mutex> lock(counter._mutex);
+        ready.swap(counter._continuations);
+        counter._value.fetch_sub(1, std::memory_order_release);
+        counter._condition.notify_all();
+    }
+    for (Job* job : ready) {
+        Schedule(job);
+    }
+}
+
+void JobSystem::WorkerMain(unsigned index)
+{
+    g_worker_system = this;
+    g_worker_index = index;
+    g_steal_seed = index + 1;
+    unsigned idle = 0;
+    while (true) {
+        Job* job = nullptr;
+        if (TakeJob(job)) {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+        if (_stop.load(std::memory_order_acquire) &&
+            _queuedCount.load(std::memory_order_acquire) <= 0) {
+            return;
+        }
+        if (++idle < g_spin_before_sleep) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        _sleepCondition.wait(lock, [this]() {
+            return _stop.load(std::memory_order_acquire) ||
+                _queuedCount.load(std::memory_order_seq_cst) > 0;
+        });
+        _sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+} // namespace Netero
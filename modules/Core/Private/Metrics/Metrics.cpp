@@ -0,0 +1,322 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <Netero/Metrics.hpp>
+
+namespace Netero::Metrics {
+
+namespace Detail {
+
+    static std::atomic<std::size_t> g_next_shard = 0;
+
+    std::size_t GetShardIndex() noexcept
+    {
+        thread_local const std::size_t shard =
+            g_next_shard.fetch_add(1, std::memory_order_relaxed) % shardCount;
+        return shard;
+    }
+
+} // namespace Detail
+
+namespace {
+
+    void WriteEscaped(std::ostream& output, const std::string& text)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        for (const char character : text) {
+            const auto c = static_cast<unsigned char>(character);
+            if (c == '"' || c == '\\') {
+                output << '\\' << character;
+            }
+            else if (c < 0x20) {
+                output << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+            }
+            else {
+                output << character;
+            }
+        }
+    }
+
+    constexpr std::pair<const char*, double> g_percentiles[] = {
+        { "p50", 50. }, { "p90", 90. }, { "p99", 99. }, { "p999", 99.9 }
+    };
+
+} // namespace
+
+double HistogramSnapshot::GetMean() const noexcept
+{
+    return count == 0 ? 0. : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+std::uint64_t HistogramSnapshot::GetPercentile(double percentile) const noexcept
+{
+    if (count == 0) {
+        return 0;
+    }
+    const double        clamped = std::min(std::max(percentile, 0.), 100.);
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(clamped / 100. * static_cast<double>(count))));
+    std::uint64_t seen = 0;
+    for (const auto& [upper, bucketCount] : buckets) {
+        seen += bucketCount;
+        if (seen >= rank) {
+            return upper;
+        }
+    }
+    return max;
+}
+
+Histogram::~Histogram()
+{
+    for (auto& shard : _shards) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+Histogram::Shard* Histogram::AllocateShard(std::size_t index) noexcept
+{
+    auto*  shard = new Shard();
+    Shard* expected = nullptr;
+    if (!_shards[index].compare_exchange_strong(expected, shard, std::memory_order_acq_rel)) {
+        delete shard;
+        return expected;
+    }
+    return shard;
+}
+
+HistogramSnapshot Histogram::GetSnapshot() const
+{
+    std::vector<std::uint64_t> counts(bucketCount, 0);
+    HistogramSnapshot          snapshot;
+    for (const auto& slot : _shards) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (std::size_t idx = 0; idx < bucketCount; ++idx) {
+            counts[idx] += shard->counts[idx].load(std::memory_order_relaxed);
+        }
+        snapshot.sum += shard->sum.load(std::memory_order_relaxed);
+    }
+    for (std::size_t idx = 0; idx < bucketCount; ++idx) {
+        if (counts[idx] == 0) {
+            continue;
+        }
+        if (snapshot.count == 0) {
+            snapshot.min = GetBucketLowerBound(idx);
+        }
+        snapshot.count += counts[idx];
+        snapshot.max = GetBucketUpperBound(idx);
+        snapshot.buckets.emplace_back(snapshot.max, counts[idx]);
+    }
+    return snapshot;
+}
+
+void Histogram::Reset() noexcept
+{
+    for (auto& slot : _shards) {
+        Shard* shard = slot.load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (auto& count : shard->counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shard->sum.store(0, std::memory_order_relaxed);
+    }
+}
+
+RollingHistogram::RollingHistogram(std::size_t capacity)
+    : _capacity(std::max<std::size_t>(1, capacity))
+{
+    _values.reserve(_capacity);
+}
+
+void RollingHistogram::Record(std::uint64_t value)
+{
+    if (_values.size() < _capacity) {
+        _values.push_back(value);
+        return;
+    }
+    _values[_next] = value;
+    _next = (_next + 1) % _capacity;
+}
+
+std::uint64_t RollingHistogram::GetLast() const noexcept
+{
+    if (_values.empty()) {
+        return 0;
+    }
+    return _values[(_next + _values.size() - 1) % _values.size()];
+}
+
+void RollingHistogram::SetCapacity(std::size_t capacity)
+{
+    capacity = std::max<std::size_t>(1, capacity);
+    std::vector<std::uint64_t> values;
+    values.reserve(capacity);
+    const std::size_t kept = std::min(capacity, _values.size());
+    for (std::size_t idx = _values.size() - kept; idx < _values.size(); ++idx) {
+        values.push_back(_values[(_next + idx) % _values.size()]);
+    }
+    _values = std::move(values);
+    _capacity = capacity;
+    _next = 0;
+}
+
+HistogramSnapshot RollingHistogram::GetSnapshot() const
+{
+    std::vector<std::size_t> indexes;
+    indexes.reserve(_values.size());
+    HistogramSnapshot snapshot;
+    for (const auto value : _values) {
+        indexes.push_back(Histogram::GetBucketIndex(value));
+        snapshot.sum += value;
+    }
+    std::sort(indexes.begin(), indexes.end());
+    for (std::size_t idx = 0; idx < indexes.size(); ++idx) {
+        if (snapshot.count == 0) {
+            snapshot.min = Histogram::GetBucketLowerBound(indexes[idx]);
+        }
+        snapshot.count += 1;
+        snapshot.max = Histogram::GetBucketUpperBound(indexes[idx]);
+        if (idx > 0 && indexes[idx] == indexes[idx - 1]) {
+            snapshot.buckets.back().second += 1;
+        }
+        else {
+            snapshot.buckets.emplace_back(snapshot.max, 1);
+        }
+    }
+    return snapshot;
+}
+
+void RollingHistogram::Reset() noexcept
+{
+    _values.clear();
+    _next = 0;
+}
+
+std::string Snapshot::ToText() const
+{
+    std::ostringstream output;
+    for (const auto& [name, value] : counters) {
+        output << "counter " << name << ' ' << value << '\n';
+    }
+    for (const auto& [name, value] : gauges) {
+        output << "gauge " << name << ' ' << value << '\n';
+    }
+    for (const auto& [name, histogram] : histograms) {
+        output << "histogram " << name << " count=" << histogram.count << " mean=" << std::fixed
+               << std::setprecision(1) << histogram.GetMean() << " min=" << histogram.min;
+        for (const auto& [label, percentile] : g_percentiles) {
+            output << ' ' << label << '=' << histogram.GetPercentile(percentile);
+        }
+        output << " max=" << histogram.max << '\n';
+    }
+    return output.str();
+}
+
+std::string Snapshot::ToJson() const
+{
+    std::ostringstream output;
+    output << "{\"counters\":{";
+    const char* separator = "";
+    for (const auto& [name, value] : counters) {
+        output << separator << '"';
+        WriteEscaped(output, name);
+        output << "\":" << value;
+        separator = ",";
+    }
+    output << "},\"gauges\":{";
+    separator = "";
+    for (const auto& [name, value] : gauges) {
+        output << separator << '"';
+        WriteEscaped(output, name);
+        output << "\":" << value;
+        separator = ",";
+    }
+    output << "},\"histograms\":{";
+    separator = "";
+    for (const auto& [name, histogram] : histograms) {
+        output << separator << '"';
+        WriteEscaped(output, name);
+        output << "\":{\"count\":" << histogram.count << ",\"sum\":" << histogram.sum
+               << ",\"mean\":" << std::fixed << std::setprecision(1) << histogram.GetMean()
+               << ",\"min\":" << histogram.min << ",\"max\":" << histogram.max;
+        for (const auto& [label, percentile] : g_percentiles) {
+            output << ",\"" << label << "\":" << histogram.GetPercentile(percentile);
+        }
+        output << ",\"buckets\":[";
+        const char* bucketSeparator = "";
+        for (const auto& [upper, count] : histogram.buckets) {
+            output << bucketSeparator << '[' << upper << ',' << count << ']';
+            bucketSeparator = ",";
+        }
+        output << "]}";
+        separator = ",";
+    }
+    output << "}}";
+    return output.str();
+}
+
+Registry& Registry::GetDefault()
+{
+    // Leaked on purpose, metrics may be updated during the static destructors.
+    static auto* registry = new Registry();
+    return *registry;
+}
+
+Counter& Registry::GetCounter(const std::string& name)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    auto&                        counter = _counters[name];
+    if (!counter) {
+        counter = std::make_unique<Counter>();
+    }
+    return *counter;
+}
+
+Gauge& Registry::GetGauge(const std::string& name)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    auto&                        gauge = _gauges[name];
+    if (!gauge) {
+        gauge = std::make_unique<Gauge>();
+    }
+    return *gauge;
+}
+
+Histogram& Registry::GetHistogram(const std::string& name)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    auto&                        histogram = _histograms[name];
+    if (!histogram) {
+        histogram = std::make_unique<Histogram>();
+    }
+    return *histogram;
+}
+
+Snapshot Registry::TakeSnapshot() const
+{
+    Snapshot                     snapshot;
+    std::scoped_lock<std::mutex> lock(_mutex);
+    for (const auto& [name, counter] : _counters) {
+        snapshot.counters.emplace(name, counter->GetValue());
+    }
+    for (const auto& [name, gauge] : _gauges) {
+        snapshot.gauges.emplace(name, gauge->GetValue());
+    }
+    for (const auto& [name, histogram] : _histograms) {
+        snapshot.histograms.emplace(name, histogram->GetSnapshot());
+    }
+    return snapshot;
+}
+
+} // namespace Netero::Metrics
@@ -0,0 +1,24 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <Netero/Os.hpp>
+
+namespace Netero::Os {
+
+const char* RtCodeToString(RtCode code)
+{
+    switch (code) {
+        case RtCode::SUCCESS: return "Success.";
+        case RtCode::PERMISSION_DENIED:
+            return "Permission denied, the process lacks the required privilege or resource limit.";
+        case RtCode::INVALID_ARGUMENT: return "Invalid argument.";
+        case RtCode::NOT_FOUND: return "No such file or resource.";
+        case RtCode::NOT_SUPPORTED: return "Not supported on this platform.";
+        case RtCode::SYSTEM_ERROR: return "System error.";
+    }
+    return "Unknown error.";
+}
+
+} // namespace Netero::Os
@@ -0,0 +1,29 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+#include <cerrno>
+
+#include <Netero/Os.hpp>
+
+namespace Netero::Os {
+
+inline RtCode ErrnoToRtCode(int error)
+{
+    switch (error) {
+        case 0: return RtCode::SUCCESS;
+        case EPERM:
+        case EACCES: return RtCode::PERMISSION_DENIED;
+        case EINVAL:
+        case ESRCH: return RtCode::INVALID_ARGUMENT;
+        case ENOENT: return RtCode::NOT_FOUND;
+        case ENOSYS:
+        case ENOTSUP: return RtCode::NOT_SUPPORTED;
+        default: return RtCode::SYSTEM_ERROR;
+    }
+}
+
+} // namespace Netero::Os
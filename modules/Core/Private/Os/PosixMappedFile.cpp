@@ -0,0 +1,205 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+#include <Netero/MappedFile.hpp>
+
+#include "PosixErrno.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Netero::Os {
+
+static constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _mappingBase = std::exchange(other._mappingBase, nullptr);
+        _mappingSize = std::exchange(other._mappingSize, 0);
+        _mode = other._mode;
+        _isOpen = std::exchange(other._isOpen, false);
+        _fileDescriptor = std::exchange(other._fileDescriptor, -1);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+/**
+ * Reserve an address range large enough to hold an aligned mapping
+ * and return the aligned start. The excess of the reservation is released.
+ */
+static void* ReserveAligned(std::size_t size, std::size_t alignment)
+{
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    void* reservation =
+        mmap(nullptr, size + alignment, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto start = reinterpret_cast<std::uintptr_t>(reservation);
+    const auto aligned = (start + alignment - 1) & ~(alignment - 1);
+    if (aligned > start) {
+        munmap(reservation, aligned - start);
+    }
+    const std::size_t tail = (start + size + alignment) - (aligned + size);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+RtCode MappedFile::Open(const std::string& path, const Options& options)
+{
+    Close();
+    const bool writable = options.mode == Mode::READ_WRITE;
+    int        flags = writable ? O_RDWR : O_RDONLY;
+    if (writable && options.create) {
+        flags |= O_CREAT;
+    }
+    const int fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return ErrnoToRtCode(errno);
+    }
+    if (writable && options.size > 0 &&
+        ftruncate(fd, static_cast<off_t>(options.size)) != 0) {
+        const int error = errno;
+        close(fd);
+        return ErrnoToRtCode(error);
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0) {
+        const int error = errno;
+        close(fd);
+        return ErrnoToRtCode(error);
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    _fileDescriptor = fd;
+    _mode = options.mode;
+    _isOpen = true;
+    if (size == 0) { // mmap reject empty length, an empty file is a valid empty view.
+        return RtCode::SUCCESS;
+    }
+
+    const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int       mapFlags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (options.populate) {
+        mapFlags |= MAP_POPULATE;
+    }
+#endif
+    void* hint = nullptr;
+    if (options.hugePages) {
+        hint = ReserveAligned(size, HugePageSize);
+        if (hint) {
+            mapFlags |= MAP_FIXED;
+        }
+    }
+    void* mapping = mmap(hint, size, protection, mapFlags, fd, 0);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        if (hint) {
+            munmap(hint, size);
+        }
+        Close();
+        return ErrnoToRtCode(error);
+    }
+    _mappingBase = mapping;
+    _mappingSize = size;
+    _data = static_cast<std::byte*>(mapping);
+    _size = size;
+#if defined(MADV_HUGEPAGE)
+    if (options.hugePages) {
+        // Only a hint, file backed huge pages depend on the file system and kernel config.
+        madvise(mapping, size, MADV_HUGEPAGE);
+    }
+#endif
+#if !defined(MAP_POPULATE)
+    if (options.populate) {
+        Advise(Access::WILL_NEED);
+    }
+#endif
+    return RtCode::SUCCESS;
+}
+
+void MappedFile::Close()
+{
+    if (_mappingBase) {
+        munmap(_mappingBase, _mappingSize);
+    }
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mappingBase = nullptr;
+    _mappingSize = 0;
+    _fileDescriptor = -1;
+    _isOpen = false;
+}
+
+RtCode MappedFile::Advise(Access access, std::size_t offset, std::size_t length)
+{
+    if (!_isOpen || offset > _size) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    if (length == 0 || offset + length > _size) {
+        length = _size - offset;
+    }
+    if (length == 0) {
+        return RtCode::SUCCESS;
+    }
+    // madvise require a page aligned address.
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const auto alignedOffset = offset & ~(pageSize - 1);
+    length += offset - alignedOffset;
+    int advice = MADV_NORMAL;
+    switch (access) {
+        case Access::NORMAL: advice = MADV_NORMAL; break;
+        case Access::SEQUENTIAL: advice = MADV_SEQUENTIAL; break;
+        case Access::RANDOM: advice = MADV_RANDOM; break;
+        case Access::WILL_NEED: advice = MADV_WILLNEED; break;
+        case Access::DONT_NEED: advice = MADV_DONTNEED; break;
+    }
+    if (madvise(_data + alignedOffset, length, advice) != 0) {
+        return ErrnoToRtCode(errno);
+    }
+    return RtCode::SUCCESS;
+}
+
+RtCode MappedFile::Flush(bool async)
+{
+    if (!_isOpen) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    if (!_mappingBase || _mode == Mode::READ_ONLY) {
+        return RtCode::SUCCESS;
+    }
+    if (msync(_mappingBase, _mappingSize, async ? MS_ASYNC : MS_SYNC) != 0) {
+        return ErrnoToRtCode(errno);
+    }
+    return RtCode::SUCCESS;
+}
+
+} // namespace Netero::Os
@@ -0,0 +1,281 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <thread>
+
+#include <Netero/Os.hpp>
+
+#include "PosixErrno.hpp"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Netero::Os {
+
+unsigned GetCpuCount()
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        return static_cast<unsigned>(CPU_COUNT(&set));
+    }
+#endif
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<unsigned>(count) : 1;
+}
+
+static RtCode SetAffinity(pthread_t thread, const CpuMask& mask)
+{
+    if (mask.none()) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+#if defined(__linux__)
+    cpu_set_t* set = CPU_ALLOC(MaxCpuCount);
+    if (!set) {
+        return RtCode::SYSTEM_ERROR;
+    }
+    const size_t size = CPU_ALLOC_SIZE(MaxCpuCount);
+    CPU_ZERO_S(size, set);
+    for (size_t cpu = 0; cpu < MaxCpuCount; ++cpu) {
+        if (mask.test(cpu)) {
+            CPU_SET_S(cpu, size, set);
+        }
+    }
+    const int result = pthread_setaffinity_np(thread, size, set);
+    CPU_FREE(set);
+    return ErrnoToRtCode(result);
+#else
+    (void)thread;
+    return RtCode::NOT_SUPPORTED;
+#endif
+}
+
+static RtCode GetAffinity(pthread_t thread, CpuMask& mask)
+{
+#if defined(__linux__)
+    cpu_set_t* set = CPU_ALLOC(MaxCpuCount);
+    if (!set) {
+        return RtCode::SYSTEM_ERROR;
+    }
+    const size_t size = CPU_ALLOC_SIZE(MaxCpuCount);
+    CPU_ZERO_S(size, set);
+    const int result = pthread_getaffinity_np(thread, size, set);
+    if (result == 0) {
+        mask.reset();
+        for (size_t cpu = 0; cpu < MaxCpuCount; ++cpu) {
+            if (CPU_ISSET_S(cpu, size, set)) {
+                mask.set(cpu);
+            }
+        }
+    }
+    CPU_FREE(set);
+    return ErrnoToRtCode(result);
+#else
+    (void)thread;
+    mask.reset();
+    for (unsigned cpu = 0; cpu < GetCpuCount() && cpu < MaxCpuCount; ++cpu) {
+        mask.set(cpu);
+    }
+    return RtCode::SUCCESS;
+#endif
+}
+
+#if defined(__linux__)
+static bool ReadSysUnsigned(const char* format, unsigned index, unsigned& value)
+{
+    char path[128];
+    snprintf(path, sizeof(path), format, index);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    const bool success = fscanf(file, "%u", &value) == 1;
+    fclose(file);
+    return success;
+}
+
+/**
+ * @brief Assign its NUMA node to each cpu from the sysfs node cpulist files.
+ */
+static void ReadNumaNodes(std::vector<CpuTopology>& topology)
+{
+    DIR* directory = opendir("/sys/devices/system/node");
+    if (!directory) {
+        return;
+    }
+    while (const dirent* entry = readdir(directory)) {
+        unsigned node = 0;
+        if (sscanf(entry->d_name, "node%u", &node) != 1) {
+            continue;
+        }
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+        FILE* file = fopen(path, "r");
+        if (!file) {
+            continue;
+        }
+        unsigned first = 0;
+        while (fscanf(file, "%u", &first) == 1) {
+            unsigned last = first;
+            int      separator = fgetc(file);
+            if (separator == '-') {
+                if (fscanf(file, "%u", &last) != 1) {
+                    break;
+                }
+                separator = fgetc(file);
+            }
+            for (auto& cpu : topology) {
+                if (cpu.cpu >= first && cpu.cpu <= last) {
+                    cpu.node = node;
+                }
+            }
+            if (separator != ',') {
+                break;
+            }
+        }
+        fclose(file);
+    }
+    closedir(directory);
+}
+#endif
+
+std::vector<CpuTopology> GetCpuTopology()
+{
+    std::vector<CpuTopology> topology;
+    CpuMask                  mask;
+    GetAffinity(pthread_self(), mask);
+    for (unsigned cpu = 0; cpu < MaxCpuCount; ++cpu) {
+        if (mask.test(cpu)) {
+            topology.push_back({ cpu, cpu, 0, 0 });
+        }
+    }
+#if defined(__linux__)
+    for (auto& cpu : topology) {
+        ReadSysUnsigned("/sys/devices/system/cpu/cpu%u/topology/core_id", cpu.cpu, cpu.core);
+        ReadSysUnsigned("/sys/devices/system/cpu/cpu%u/topology/physical_package_id",
+                        cpu.cpu,
+                        cpu.package);
+    }
+    ReadNumaNodes(topology);
+#endif
+    return topology;
+}
+
+static RtCode SetRealtimePriority(pthread_t thread, int priority)
+{
+    if (priority < GetRealtimePriorityMin() || priority > GetRealtimePriorityMax()) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    sched_param param {};
+    param.sched_priority = priority;
+    return ErrnoToRtCode(pthread_setschedparam(thread, SCHED_FIFO, &param));
+}
+
+static RtCode ResetPriority(pthread_t thread)
+{
+    sched_param param {};
+    param.sched_priority = 0;
+    return ErrnoToRtCode(pthread_setschedparam(thread, SCHED_OTHER, &param));
+}
+
+static RtCode GetRealtimePriority(pthread_t thread, int& priority)
+{
+    int         policy = 0;
+    sched_param param {};
+    const int   result = pthread_getschedparam(thread, &policy, &param);
+    if (result != 0) {
+        return ErrnoToRtCode(result);
+    }
+    priority = (policy == SCHED_FIFO || policy == SCHED_RR) ? param.sched_priority : 0;
+    return RtCode::SUCCESS;
+}
+
+RtCode SetThreadAffinity(const CpuMask& mask)
+{
+    return SetAffinity(pthread_self(), mask);
+}
+
+RtCode SetThreadAffinity(std::thread& thread, const CpuMask& mask)
+{
+    return SetAffinity(thread.native_handle(), mask);
+}
+
+RtCode GetThreadAffinity(CpuMask& mask)
+{
+    return GetAffinity(pthread_self(), mask);
+}
+
+RtCode GetThreadAffinity(std::thread& thread, CpuMask& mask)
+{
+    return GetAffinity(thread.native_handle(), mask);
+}
+
+int GetRealtimePriorityMin()
+{
+    return sched_get_priority_min(SCHED_FIFO);
+}
+
+int GetRealtimePriorityMax()
+{
+    return sched_get_priority_max(SCHED_FIFO);
+}
+
+RtCode SetThreadRealtimePriority(int priority)
+{
+    return SetRealtimePriority(pthread_self(), priority);
+}
+
+RtCode SetThreadRealtimePriority(std::thread& thread, int priority)
+{
+    return SetRealtimePriority(thread.native_handle(), priority);
+}
+
+RtCode ResetThreadPriority()
+{
+    return ResetPriority(pthread_self());
+}
+
+RtCode ResetThreadPriority(std::thread& thread)
+{
+    return ResetPriority(thread.native_handle());
+}
+
+RtCode GetThreadRealtimePriority(int& priority)
+{
+    return GetRealtimePriority(pthread_self(), priority);
+}
+
+RtCode GetThreadRealtimePriority(std::thread& thread, int& priority)
+{
+    return GetRealtimePriority(thread.native_handle(), priority);
+}
+
+RtCode LockProcessMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+        return RtCode::SUCCESS;
+    }
+    // Unprivileged processes get ENOMEM once RLIMIT_MEMLOCK is reached.
+    if (errno == ENOMEM) {
+        return RtCode::PERMISSION_DENIED;
+    }
+    return ErrnoToRtCode(errno);
+}
+
+RtCode UnlockProcessMemory()
+{
+    if (munlockall() == 0) {
+        return RtCode::SUCCESS;
+    }
+    return ErrnoToRtCode(errno);
+}
+
+} // namespace Netero::Os
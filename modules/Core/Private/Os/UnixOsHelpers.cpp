@@ -50,7 +50,7 @@ std::string GetUserAppDataRoamingPath()
 
 std::string GetBundlePath()
 {
-    return netero::isDebugMode ? "." : "/usr/share";
+    return Netero::IsDebugMode ? "." : "/usr/share";
 }
 
 std::string GetExecutablePath()
@@ -59,12 +59,12 @@ std::string GetExecutablePath()
     char dest[PATH_MAX];
     memset(dest, 0, sizeof(dest));
     pid_t pid = getpid();
-    snprintf(path, "/proc/%ld/exe", static_cast<long>(pid));
+    snprintf(path, sizeof(path), "/proc/%ld/exe", static_cast<long>(pid));
     ssize_t result = readlink(path, dest, PATH_MAX);
     if (result == -1 || static_cast<size_t>(result) >= sizeof(dest)) {
         return "";
     }
-    return std::string(path);
+    return std::string(dest);
 }
 
 static std::atomic<int> g_com_library_locks = 0;
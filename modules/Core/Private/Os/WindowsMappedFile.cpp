@@ -0,0 +1,192 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+// clang-format off
+
+#include <windows.h>
+
+#include <utility>
+
+#include <Netero/MappedFile.hpp>
+
+// clang-format on
+
+namespace Netero::Os {
+
+static RtCode LastErrorToRtCode()
+{
+    switch (GetLastError()) {
+        case ERROR_SUCCESS: return RtCode::SUCCESS;
+        case ERROR_FILE_NOT_FOUND:
+        case ERROR_PATH_NOT_FOUND: return RtCode::NOT_FOUND;
+        case ERROR_ACCESS_DENIED:
+        case ERROR_SHARING_VIOLATION: return RtCode::PERMISSION_DENIED;
+        case ERROR_INVALID_PARAMETER: return RtCode::INVALID_ARGUMENT;
+        default: return RtCode::SYSTEM_ERROR;
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _mappingBase = std::exchange(other._mappingBase, nullptr);
+        _mappingSize = std::exchange(other._mappingSize, 0);
+        _mode = other._mode;
+        _isOpen = std::exchange(other._isOpen, false);
+        _fileHandle = std::exchange(other._fileHandle, nullptr);
+        _mappingHandle = std::exchange(other._mappingHandle, nullptr);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+RtCode MappedFile::Open(const std::string& path, const Options& options)
+{
+    Close();
+    const bool  writable = options.mode == Mode::READ_WRITE;
+    const DWORD access = writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    const DWORD disposition = writable && options.create ? OPEN_ALWAYS : OPEN_EXISTING;
+    HANDLE      file = CreateFileA(path.c_str(),
+                              access,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              disposition,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return LastErrorToRtCode();
+    }
+    if (writable && options.size > 0) {
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(options.size);
+        if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            const RtCode result = LastErrorToRtCode();
+            CloseHandle(file);
+            return result;
+        }
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        const RtCode result = LastErrorToRtCode();
+        CloseHandle(file);
+        return result;
+    }
+    _fileHandle = file;
+    _mode = options.mode;
+    _isOpen = true;
+    if (fileSize.QuadPart == 0) {
+        return RtCode::SUCCESS;
+    }
+    HANDLE mapping = CreateFileMappingA(file,
+                                        nullptr,
+                                        writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        0,
+                                        0,
+                                        nullptr);
+    if (!mapping) {
+        const RtCode result = LastErrorToRtCode();
+        Close();
+        return result;
+    }
+    _mappingHandle = mapping;
+    void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        const RtCode result = LastErrorToRtCode();
+        Close();
+        return result;
+    }
+    _mappingBase = view;
+    _mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+    _data = static_cast<std::byte*>(view);
+    _size = _mappingSize;
+    // Large pages are only available for anonymous memory, options.hugePages is ignored.
+    if (options.populate) {
+        Advise(Access::WILL_NEED);
+    }
+    return RtCode::SUCCESS;
+}
+
+void MappedFile::Close()
+{
+    if (_mappingBase) {
+        UnmapViewOfFile(_mappingBase);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mappingBase = nullptr;
+    _mappingSize = 0;
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+    _isOpen = false;
+}
+
+RtCode MappedFile::Advise(Access access, std::size_t offset, std::size_t length)
+{
+    if (!_isOpen || offset > _size) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    if (length == 0 || offset + length > _size) {
+        length = _size - offset;
+    }
+    if (length == 0) {
+        return RtCode::SUCCESS;
+    }
+    switch (access) {
+        case Access::WILL_NEED: {
+            WIN32_MEMORY_RANGE_ENTRY range;
+            range.VirtualAddress = _data + offset;
+            range.NumberOfBytes = length;
+            if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0)) {
+                return LastErrorToRtCode();
+            }
+            return RtCode::SUCCESS;
+        }
+        case Access::DONT_NEED:
+            if (!VirtualUnlock(_data + offset, length) &&
+                GetLastError() != ERROR_NOT_LOCKED) {
+                return LastErrorToRtCode();
+            }
+            return RtCode::SUCCESS;
+        case Access::NORMAL: return RtCode::SUCCESS;
+        default: return RtCode::NOT_SUPPORTED;
+    }
+}
+
+RtCode MappedFile::Flush(bool async)
+{
+    if (!_isOpen) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    if (!_mappingBase || _mode == Mode::READ_ONLY) {
+        return RtCode::SUCCESS;
+    }
+    if (!FlushViewOfFile(_mappingBase, 0)) {
+        return LastErrorToRtCode();
+    }
+    if (!async && !FlushFileBuffers(_fileHandle)) {
+        return LastErrorToRtCode();
+    }
+    return RtCode::SUCCESS;
+}
+
+} // namespace Netero::Os
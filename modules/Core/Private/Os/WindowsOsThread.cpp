@@ -0,0 +1,215 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+// clang-format off
+
+#include <windows.h>
+
+#include <thread>
+#include <vector>
+
+#include <Netero/Os.hpp>
+
+// clang-format on
+
+namespace Netero::Os {
+
+static RtCode LastErrorToRtCode()
+{
+    switch (GetLastError()) {
+        case ERROR_SUCCESS: return RtCode::SUCCESS;
+        case ERROR_ACCESS_DENIED:
+        case ERROR_PRIVILEGE_NOT_HELD: return RtCode::PERMISSION_DENIED;
+        case ERROR_INVALID_PARAMETER:
+        case ERROR_INVALID_HANDLE: return RtCode::INVALID_ARGUMENT;
+        default: return RtCode::SYSTEM_ERROR;
+    }
+}
+
+unsigned GetCpuCount()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<unsigned>(info.dwNumberOfProcessors);
+}
+
+static RtCode SetAffinity(HANDLE thread, const CpuMask& mask)
+{
+    if (mask.none()) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    // Without processor groups a thread can only address the first 64 cpus.
+    DWORD_PTR nativeMask = 0;
+    for (size_t cpu = 0; cpu < MaxCpuCount; ++cpu) {
+        if (mask.test(cpu)) {
+            if (cpu >= sizeof(DWORD_PTR) * 8) {
+                return RtCode::NOT_SUPPORTED;
+            }
+            nativeMask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    if (SetThreadAffinityMask(thread, nativeMask) == 0) {
+        return LastErrorToRtCode();
+    }
+    return RtCode::SUCCESS;
+}
+
+static RtCode GetAffinity(HANDLE thread, CpuMask& mask)
+{
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        return LastErrorToRtCode();
+    }
+    // Windows has no getter, the previous mask is returned when a new one is set.
+    const DWORD_PTR previous = SetThreadAffinityMask(thread, processMask);
+    if (previous == 0) {
+        return LastErrorToRtCode();
+    }
+    SetThreadAffinityMask(thread, previous);
+    mask.reset();
+    for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        if (previous & (static_cast<DWORD_PTR>(1) << cpu)) {
+            mask.set(cpu);
+        }
+    }
+    return RtCode::SUCCESS;
+}
+
+static RtCode SetRealtimePriority(HANDLE thread, int priority)
+{
+    if (priority < GetRealtimePriorityMin() || priority > GetRealtimePriorityMax()) {
+        return RtCode::INVALID_ARGUMENT;
+    }
+    if (!SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL)) {
+        return LastErrorToRtCode();
+    }
+    return RtCode::SUCCESS;
+}
+
+static RtCode ResetPriority(HANDLE thread)
+{
+    if (!SetThreadPriority(thread, THREAD_PRIORITY_NORMAL)) {
+        return LastErrorToRtCode();
+    }
+    return RtCode::SUCCESS;
+}
+
+static RtCode GetRealtimePriority(HANDLE thread, int& priority)
+{
+    const int nativePriority = GetThreadPriority(thread);
+    if (nativePriority == THREAD_PRIORITY_ERROR_RETURN) {
+        return LastErrorToRtCode();
+    }
+    priority = nativePriority == THREAD_PRIORITY_TIME_CRITICAL ? GetRealtimePriorityMax() : 0;
+    return RtCode::SUCCESS;
+}
+
+RtCode SetThreadAffinity(const CpuMask& mask)
+{
+    return SetAffinity(GetCurrentThread(), mask);
+}
+
+RtCode SetThreadAffinity(std::thread& thread, const CpuMask& mask)
+{
+    return SetAffinity(thread.native_handle(), mask);
+}
+
+RtCode GetThreadAffinity(CpuMask& mask)
+{
+    return GetAffinity(GetCurrentThread(), mask);
+}
+
+RtCode GetThreadAffinity(std::thread& thread, CpuMask& mask)
+{
+    return GetAffinity(thread.native_handle(), mask);
+}
+
+std::vector<CpuTopology> GetCpuTopology()
+{
+    std::vector<CpuTopology> topology;
+    const unsigned           count = GetCpuCount();
+    for (unsigned cpu = 0; cpu < count && cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        topology.push_back({ cpu, cpu, 0, 0 });
+    }
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(
+        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (infos.empty() || !GetLogicalProcessorInformation(infos.data(), &length)) {
+        return topology;
+    }
+    unsigned core = 0;
+    unsigned package = 0;
+    for (const auto& info : infos) {
+        for (auto& cpu : topology) {
+            if (!(info.ProcessorMask & (static_cast<ULONG_PTR>(1) << cpu.cpu))) {
+                continue;
+            }
+            switch (info.Relationship) {
+                case RelationProcessorCore: cpu.core = core; break;
+                case RelationProcessorPackage: cpu.package = package; break;
+                case RelationNumaNode: cpu.node = info.NumaNode.NodeNumber; break;
+                default: break;
+            }
+        }
+        core += info.Relationship == RelationProcessorCore;
+        package += info.Relationship == RelationProcessorPackage;
+    }
+    return topology;
+}
+
+int GetRealtimePriorityMin()
+{
+    return 1;
+}
+
+int GetRealtimePriorityMax()
+{
+    return 99;
+}
+
+RtCode SetThreadRealtimePriority(int priority)
+{
+    return SetRealtimePriority(GetCurrentThread(), priority);
+}
+
+RtCode SetThreadRealtimePriority(std::thread& thread, int priority)
+{
+    return SetRealtimePriority(thread.native_handle(), priority);
+}
+
+RtCode ResetThreadPriority()
+{
+    return ResetPriority(GetCurrentThread());
+}
+
+RtCode ResetThreadPriority(std::thread& thread)
+{
+    return ResetPriority(thread.native_handle());
+}
+
+RtCode GetThreadRealtimePriority(int& priority)
+{
+    return GetRealtimePriority(GetCurrentThread(), priority);
+}
+
+RtCode GetThreadRealtimePriority(std::thread& thread, int& priority)
+{
+    return GetRealtimePriority(thread.native_handle(), priority);
+}
+
+RtCode LockProcessMemory()
+{
+    // VirtualLock only works on explicit ranges, there is no mlockall equivalent.
+    return RtCode::NOT_SUPPORTED;
+}
+
+RtCode UnlockProcessMemory()
+{
+    return RtCode::NOT_SUPPORTED;
+}
+
+} // namespace Netero::Os
@@ -0,0 +1,169 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <Netero/PerfCounters.hpp>
+
+#if defined(__linux__)
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Netero {
+
+#if defined(__linux__)
+
+namespace {
+
+    struct EventConfig {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    /**
+     * @brief In PerfCounters::Event order.
+     */
+    constexpr EventConfig g_events[PerfCounters::eventCount] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE,
+          PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+              | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    };
+
+    /**
+     * @brief Layout of read() with TOTAL_TIME_ENABLED and TOTAL_TIME_RUNNING.
+     */
+    struct ReadFormat {
+        std::uint64_t value;
+        std::uint64_t enabled;
+        std::uint64_t running;
+    };
+
+    int OpenEvent(const EventConfig& event) noexcept
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = event.type;
+        attributes.config = event.config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // Calling thread, any cpu, no group.
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+} // namespace
+
+PerfCounters::PerfCounters() noexcept
+{
+    for (std::size_t idx = 0; idx < eventCount; ++idx) {
+        _descriptors[idx] = OpenEvent(g_events[idx]);
+        if (_descriptors[idx] >= 0) {
+            _availableMask |= 1u << idx;
+        }
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (const int descriptor : _descriptors) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+}
+
+void PerfCounters::Enable() noexcept
+{
+    for (const int descriptor : _descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::Disable() noexcept
+{
+    for (const int descriptor : _descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::Reset() noexcept
+{
+    for (const int descriptor : _descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+}
+
+PerfCounters::Sample PerfCounters::Read() const noexcept
+{
+    Sample sample;
+    for (std::size_t idx = 0; idx < eventCount; ++idx) {
+        ReadFormat data {};
+        if (_descriptors[idx] < 0
+            || read(_descriptors[idx], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        // More events than hardware counters, the kernel time share them: extrapolate.
+        if (data.running != 0 && data.running < data.enabled) {
+            data.value = static_cast<std::uint64_t>(static_cast<double>(data.value)
+                                                    * static_cast<double>(data.enabled)
+                                                    / static_cast<double>(data.running));
+        }
+        sample.values[idx] = data.value;
+        sample.availableMask |= 1u << idx;
+    }
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() noexcept
+{
+    _descriptors.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Enable() noexcept {}
+void PerfCounters::Disable() noexcept {}
+void PerfCounters::Reset() noexcept {}
+
+PerfCounters::Sample PerfCounters::Read() const noexcept
+{
+    return Sample();
+}
+
+#endif
+
+namespace {
+
+    struct ThreadCounters {
+        ThreadCounters() noexcept { counters.Enable(); }
+        PerfCounters counters;
+    };
+
+} // namespace
+
+PerfCounters& PerfCounters::GetThreadCounters() noexcept
+{
+    thread_local ThreadCounters t_counters;
+    return t_counters.counters;
+}
+
+} // namespace Netero
@@ -0,0 +1,292 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#include <Netero/Profiler.hpp>
+
+namespace Netero::Profiler {
+
+namespace {
+
+    /**
+     * @brief Event storage, fields are atomics so Collect can read a slot being
+     * overwritten, such slot is detected and dropped afterward.
+     */
+    struct Slot {
+        std::atomic<const char*>                                         name = nullptr;
+        std::atomic<std::uint64_t>                                       begin = 0;
+        std::atomic<std::uint64_t>                                       end = 0;
+        std::atomic<std::uint32_t>                                       counterMask = 0;
+        std::array<std::atomic<std::uint64_t>, PerfCounters::eventCount> counters {};
+    };
+
+    /**
+     * @brief Single producer ring of events, written only by its thread.
+     */
+    struct ThreadBuffer {
+        ThreadBuffer(std::uint32_t id, std::size_t size)
+            : thread(id), capacity(size), slots(new Slot[size])
+        {
+        }
+
+        const std::uint32_t        thread;
+        const std::size_t          capacity;
+        std::unique_ptr<Slot[]>    slots;
+        std::atomic<std::uint64_t> head = 0; /**< Events written so far. */
+        std::atomic<std::uint64_t> tail = 0; /**< Events dropped by Clear. */
+        std::mutex                 mutex;    /**< Guard name. */
+        std::string                name;
+    };
+
+    /**
+     * @brief Buffers of every thread that recorded a scope, kept after the thread exit.
+     * Leaked on purpose, threads may record scopes during the static destructors.
+     */
+    struct BufferRegistry {
+        std::mutex                                 mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    };
+
+    BufferRegistry& GetRegistry()
+    {
+        static auto* registry = new BufferRegistry();
+        return *registry;
+    }
+
+    std::atomic<bool>        g_enabled = true;
+    std::atomic<bool>        g_counters = false;
+    std::atomic<std::size_t> g_capacity = 65536;
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer* GetThreadBuffer()
+    {
+        if (!t_buffer) {
+            auto&                        registry = GetRegistry();
+            std::scoped_lock<std::mutex> lock(registry.mutex);
+            auto                         buffer = std::make_shared<ThreadBuffer>(
+                static_cast<std::uint32_t>(registry.buffers.size()),
+                std::max<std::size_t>(g_capacity.load(std::memory_order_relaxed), 1));
+            registry.buffers.push_back(buffer);
+            t_buffer = buffer.get();
+        }
+        return t_buffer;
+    }
+
+    void WriteEscaped(std::ostream& output, const char* text)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        for (; *text; ++text) {
+            const auto c = static_cast<unsigned char>(*text);
+            if (c == '"' || c == '\\') {
+                output << '\\' << *text;
+            }
+            else if (c < 0x20) {
+                output << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+            }
+            else {
+                output << *text;
+            }
+        }
+    }
+
+    /**
+     * @brief Write nanoseconds as microseconds with three decimals, the trace unit.
+     */
+    void WriteMicroseconds(std::ostream& output, std::uint64_t nanoseconds)
+    {
+        const std::uint64_t fraction = nanoseconds % 1000;
+        output << nanoseconds / 1000 << '.' << static_cast<char>('0' + fraction / 100)
+               << static_cast<char>('0' + fraction / 10 % 10)
+               << static_cast<char>('0' + fraction % 10);
+    }
+
+    constexpr const char* g_counterNames[PerfCounters::eventCount] = {
+        "cycles", "instructions", "cache_misses", "branch_misses", "tlb_misses"
+    };
+
+    void WriteCounters(std::ostream& output, const PerfCounters::Sample& counters)
+    {
+        const char* separator = "";
+        output << ",\"args\":{";
+        for (std::size_t idx = 0; idx < PerfCounters::eventCount; ++idx) {
+            if (counters.IsAvailable(static_cast<PerfCounters::Event>(idx))) {
+                output << separator << '"' << g_counterNames[idx] << "\":" << counters.values[idx];
+                separator = ",";
+            }
+        }
+        if (counters.IsAvailable(PerfCounters::Event::CYCLES)
+            && counters.IsAvailable(PerfCounters::Event::INSTRUCTIONS)) {
+            output << ",\"ipc\":" << counters.GetIpc();
+        }
+        output << '}';
+    }
+
+} // namespace
+
+void SetEnabled(bool enabled) noexcept
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled() noexcept
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void SetCountersEnabled(bool enabled) noexcept
+{
+    g_counters.store(enabled, std::memory_order_relaxed);
+}
+
+bool AreCountersEnabled() noexcept
+{
+    return g_counters.load(std::memory_order_relaxed);
+}
+
+void SetBufferCapacity(std::size_t capacity) noexcept
+{
+    g_capacity.store(capacity, std::memory_order_relaxed);
+}
+
+void SetThreadName(const std::string& name)
+{
+    ThreadBuffer*                buffer = GetThreadBuffer();
+    std::scoped_lock<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+}
+
+void Record(const char*                 name,
+            Clock::time_point           begin,
+            Clock::time_point           end,
+            const PerfCounters::Sample& counters) noexcept
+{
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadBuffer*       buffer = GetThreadBuffer();
+    const std::uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    Slot&               slot = buffer->slots[head % buffer->capacity];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.end.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.counterMask.store(counters.availableMask, std::memory_order_relaxed);
+    for (std::size_t idx = 0; idx < PerfCounters::eventCount; ++idx) {
+        if ((counters.availableMask >> idx) & 1u) {
+            slot.counters[idx].store(counters.values[idx], std::memory_order_relaxed);
+        }
+    }
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<ThreadEvents> Collect()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        auto&                        registry = GetRegistry();
+        std::scoped_lock<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+    std::vector<ThreadEvents> threads;
+    threads.reserve(buffers.size());
+    for (auto& buffer : buffers) {
+        ThreadEvents thread;
+        thread.thread = buffer->thread;
+        {
+            std::scoped_lock<std::mutex> lock(buffer->mutex);
+            thread.name = buffer->name;
+        }
+        const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const std::uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        const std::uint64_t oldest = head > buffer->capacity ? head - buffer->capacity : 0;
+        const std::uint64_t first = std::max(tail, oldest);
+        thread.events.reserve(head - std::min(first, head));
+        for (std::uint64_t idx = first; idx < head; ++idx) {
+            const Slot& slot = buffer->slots[idx % buffer->capacity];
+            Event       event { slot.name.load(std::memory_order_relaxed),
+                                slot.begin.load(std::memory_order_relaxed),
+                                slot.end.load(std::memory_order_relaxed),
+                                {} };
+            event.counters.availableMask = slot.counterMask.load(std::memory_order_relaxed);
+            for (std::size_t counter = 0; counter < PerfCounters::eventCount; ++counter) {
+                if (event.counters.IsAvailable(static_cast<PerfCounters::Event>(counter))) {
+                    event.counters.values[counter] =
+                        slot.counters[counter].load(std::memory_order_relaxed);
+                }
+            }
+            thread.events.push_back(event);
+        }
+        // The owner may have lapped the copy meanwhile, drop the overwritten events
+        // including the one being written.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t written = buffer->head.load(std::memory_order_relaxed);
+        if (written + 1 > first + buffer->capacity) {
+            const std::uint64_t valid = written + 1 - buffer->capacity;
+            const std::size_t   dropped = static_cast<std::size_t>(
+                std::min<std::uint64_t>(valid - first, thread.events.size()));
+            thread.events.erase(thread.events.begin(), thread.events.begin() + dropped);
+        }
+        threads.push_back(std::move(thread));
+    }
+    return threads;
+}
+
+void Clear()
+{
+    auto&                        registry = GetRegistry();
+    std::scoped_lock<std::mutex> lock(registry.mutex);
+    for (auto& buffer : registry.buffers) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void WriteChromeTrace(std::ostream& output)
+{
+    const auto threads = Collect();
+    bool       first = true;
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto& thread : threads) {
+        if (!thread.name.empty()) {
+            output << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   << "\"tid\":" << thread.thread << ",\"args\":{\"name\":\"";
+            WriteEscaped(output, thread.name.c_str());
+            output << "\"}}";
+            first = false;
+        }
+        for (const auto& event : thread.events) {
+            output << (first ? "\n" : ",\n") << "{\"name\":\"";
+            WriteEscaped(output, event.name ? event.name : "");
+            output << "\",\"cat\":\"netero\",\"ph\":\"X\",\"ts\":";
+            WriteMicroseconds(output, event.begin);
+            output << ",\"dur\":";
+            WriteMicroseconds(output, event.end > event.begin ? event.end - event.begin : 0);
+            output << ",\"pid\":1,\"tid\":" << thread.thread;
+            if (event.counters.availableMask != 0) {
+                WriteCounters(output, event.counters);
+            }
+            output << '}';
+            first = false;
+        }
+    }
+    output << "\n]}\n";
+}
+
+bool WriteChromeTrace(const std::string& path)
+{
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        return false;
+    }
+    WriteChromeTrace(output);
+    output.flush();
+    return static_cast<bool>(output);
+}
+
+} // namespace Netero::Profiler
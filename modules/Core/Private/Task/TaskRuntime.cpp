@@ -0,0 +1,111 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+
+#include <Netero/TaskRuntime.hpp>
+#include <Netero/TimerWheel.hpp>
+
+namespace Netero::Detail {
+
+static thread_local bool g_frame_pool_alive = true;
+
+/**
+ * @brief Thread local cache of coroutine frames, one free list per power of two size class.
+ * A frame released by another thread than the one allocating it simply join the cache of
+ * the releasing thread. Each list is bounded, surplus frames go back to the heap.
+ */
+class FramePool {
+    struct Block {
+        Block* next;
+    };
+
+    public:
+    static constexpr std::size_t minimumSize = 128;
+    static constexpr std::size_t classCount = 6; // 128 to 4096 bytes.
+    static constexpr std::size_t maximumCached = 64;
+
+    ~FramePool()
+    {
+        g_frame_pool_alive = false;
+        for (auto* block : _freeLists) {
+            while (block) {
+                Block* next = block->next;
+                ::operator delete(block);
+                block = next;
+            }
+        }
+    }
+
+    static int GetClass(std::size_t size)
+    {
+        std::size_t classSize = minimumSize;
+        for (int sizeClass = 0; sizeClass < static_cast<int>(classCount); ++sizeClass) {
+            if (size <= classSize) {
+                return sizeClass;
+            }
+            classSize *= 2;
+        }
+        return -1;
+    }
+
+    void* Allocate(int sizeClass)
+    {
+        Block* block = _freeLists[sizeClass];
+        if (block) {
+            _freeLists[sizeClass] = block->next;
+            _counts[sizeClass] -= 1;
+            return block;
+        }
+        return ::operator new(minimumSize << sizeClass);
+    }
+
+    void Deallocate(void* frame, int sizeClass)
+    {
+        if (_counts[sizeClass] >= maximumCached) {
+            ::operator delete(frame);
+            return;
+        }
+        auto* block = static_cast<Block*>(frame);
+        block->next = _freeLists[sizeClass];
+        _freeLists[sizeClass] = block;
+        _counts[sizeClass] += 1;
+    }
+
+    private:
+    Block*      _freeLists[classCount] = {};
+    std::size_t _counts[classCount] = {};
+};
+
+static thread_local FramePool g_frame_pool;
+
+void* AllocateFrame(std::size_t size)
+{
+    const int sizeClass = FramePool::GetClass(size);
+    if (sizeClass < 0 || !g_frame_pool_alive) {
+        return ::operator new(size);
+    }
+    return g_frame_pool.Allocate(sizeClass);
+}
+
+void DeallocateFrame(void* frame, std::size_t size) noexcept
+{
+    const int sizeClass = FramePool::GetClass(size);
+    if (sizeClass < 0 || !g_frame_pool_alive) {
+        ::operator delete(frame);
+        return;
+    }
+    g_frame_pool.Deallocate(frame, sizeClass);
+}
+
+void ScheduleTimer(std::chrono::nanoseconds delay, std::function<void()> callback)
+{
+    TimerWheel::GetDefault().Schedule(delay, std::move(callback));
+}
+
+} // namespace Netero::Detail
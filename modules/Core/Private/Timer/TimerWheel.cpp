@@ -0,0 +1,264 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+
+#include <Netero/TimerWheel.hpp>
+
+namespace Netero {
+
+TimerWheel::TimerWheel(): TimerWheel(Options())
+{
+}
+
+TimerWheel::TimerWheel(const Options& options)
+    : _resolution(std::max(options.resolution, Duration(1))), _start(Clock::now())
+{
+    _slots.fill(none);
+    if (options.dedicatedThread) {
+        _thread = std::thread(&TimerWheel::Run, this);
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    if (_thread.joinable()) {
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+    }
+}
+
+TimerWheel& TimerWheel::GetDefault()
+{
+    static TimerWheel wheel([]() {
+        Options options;
+        options.dedicatedThread = true;
+        return options;
+    }());
+    return wheel;
+}
+
+TimerWheel::Handle TimerWheel::Schedule(Duration delay, Callback callback)
+{
+    return Add(delay, Duration(0), std::move(callback));
+}
+
+TimerWheel::Handle TimerWheel::SchedulePeriodic(Duration period, Callback callback)
+{
+    return Add(period, std::max(period, _resolution), std::move(callback));
+}
+
+bool TimerWheel::Cancel(Handle handle)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (handle.index >= _nodes.size()) {
+        return false;
+    }
+    Node& node = _nodes[handle.index];
+    if (node.generation != handle.generation || node.slot == none) {
+        return false;
+    }
+    Unlink(handle.index);
+    Release(handle.index);
+    return true;
+}
+
+bool TimerWheel::IsPending(Handle handle) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return handle.index < _nodes.size() && _nodes[handle.index].generation == handle.generation &&
+        _nodes[handle.index].slot != none;
+}
+
+std::size_t TimerWheel::GetPendingCount() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _pendingCount;
+}
+
+std::size_t TimerWheel::Tick()
+{
+    return Tick(Clock::now());
+}
+
+std::size_t TimerWheel::Tick(TimePoint now)
+{
+    std::scoped_lock<std::mutex> tickLock(_tickMutex);
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        const auto                   elapsed = now - _start;
+        const std::uint64_t          target =
+            elapsed.count() > 0 ? static_cast<std::uint64_t>(elapsed / _resolution) : 0;
+        while (_currentTick < target) {
+            if (_pendingCount == 0) {
+                _currentTick = target;
+                break;
+            }
+            _currentTick += 1;
+            // Coarse levels first, a timer can fall through several levels at once.
+            for (unsigned level = levelCount - 1; level > 0; --level) {
+                const std::uint64_t mask = (std::uint64_t(1) << (level * levelBits)) - 1;
+                if ((_currentTick & mask) == 0) {
+                    Cascade(level);
+                }
+            }
+            std::uint32_t& head = _slots[_currentTick & (slotCount - 1)];
+            std::uint32_t  index = head;
+            head = none;
+            while (index != none) {
+                Node&               node = _nodes[index];
+                const std::uint32_t next = node.next;
+                node.slot = none;
+                if (node.period > 0) {
+                    _batch.push_back(node.callback);
+                    node.expiry += node.period;
+                    Link(index);
+                }
+                else {
+                    _batch.push_back(std::move(node.callback));
+                    Release(index);
+                }
+                index = next;
+            }
+        }
+    }
+    const std::size_t count = _batch.size();
+    for (auto& callback : _batch) {
+        callback();
+    }
+    _batch.clear();
+    return count;
+}
+
+TimerWheel::Handle TimerWheel::Add(Duration delay, Duration period, Callback callback)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::uint32_t                index = _freeList;
+    if (index != none) {
+        _freeList = _nodes[index].next;
+    }
+    else {
+        index = static_cast<std::uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+    }
+    // Round the deadline up to a tick, a timer never fire early.
+    const Duration      deadline = Clock::now() - _start + std::max(delay, Duration(0));
+    const std::uint64_t expiry =
+        static_cast<std::uint64_t>((deadline + _resolution - Duration(1)) / _resolution);
+    Node& node = _nodes[index];
+    node.callback = std::move(callback);
+    node.expiry = std::max(expiry, _currentTick + 1);
+    node.period = static_cast<std::uint64_t>((period + _resolution - Duration(1)) / _resolution);
+    Link(index);
+    _pendingCount += 1;
+    const Handle handle { index, node.generation };
+    lock.unlock();
+    if (_thread.joinable()) {
+        _condition.notify_one();
+    }
+    return handle;
+}
+
+void TimerWheel::Link(std::uint32_t index)
+{
+    Node&               node = _nodes[index];
+    const std::uint64_t delta = node.expiry - _currentTick;
+    unsigned            level = 0;
+    while (level + 1 < levelCount && delta >= (std::uint64_t(1) << ((level + 1) * levelBits))) {
+        level += 1;
+    }
+    // Beyond the wheel range the timer wait in the last slot and is cascaded again.
+    const std::uint64_t range = std::uint64_t(1) << (levelCount * levelBits);
+    const std::uint64_t tick = delta >= range ? _currentTick + range - 1 : node.expiry;
+    const std::uint32_t slot = level * slotCount +
+        static_cast<std::uint32_t>((tick >> (level * levelBits)) & (slotCount - 1));
+    node.slot = slot;
+    node.previous = none;
+    node.next = _slots[slot];
+    if (node.next != none) {
+        _nodes[node.next].previous = index;
+    }
+    _slots[slot] = index;
+}
+
+void TimerWheel::Unlink(std::uint32_t index)
+{
+    Node& node = _nodes[index];
+    if (node.previous != none) {
+        _nodes[node.previous].next = node.next;
+    }
+    else {
+        _slots[node.slot] = node.next;
+    }
+    if (node.next != none) {
+        _nodes[node.next].previous = node.previous;
+    }
+    node.slot = none;
+    node.previous = none;
+    node.next = none;
+}
+
+void TimerWheel::Release(std::uint32_t index)
+{
+    Node& node = _nodes[index];
+    node.callback = nullptr;
+    node.generation += 1;
+    node.slot = none;
+    node.previous = none;
+    node.next = _freeList;
+    _freeList = index;
+    _pendingCount -= 1;
+}
+
+void TimerWheel::Cascade(unsigned level)
+{
+    const std::uint32_t slot = level * slotCount +
+        static_cast<std::uint32_t>((_currentTick >> (level * levelBits)) & (slotCount - 1));
+    std::uint32_t index = _slots[slot];
+    _slots[slot] = none;
+    while (index != none) {
+        const std::uint32_t next = _nodes[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+std::uint64_t TimerWheel::GetTicksUntilNextSlot() const
+{
+    for (std::uint64_t ticks = 1; ticks < slotCount; ++ticks) {
+        const std::uint64_t tick = _currentTick + ticks;
+        if (_slots[tick & (slotCount - 1)] != none || (tick & (slotCount - 1)) == 0) {
+            return ticks;
+        }
+    }
+    return slotCount;
+}
+
+void TimerWheel::Run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop) {
+        if (_pendingCount == 0) {
+            _condition.wait(lock);
+            continue;
+        }
+        const auto      ticks = static_cast<Duration::rep>(_currentTick + GetTicksUntilNextSlot());
+        const TimePoint wake = _start + _resolution * ticks;
+        const TimePoint now = Clock::now();
+        if (now < wake) {
+            _condition.wait_for(lock, wake - now);
+            continue;
+        }
+        lock.unlock();
+        Tick(now);
+        lock.lock();
+    }
+}
+
+} // namespace Netero
@@ -16,6 +16,8 @@
 #include <mutex>
 #include <type_traits>
 
+#include <Netero/Metrics.hpp>
+
 namespace Netero {
 
 /**
@@ -69,6 +71,8 @@ class SharedBuffer {
         this->_size = move._size;
         this->_readOffset = move._readOffset;
         this->_writeOffset = move._writeOffset;
+        this->_fillGauge = move._fillGauge;
+        move._fillGauge = nullptr;
         move._buffer = nullptr;
         move._size = 0;
         move._writeOffset = 0;
@@ -93,6 +97,8 @@ class SharedBuffer {
         this->_size = move._size;
         this->_readOffset = move._readOffset;
         this->_writeOffset = move._writeOffset;
+        this->_fillGauge = move._fillGauge;
+        move._fillGauge = nullptr;
         move._buffer = nullptr;
         move._size = 0;
         move._writeOffset = 0;
@@ -125,6 +131,17 @@ class SharedBuffer {
      */
     [[nodiscard]] size_t GetSize() const { return _size; }
 
+    /**
+     * @brief Publish the number of blocks valid for read after each operation.
+     * @param gauge may be null to stop publishing, must outlive the buffer otherwise.
+     */
+    void SetFillGauge(Metrics::Gauge* gauge)
+    {
+        std::scoped_lock<std::mutex> lock(_bufferMutex);
+        _fillGauge = gauge;
+        PublishFillLevel();
+    }
+
     /**
      * @brief Return the number of block valid for read operation.
      */
@@ -161,6 +178,7 @@ class SharedBuffer {
         _size = block;
         _readOffset = -1;
         _writeOffset = 0;
+        PublishFillLevel();
         if (block == 0) {
             _buffer = nullptr;
             return;
@@ -183,6 +201,7 @@ class SharedBuffer {
         std::memset(this->_buffer, 0, this->_size * sizeof(T));
         this->_readOffset = -1;
         this->_writeOffset = 0;
+        PublishFillLevel();
     }
 
     /**
@@ -224,6 +243,7 @@ class SharedBuffer {
                 _readOffset = -1;
             }
         }
+        PublishFillLevel();
         return readCount;
     }
 
@@ -258,15 +278,25 @@ class SharedBuffer {
                 }
             }
         }
+        PublishFillLevel();
         return writeCount;
     }
 
     private:
+    void PublishFillLevel()
+    {
+        if (_fillGauge) {
+            _fillGauge->Set(GetPadding());
+        }
+    }
+
     std::mutex _bufferMutex;      /**< Mutex to protect concurrent access to the internal buffer. */
     size_t     _size;             /**< Size in block of the internal buffer. */
     T*         _buffer = nullptr; /**< The internal buffer of type T*/
     int        _readOffset;       /**< The read offset. */
     int        _writeOffset;      /**< The the write offset. */
     Allocator  _allocator;
+
+    Metrics::Gauge* _fillGauge = nullptr; /**< Optional fill level publication. */
 };
 } // namespace Netero
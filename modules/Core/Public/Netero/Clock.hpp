@@ -0,0 +1,254 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Clock.hpp
+ * @brief Low overhead monotonic clock and stopwatch helpers.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+#include <Netero/Netero.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NETERO_HAS_TSC 1
+#else
+#define NETERO_HAS_TSC 0
+#endif
+
+namespace Netero {
+
+/**
+ * @brief Time source selected by the clock calibration.
+ */
+enum class ClockSource {
+    UNCALIBRATED, /**< The clock has not been read yet. */
+    TSC,          /**< Invariant time stamp counter of the cpu. */
+    MONOTONIC,    /**< OS monotonic clock, CLOCK_MONOTONIC_RAW or QueryPerformanceCounter. */
+};
+
+namespace Detail {
+    /**
+     * @brief Conversion parameters from cycles to nanoseconds.
+     * ns = baseNanoseconds + ((cycles - baseCycles) * multiplier) >> 32
+     */
+    struct ClockCalibration {
+        std::atomic<ClockSource> source;
+        std::uint64_t            baseCycles;
+        std::int64_t             baseNanoseconds;
+        std::uint64_t            multiplier;
+        double                   frequency;
+    };
+
+    extern ClockCalibration g_clock_calibration;
+
+    ClockSource  CalibrateClock();
+    std::int64_t ReadMonotonicNanoseconds() noexcept;
+
+    inline std::int64_t ScaleCycles(std::uint64_t cycles, std::uint64_t multiplier) noexcept
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        std::uint64_t high;
+        std::uint64_t low = _umul128(cycles, multiplier, &high);
+        return static_cast<std::int64_t>((high << 32) | (low >> 32));
+#elif defined(__SIZEOF_INT128__)
+        return static_cast<std::int64_t>(
+            (static_cast<unsigned __int128>(cycles) * multiplier) >> 32);
+#else
+        return static_cast<std::int64_t>(
+            static_cast<long double>(cycles) * multiplier / 4294967296.0L);
+#endif
+    }
+} // namespace Detail
+
+/**
+ * @brief Monotonic nanosecond clock.
+ * The clock read the invariant TSC of the cpu when it is reliable and fall back
+ * on the OS monotonic clock (vDSO CLOCK_MONOTONIC_RAW on linux) otherwise.
+ * It satisfy the std::chrono clock requirements and can be used with any std::chrono facility.
+ * The first read calibrate the TSC against the OS clock, this take around 10ms.
+ */
+class Clock {
+    public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<Clock>;
+    static constexpr bool is_steady = true;
+
+    /**
+     * @brief Return the current time.
+     */
+    static time_point now() noexcept
+    {
+        ClockSource source = Detail::g_clock_calibration.source.load(std::memory_order_acquire);
+        if (unlikely(source == ClockSource::UNCALIBRATED)) {
+            source = Detail::CalibrateClock();
+        }
+        if (source == ClockSource::TSC) {
+            // A thread migrated right after the calibration may observe a slightly skewed TSC.
+            const auto elapsed =
+                static_cast<std::int64_t>(ReadCycles() - Detail::g_clock_calibration.baseCycles);
+            return time_point(duration(Detail::g_clock_calibration.baseNanoseconds +
+                                       (elapsed > 0 ? Detail::ScaleCycles(
+                                                          static_cast<std::uint64_t>(elapsed),
+                                                          Detail::g_clock_calibration.multiplier)
+                                                    : 0)));
+        }
+        return time_point(duration(Detail::ReadMonotonicNanoseconds()));
+    }
+
+    /**
+     * @brief Read the cpu time stamp counter.
+     * The read is not ordered with the surrounding instructions, use ReadCyclesOrdered
+     * to wait for the previous instructions to retire.
+     * @return 0 on architecture without TSC.
+     */
+    static std::uint64_t ReadCycles() noexcept
+    {
+#if NETERO_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Read the cpu time stamp counter with rdtscp.
+     * rdtscp wait for all previous instructions to be executed before reading the counter.
+     */
+    static std::uint64_t ReadCyclesOrdered() noexcept
+    {
+#if NETERO_HAS_TSC
+        unsigned int aux;
+        return __rdtscp(&aux);
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Convert a cycle count to nanoseconds.
+     * @return 0 if the TSC is not used by the clock.
+     */
+    static duration CyclesToDuration(std::uint64_t cycles) noexcept
+    {
+        if (GetSource() != ClockSource::TSC) {
+            return duration(0);
+        }
+        return duration(Detail::ScaleCycles(cycles, Detail::g_clock_calibration.multiplier));
+    }
+
+    /**
+     * @brief Return the calibrated TSC frequency in Hz, 0 if the TSC is not used.
+     */
+    static double GetCyclesFrequency() noexcept
+    {
+        GetSource();
+        return Detail::g_clock_calibration.frequency;
+    }
+
+    /**
+     * @brief Return the time source used by the clock.
+     */
+    static ClockSource GetSource() noexcept
+    {
+        ClockSource source = Detail::g_clock_calibration.source.load(std::memory_order_acquire);
+        if (unlikely(source == ClockSource::UNCALIBRATED)) {
+            source = Detail::CalibrateClock();
+        }
+        return source;
+    }
+};
+
+/**
+ * @brief Measure the time elapsed since its construction or its last reset.
+ */
+class Stopwatch {
+    public:
+    Stopwatch(): _start(Clock::now()) {}
+
+    /**
+     * @brief Restart the measure.
+     */
+    void Reset() { _start = Clock::now(); }
+
+    /**
+     * @brief Return the time elapsed since the start.
+     */
+    [[nodiscard]] Clock::duration Elapsed() const { return Clock::now() - _start; }
+
+    /**
+     * @brief Return the time elapsed since the start and restart the measure.
+     */
+    Clock::duration Lap()
+    {
+        const Clock::time_point now = Clock::now();
+        const Clock::duration   elapsed = now - _start;
+        _start = now;
+        return elapsed;
+    }
+
+    private:
+    Clock::time_point _start;
+};
+
+/**
+ * @brief Add the lifetime of the scope to a duration.
+ * @code
+ * Netero::Clock::duration total {};
+ * {
+ *     Netero::ScopedStopwatch watch(total);
+ *     hotPath();
+ * }
+ * @endcode
+ */
+class ScopedStopwatch {
+    public:
+    explicit ScopedStopwatch(Clock::duration& accumulator)
+        : _accumulator(accumulator), _start(Clock::now())
+    {
+    }
+    ScopedStopwatch(const ScopedStopwatch&) = delete;
+    ScopedStopwatch& operator=(const ScopedStopwatch&) = delete;
+    ~ScopedStopwatch() { _accumulator += Clock::now() - _start; }
+
+    private:
+    Clock::duration&  _accumulator;
+    Clock::time_point _start;
+};
+
+/**
+ * @brief Call a callback with the lifetime of the scope.
+ * @tparam Callback invocable with a Clock::duration.
+ */
+template<typename Callback>
+class ScopedStopwatchCallback {
+    public:
+    explicit ScopedStopwatchCallback(Callback callback)
+        : _callback(std::move(callback)), _start(Clock::now())
+    {
+    }
+    ScopedStopwatchCallback(const ScopedStopwatchCallback&) = delete;
+    ScopedStopwatchCallback& operator=(const ScopedStopwatchCallback&) = delete;
+    ~ScopedStopwatchCallback() { _callback(Clock::now() - _start); }
+
+    private:
+    Callback          _callback;
+    Clock::time_point _start;
+};
+
+} // namespace Netero
@@ -0,0 +1,170 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Epoch.hpp
+ * @brief Epoch based memory reclamation.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Netero {
+
+/**
+ * @brief Epoch based reclamation domain.
+ * Readers of a lock free structure pin the domain for the duration of their access,
+ * writers unlink a node then retire it instead of deleting it. A retired node is
+ * deleted once every thread pinned at the time of the retire has unpinned, which
+ * take two advances of the global epoch.
+ * Threads are registered on their first pin or retire and unregistered when they
+ * exit, their remaining garbage is then handed to the domain.
+ * Garbage is kept per thread and reclaimed by batches, a thread holding more than
+ * Options::maxGarbage retired nodes wait for the readers to make progress, or hand
+ * its garbage to the domain when it is pinned itself.
+ * @code
+ * auto& epoch = Netero::EpochDomain::GetDefault();
+ * {
+ *     auto guard = epoch.Pin();
+ *     Node* node = head.load(std::memory_order_acquire);
+ *     Read(node);
+ * }
+ * Node* old = head.exchange(next, std::memory_order_acq_rel);
+ * epoch.Retire(old);
+ * @endcode
+ */
+class EpochDomain {
+    public:
+    using Deleter = void (*)(void*);
+
+    struct Options {
+        std::size_t collectThreshold = 64; /**< Retired nodes before a thread try to collect. */
+        std::size_t maxGarbage = 4096;     /**< Bound of the garbage kept by a thread. */
+    };
+
+    struct ThreadRecord;
+
+    /**
+     * @brief Keep the calling thread pinned while alive, guards can be nested.
+     */
+    class Guard {
+        public:
+        Guard() = default;
+        Guard(Guard&& other) noexcept;
+        Guard& operator=(Guard&& other) noexcept;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard();
+
+        /**
+         * @brief Unpin before the end of the scope.
+         */
+        void Release() noexcept;
+
+        private:
+        friend class EpochDomain;
+        Guard(EpochDomain* domain, ThreadRecord* record): _domain(domain), _record(record) {}
+
+        EpochDomain*  _domain = nullptr;
+        ThreadRecord* _record = nullptr;
+    };
+
+    EpochDomain();
+    explicit EpochDomain(const Options& options);
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    /**
+     * @brief Delete every retired node.
+     * @warning No thread may be pinned on the domain anymore.
+     */
+    ~EpochDomain();
+
+    /**
+     * @brief Process wide domain.
+     */
+    static EpochDomain& GetDefault();
+
+    /**
+     * @brief Register the calling thread, done implicitly by Pin and Retire.
+     */
+    void RegisterThread();
+
+    /**
+     * @brief Unregister the calling thread, done implicitly when the thread exit.
+     * The thread garbage is handed to the domain.
+     * @warning The thread must not be pinned.
+     */
+    void UnregisterThread();
+
+    [[nodiscard]] Guard Pin();
+
+    /**
+     * @brief Defer the deletion of ptr until no thread can still observe it.
+     * ptr must already be unreachable for threads pinning the domain from now.
+     */
+    void Retire(void* ptr, Deleter deleter);
+
+    template<typename T>
+    void Retire(T* ptr)
+    {
+        Retire(static_cast<void*>(ptr), [](void* object) { delete static_cast<T*>(object); });
+    }
+
+    /**
+     * @brief Try to advance the epoch then delete the reclaimable garbage of the
+     * calling thread and of the domain.
+     * @return The number of deleted nodes.
+     */
+    std::size_t Collect();
+
+    /**
+     * @brief Wait until every node retired so far by the calling thread and by the
+     * exited threads is deleted.
+     * @warning The calling thread must not be pinned.
+     */
+    void Synchronize();
+
+    [[nodiscard]] std::uint64_t GetEpoch() const noexcept
+    {
+        return _epoch.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of retired nodes waiting for deletion, for diagnostics.
+     */
+    [[nodiscard]] std::size_t GetGarbageCount() const noexcept
+    {
+        return _garbageCount.load(std::memory_order_relaxed);
+    }
+
+    private:
+    struct Retired {
+        void*         ptr;
+        Deleter       deleter;
+        std::uint64_t epoch;
+    };
+
+    ThreadRecord* GetRecord();
+    void          Unpin(ThreadRecord* record) noexcept;
+    bool          TryAdvance();
+    std::size_t   Reclaim(std::vector<Retired>& garbage);
+    std::size_t   ReclaimOrphans();
+
+    const Options              _options;
+    const std::uint64_t        _id;
+    std::atomic<std::uint64_t> _epoch = 0;
+    std::atomic<ThreadRecord*> _records = nullptr;
+    std::atomic<std::size_t>   _garbageCount = 0;
+    std::mutex                 _mutex;
+    std::vector<Retired>       _orphans; /**< Garbage of exited threads, guarded by _mutex. */
+};
+
+} // namespace Netero
@@ -0,0 +1,192 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file IoService.hpp
+ * @brief Asynchronous file I/O service.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Netero {
+
+class IoBackend;
+
+/**
+ * @brief Asynchronous file read and write service.
+ * Requests are queued to the kernel through io_uring on linux, on other platforms
+ * or when io_uring is not available (old kernel, seccomp) a small pool of I/O threads
+ * perform blocking pread/pwrite calls instead. In both cases the calling thread
+ * never block on the transfer itself.
+ * Completion callbacks are invoked from the service completion thread, they must be short
+ * and must not block, dispatch heavy work to another thread.
+ * The result given to a callback is the number of bytes transferred, or a negative
+ * system error code (-errno on POSIX, -GetLastError() on windows).
+ */
+class IoService {
+    public:
+    enum class Backend {
+        AUTO,        /**< io_uring if available, THREAD_POOL otherwise. */
+        IO_URING,    /**< Linux io_uring, fall back to THREAD_POOL if the kernel refuse it. */
+        THREAD_POOL, /**< Blocking calls performed by dedicated I/O threads. */
+    };
+
+    enum class Operation { READ, WRITE };
+
+#if defined(_WIN32)
+    using FileHandle = void*;
+#else
+    using FileHandle = int;
+#endif
+
+    /**
+     * @brief Completion callback, receive the transferred size or a negative error code.
+     */
+    using CompletionCallback = std::function<void(std::int64_t)>;
+
+    /**
+     * @brief A single read or write request.
+     */
+    struct Request {
+        Operation          operation;
+        FileHandle         file;
+        void*              buffer;
+        std::size_t        size;
+        std::uint64_t      offset;
+        CompletionCallback callback;
+        int registeredBuffer = -1; /**< Index given by RegisterBuffers, -1 for a plain buffer. */
+    };
+
+    /**
+     * @brief Memory region to register with RegisterBuffers.
+     */
+    struct Buffer {
+        void*       data;
+        std::size_t size;
+    };
+
+    /**
+     * @brief Construct a service with the AUTO backend and a queue depth of 256.
+     */
+    IoService();
+
+    /**
+     * @param backend to use, see Backend.
+     * @param queueDepth maximum number of in flight requests, Submit block beyond it.
+     * @param threads number of I/O threads of the THREAD_POOL backend.
+     */
+    explicit IoService(Backend backend, unsigned queueDepth = 256, unsigned threads = 2);
+    IoService(const IoService&) = delete;
+    IoService& operator=(const IoService&) = delete;
+
+    /**
+     * @brief Wait for every pending request then stop the service.
+     */
+    ~IoService();
+
+    /**
+     * @brief Return the backend effectively in use.
+     */
+    [[nodiscard]] Backend GetBackend() const;
+
+    /**
+     * @brief Register buffers with the kernel.
+     * Registered buffers are pinned once instead of at every request, this save
+     * a page walk per transfer. A request use a registered buffer by setting
+     * registeredBuffer to its index, the request buffer must lie inside it.
+     * Any previous registration is replaced, no request may be in flight.
+     * @return false if the kernel refused the registration.
+     */
+    bool RegisterBuffers(const std::vector<Buffer>& buffers);
+
+    /**
+     * @brief Release the registered buffers.
+     */
+    void UnregisterBuffers();
+
+    /**
+     * @brief Submit a single request.
+     */
+    void Submit(Request request);
+
+    /**
+     * @brief Submit a batch of requests, on io_uring the batch cost a single system call.
+     * Batches larger than the queue depth are submitted by slices of queue depth requests,
+     * each waiting for room. The requests are moved from.
+     */
+    void Submit(std::vector<Request>& requests);
+
+    /**
+     * @brief Read asynchronously, the callback is called on completion.
+     */
+    void Read(FileHandle         file,
+              void*              buffer,
+              std::size_t        size,
+              std::uint64_t      offset,
+              CompletionCallback callback);
+
+    /**
+     * @brief Write asynchronously, the callback is called on completion.
+     */
+    void Write(FileHandle         file,
+               const void*        buffer,
+               std::size_t        size,
+               std::uint64_t      offset,
+               CompletionCallback callback);
+
+    /**
+     * @brief Read asynchronously.
+     * @return A future holding the transferred size or a negative error code.
+     */
+    std::future<std::int64_t>
+    Read(FileHandle file, void* buffer, std::size_t size, std::uint64_t offset);
+
+    /**
+     * @brief Write asynchronously.
+     * @return A future holding the transferred size or a negative error code.
+     */
+    std::future<std::int64_t>
+    Write(FileHandle file, const void* buffer, std::size_t size, std::uint64_t offset);
+
+    /**
+     * @brief Return the number of submitted requests not completed yet.
+     */
+    [[nodiscard]] std::size_t GetPendingCount() const;
+
+    /**
+     * @brief Block until every submitted request is completed.
+     */
+    void WaitIdle();
+
+    /**
+     * @brief Open a file for the service.
+     * @param write open for read and write, the file is created if needed.
+     * @return An invalid handle on error, see IsValid.
+     */
+    static FileHandle OpenFile(const std::string& path, bool write = false);
+
+    /**
+     * @brief Close a file opened by OpenFile.
+     */
+    static void CloseFile(FileHandle file);
+
+    /**
+     * @brief Check a handle returned by OpenFile.
+     */
+    static bool IsValid(FileHandle file);
+
+    private:
+    std::unique_ptr<IoBackend> _backend;
+};
+
+} // namespace Netero
@@ -0,0 +1,162 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file JobSystem.hpp
+ * @brief Work stealing job scheduler.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Netero {
+
+class JobCounter;
+
+/**
+ * @brief Work stealing job scheduler.
+ * Each worker own a Chase-Lev deque, jobs spawned from a worker are pushed on its
+ * own deque and executed LIFO while idle workers steal the oldest jobs of the
+ * others. Jobs run from any other thread go through a shared injection queue.
+ * Waiting on a counter never block a core: the waiting thread execute pending jobs
+ * until the counter is done.
+ * @code
+ * Netero::JobCounter counter;
+ * auto& jobs = Netero::JobSystem::GetDefault();
+ * for (auto& chunk : chunks) {
+ *     jobs.Run([&chunk]() { chunk.Process(); }, &counter);
+ * }
+ * jobs.WaitFor(counter);
+ * @endcode
+ * @warning Jobs must not throw.
+ */
+class JobSystem {
+    public:
+    using JobFunction = std::function<void()>;
+
+    struct Options {
+        unsigned    workerCount = 0;     /**< 0 for one worker per cpu, minus the caller. */
+        bool        pinWorkers = false;  /**< Pin each worker on a cpu, distinct cores first. */
+        std::size_t dequeCapacity = 256; /**< Initial capacity of the worker deques. */
+    };
+
+    /**
+     * @brief Start a scheduler with the default options.
+     */
+    JobSystem();
+    explicit JobSystem(const Options& options);
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Execute the remaining queued jobs then stop the workers.
+     */
+    ~JobSystem();
+
+    /**
+     * @brief Process wide scheduler, started on first use with the default options.
+     */
+    static JobSystem& GetDefault();
+
+    /**
+     * @brief Schedule a job.
+     * @param counter optional, incremented now and decremented once the job returned.
+     */
+    void Run(JobFunction job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Schedule a job once every job of dependency is done.
+     * The job is scheduled immediately if the dependency is already done.
+     * @param counter optional, incremented now and decremented once the job returned.
+     */
+    void RunAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Execute pending jobs until every job of the counter is done.
+     * Can be called from a job, the worker keep executing other jobs meanwhile.
+     */
+    void WaitFor(JobCounter& counter);
+
+    /**
+     * @brief Execute a single pending job from the calling thread.
+     * @return false if no job was found.
+     */
+    bool RunPendingJob();
+
+    [[nodiscard]] unsigned GetWorkerCount() const;
+
+    /**
+     * @brief Return the index of the calling worker, or -1 if the calling thread is not
+     * a worker of this scheduler.
+     */
+    [[nodiscard]] int GetCurrentWorkerIndex() const;
+
+    private:
+    friend class JobCounter;
+    struct Job;
+    struct Worker;
+
+    void Schedule(Job* job);
+    bool TakeJob(Job*& job);
+    void Execute(Job* job);
+    void Complete(JobCounter& counter);
+    void WorkerMain(unsigned index);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::mutex                           _injectionMutex;
+    std::deque<Job*>                     _injection;
+    std::atomic<std::int64_t>            _queuedCount = 0;
+    std::atomic<unsigned>                _sleepingCount = 0;
+    std::mutex                           _sleepMutex;
+    std::condition_variable              _sleepCondition;
+    std::atomic<bool>                    _stop = false;
+};
+
+/**
+ * @brief Track the completion of a group of jobs.
+ * Every job run with a counter increment it, the counter is decremented once the job
+ * returned. A counter reaching zero release the jobs depending on it (see RunAfter).
+ * A counter can be reused once done.
+ * @warning Wait on the counter with JobSystem::WaitFor before destroying it.
+ */
+class JobCounter {
+    public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /**
+     * @brief Return the number of unfinished jobs.
+     */
+    [[nodiscard]] std::size_t GetValue() const
+    {
+        return static_cast<std::size_t>(_value.load(std::memory_order_acquire) / 2);
+    }
+
+    [[nodiscard]] bool IsDone() const { return _value.load(std::memory_order_acquire) == 0; }
+
+    private:
+    friend class JobSystem;
+
+    /**
+     * Twice the number of unfinished jobs, the low bit is set while the last job
+     * release the continuations.
+     */
+    std::atomic<std::int64_t>    _value = 0;
+    std::mutex                   _mutex;
+    std::condition_variable      _condition;
+    std::vector<JobSystem::Job*> _continuations;
+};
+
+} // namespace Netero
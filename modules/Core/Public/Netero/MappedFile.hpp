@@ -0,0 +1,119 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file MappedFile.hpp
+ * @brief Memory mapped file with access pattern hints.
+ */
+
+#include <cstddef>
+#include <string>
+
+#include <Netero/Os.hpp>
+
+namespace Netero::Os {
+
+/**
+ * @brief RAII memory mapping of a file.
+ * The content of the file is accessed in place through GetData(), there is no copy
+ * to an intermediate buffer, pages are loaded by the kernel on first access or ahead
+ * of time with the WILL_NEED hint or the populate option.
+ * @code
+ * Netero::Os::MappedFile file;
+ * if (file.Open("asset.bin") == Netero::Os::RtCode::SUCCESS) {
+ *     file.Advise(Netero::Os::MappedFile::Access::SEQUENTIAL);
+ *     parse(file.GetData(), file.GetSize());
+ * }
+ * @endcode
+ */
+class MappedFile {
+    public:
+    enum class Mode {
+        READ_ONLY, /**< Shared read only mapping. */
+        READ_WRITE /**< Shared writable mapping, writes are propagated to the file. */
+    };
+
+    enum class Access {
+        NORMAL,     /**< Default kernel read ahead. */
+        SEQUENTIAL, /**< Aggressive read ahead, pages may be freed soon after being read. */
+        RANDOM,     /**< No read ahead. */
+        WILL_NEED,  /**< Start loading the pages in background. */
+        DONT_NEED   /**< The pages will not be accessed soon. */
+    };
+
+    struct Options {
+        Mode        mode = Mode::READ_ONLY;
+        bool        populate = false;  /**< Fault the whole mapping at open (MAP_POPULATE). */
+        bool        hugePages = false; /**< Align the mapping on 2MiB and request huge pages. */
+        bool        create = false;    /**< READ_WRITE only, create the file if it does not exist. */
+        std::size_t size = 0; /**< READ_WRITE only, resize the file if not 0. Ignored otherwise. */
+    };
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    /**
+     * @brief Map a file in memory.
+     * Any previous mapping held by the object is released first.
+     * An empty file is mapped successfully with a null data pointer.
+     */
+    RtCode Open(const std::string& path, const Options& options);
+
+    /**
+     * @brief Map a file in memory, read only.
+     */
+    RtCode Open(const std::string& path) { return Open(path, Options()); }
+
+    /**
+     * @brief Unmap the file, pending writes are left to the kernel.
+     */
+    void Close();
+
+    /**
+     * @brief Give the kernel an access pattern hint (madvise).
+     * @param offset of the range in byte.
+     * @param length of the range in byte, 0 meaning until the end of the mapping.
+     */
+    RtCode Advise(Access access, std::size_t offset = 0, std::size_t length = 0);
+
+    /**
+     * @brief Write back the dirty pages to the file.
+     * @param async if true the write back is scheduled and the call return immediately.
+     */
+    RtCode Flush(bool async = false);
+
+    [[nodiscard]] bool             IsOpen() const noexcept { return _isOpen; }
+    [[nodiscard]] std::size_t      GetSize() const noexcept { return _size; }
+    [[nodiscard]] Mode             GetMode() const noexcept { return _mode; }
+    [[nodiscard]] const std::byte* GetData() const noexcept { return _data; }
+
+    /**
+     * @brief Writable view of the mapping.
+     * @warning Writing in a READ_ONLY mapping raise a segmentation fault.
+     */
+    [[nodiscard]] std::byte* GetData() noexcept { return _data; }
+
+    private:
+    std::byte*  _data = nullptr;
+    std::size_t _size = 0;
+    void*       _mappingBase = nullptr; /**< Start of the OS mapping, may differ from _data. */
+    std::size_t _mappingSize = 0;
+    Mode        _mode = Mode::READ_ONLY;
+    bool        _isOpen = false;
+#if defined(_WIN32)
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#else
+    int _fileDescriptor = -1;
+#endif
+};
+
+} // namespace Netero::Os
@@ -0,0 +1,311 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Metrics.hpp
+ * @brief Counters, gauges and latency histograms.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Netero/Clock.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Netero::Metrics {
+
+namespace Detail {
+
+    constexpr std::size_t shardCount = 16;
+
+    /**
+     * @brief Shard of the calling thread, threads are spread round robin over the shards.
+     */
+    std::size_t GetShardIndex() noexcept;
+
+    inline unsigned GetMostSignificantBit(std::uint64_t value) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+
+    struct alignas(64) PaddedCounter {
+        std::atomic<std::uint64_t> value = 0;
+    };
+
+} // namespace Detail
+
+/**
+ * @brief Monotonic counter.
+ * Add is wait free, each thread increment its own shard, the shards are summed on read.
+ */
+class Counter {
+    public:
+    void Add(std::uint64_t value = 1) noexcept
+    {
+        _shards[Detail::GetShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t GetValue() const noexcept
+    {
+        std::uint64_t value = 0;
+        for (const auto& shard : _shards) {
+            value += shard.value.load(std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    void Reset() noexcept
+    {
+        for (auto& shard : _shards) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    private:
+    std::array<Detail::PaddedCounter, Detail::shardCount> _shards;
+};
+
+/**
+ * @brief Instantaneous value, a fill level or a queue depth for instance.
+ */
+class Gauge {
+    public:
+    void Set(std::int64_t value) noexcept { _value.store(value, std::memory_order_relaxed); }
+    void Add(std::int64_t value) noexcept { _value.fetch_add(value, std::memory_order_relaxed); }
+    void Sub(std::int64_t value) noexcept { _value.fetch_sub(value, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::int64_t GetValue() const noexcept
+    {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+    private:
+    alignas(64) std::atomic<std::int64_t> _value = 0;
+};
+
+/**
+ * @brief Merged content of a histogram.
+ */
+struct HistogramSnapshot {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t min = 0; /**< Lower bound of the lowest populated bucket. */
+    std::uint64_t max = 0; /**< Upper bound of the highest populated bucket. */
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> buckets; /**< Upper bound, count. */
+
+    [[nodiscard]] double GetMean() const noexcept;
+
+    /**
+     * @brief Value under which lie percentile % of the recorded values.
+     * @param percentile in [0, 100].
+     * @return The upper bound of the bucket holding the percentile.
+     */
+    [[nodiscard]] std::uint64_t GetPercentile(double percentile) const noexcept;
+};
+
+/**
+ * @brief Log linear histogram, in the style of HdrHistogram.
+ * Values below 32 have their own bucket, above each power of two is split in 16
+ * linear buckets: the relative error is bounded by 6.25% over the full 64 bits range.
+ * Record is wait free, each thread increment its own shard, the shards are merged on read.
+ * Durations are recorded in nanoseconds by convention, names end with _ns.
+ */
+class Histogram {
+    public:
+    static constexpr unsigned    subBucketBits = 4;
+    static constexpr std::size_t subBucketCount = std::size_t(1) << subBucketBits;
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+    ~Histogram();
+
+    static std::size_t GetBucketIndex(std::uint64_t value) noexcept
+    {
+        if (value < 2 * subBucketCount) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned shift = Detail::GetMostSignificantBit(value) - subBucketBits;
+        return (shift * subBucketCount) + static_cast<std::size_t>(value >> shift);
+    }
+
+    static std::uint64_t GetBucketLowerBound(std::size_t index) noexcept
+    {
+        if (index < 2 * subBucketCount) {
+            return index;
+        }
+        const std::size_t shift = index / subBucketCount - 1;
+        return static_cast<std::uint64_t>(index % subBucketCount + subBucketCount) << shift;
+    }
+
+    static std::uint64_t GetBucketUpperBound(std::size_t index) noexcept
+    {
+        return index + 1 < bucketCount ? GetBucketLowerBound(index + 1) - 1 : UINT64_MAX;
+    }
+
+    void Record(std::uint64_t value) noexcept
+    {
+        Shard* shard = _shards[Detail::GetShardIndex()].load(std::memory_order_acquire);
+        if (!shard) {
+            shard = AllocateShard(Detail::GetShardIndex());
+        }
+        shard->counts[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        shard->sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void RecordDuration(Clock::duration duration) noexcept
+    {
+        Record(duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0);
+    }
+
+    [[nodiscard]] HistogramSnapshot GetSnapshot() const;
+    void                            Reset() noexcept;
+
+    private:
+    struct Shard {
+        std::array<std::atomic<std::uint64_t>, bucketCount> counts {};
+        std::atomic<std::uint64_t>                          sum = 0;
+    };
+
+    /**
+     * @brief Allocate the shard on its first use, the only non wait free path.
+     */
+    Shard* AllocateShard(std::size_t index) noexcept;
+
+    std::array<std::atomic<Shard*>, Detail::shardCount> _shards {};
+};
+
+/**
+ * @brief Histogram of the last capacity values recorded, the oldest being forgotten first.
+ * Meant for per frame measures, the snapshot describe the recent frames where a Histogram
+ * accumulate since its creation. Single writer, not thread safe.
+ */
+class RollingHistogram {
+    public:
+    explicit RollingHistogram(std::size_t capacity = 128);
+
+    void Record(std::uint64_t value);
+
+    void RecordDuration(Clock::duration duration)
+    {
+        Record(duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0);
+    }
+
+    /**
+     * @brief Most recent value, 0 if nothing is recorded.
+     */
+    [[nodiscard]] std::uint64_t GetLast() const noexcept;
+
+    /**
+     * @brief Values kept, up to the capacity.
+     */
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _values.size(); }
+    [[nodiscard]] std::size_t GetCapacity() const noexcept { return _capacity; }
+
+    /**
+     * @brief Keep the most recent values fitting in the new capacity, at least 1.
+     */
+    void SetCapacity(std::size_t capacity);
+
+    [[nodiscard]] HistogramSnapshot GetSnapshot() const;
+    void                            Reset() noexcept;
+
+    private:
+    std::vector<std::uint64_t> _values; /**< Ring once full, _next is the oldest value. */
+    std::size_t                _capacity;
+    std::size_t                _next = 0;
+};
+
+/**
+ * @brief Record the lifetime of the object in a histogram.
+ */
+class ScopedTimer {
+    public:
+    explicit ScopedTimer(Histogram& histogram) noexcept
+        : _histogram(histogram), _start(Clock::now())
+    {
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer() { _histogram.RecordDuration(Clock::now() - _start); }
+
+    private:
+    Histogram&              _histogram;
+    const Clock::time_point _start;
+};
+
+/**
+ * @brief Values of every metric of a registry at a point in time.
+ */
+struct Snapshot {
+    std::map<std::string, std::uint64_t>     counters;
+    std::map<std::string, std::int64_t>      gauges;
+    std::map<std::string, HistogramSnapshot> histograms;
+
+    /**
+     * @brief One metric per line, histograms as count, mean and percentiles.
+     */
+    [[nodiscard]] std::string ToText() const;
+
+    /**
+     * @brief JSON object, histograms include their populated buckets.
+     */
+    [[nodiscard]] std::string ToJson() const;
+};
+
+/**
+ * @brief Named metrics.
+ * Lookups take a lock, users are expected to keep the returned reference, which
+ * stay valid for the lifetime of the registry.
+ * @code
+ * static auto& frames = Netero::Metrics::Registry::GetDefault().GetCounter("gfx.frames");
+ * frames.Add();
+ * @endcode
+ */
+class Registry {
+    public:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    /**
+     * @brief Process wide registry, never destroyed.
+     */
+    static Registry& GetDefault();
+
+    Counter&   GetCounter(const std::string& name);
+    Gauge&     GetGauge(const std::string& name);
+    Histogram& GetHistogram(const std::string& name);
+
+    [[nodiscard]] Snapshot TakeSnapshot() const;
+
+    private:
+    mutable std::mutex                                _mutex;
+    std::map<std::string, std::unique_ptr<Counter>>   _counters;
+    std::map<std::string, std::unique_ptr<Gauge>>     _gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> _histograms;
+};
+
+} // namespace Netero::Metrics
@@ -7,10 +7,14 @@
 
 /**
  * @file os.hpp
- * @brief Operating System resources lock and standard path getters.
+ * @brief Operating System resources lock, standard path getters and thread scheduling helpers.
  */
 
+#include <bitset>
+#include <cstddef>
 #include <string>
+#include <thread>
+#include <vector>
 
 /**
  * Namespace related to os specific resources.
@@ -73,4 +77,128 @@ int GetSystemResourcesLocks();
  */
 bool IsSystemLibraryHolder();
 
+/**
+ * @brief Return code of the thread scheduling, memory locking and file mapping helpers.
+ */
+enum class RtCode {
+    SUCCESS,           /**< The request has been applied. */
+    PERMISSION_DENIED, /**< The process lacks the privilege (CAP_SYS_NICE, RLIMIT_RTPRIO...). */
+    INVALID_ARGUMENT,  /**< Empty mask, unknown cpu or priority out of range. */
+    NOT_FOUND,         /**< The requested file or resource does not exist. */
+    NOT_SUPPORTED,     /**< The platform does not provide this feature. */
+    SYSTEM_ERROR       /**< Any other error reported by the operating system. */
+};
+
+/**
+ * @brief Human readable description of a RtCode.
+ */
+const char* RtCodeToString(RtCode code);
+
+constexpr std::size_t MaxCpuCount = 1024; /**< Maximum number of cpu a CpuMask can address. */
+
+/**
+ * @brief Set of logical cpus, bit n set means the thread may run on cpu n.
+ */
+using CpuMask = std::bitset<MaxCpuCount>;
+
+/**
+ * @brief Return the number of logical cpus available to the process.
+ */
+unsigned GetCpuCount();
+
+/**
+ * @brief Location of a logical cpu in the processor topology.
+ */
+struct CpuTopology {
+    unsigned cpu;     /**< Logical cpu index, as used by CpuMask. */
+    unsigned core;    /**< Physical core id, shared by the SMT siblings of a package. */
+    unsigned package; /**< Physical package (socket) id. */
+    unsigned node;    /**< NUMA node id. */
+};
+
+/**
+ * @brief Describe the logical cpus available to the process, sorted by cpu index.
+ * When the platform does not expose the topology every cpu is reported as its
+ * own core on package and node 0.
+ */
+std::vector<CpuTopology> GetCpuTopology();
+
+/**
+ * @brief Pin the calling thread to the cpus of the given mask.
+ * @return NOT_SUPPORTED on macOS, the kernel only accept affinity hints there.
+ */
+RtCode SetThreadAffinity(const CpuMask& mask);
+
+/**
+ * @brief Pin the given thread to the cpus of the given mask.
+ */
+RtCode SetThreadAffinity(std::thread& thread, const CpuMask& mask);
+
+/**
+ * @brief Retrieve the affinity mask of the calling thread.
+ */
+RtCode GetThreadAffinity(CpuMask& mask);
+
+/**
+ * @brief Retrieve the affinity mask of the given thread.
+ */
+RtCode GetThreadAffinity(std::thread& thread, CpuMask& mask);
+
+/**
+ * @brief Lowest priority accepted by SetThreadRealtimePriority.
+ */
+int GetRealtimePriorityMin();
+
+/**
+ * @brief Highest priority accepted by SetThreadRealtimePriority.
+ */
+int GetRealtimePriorityMax();
+
+/**
+ * @brief Switch the calling thread to the realtime FIFO scheduling policy.
+ * On linux this is SCHED_FIFO and require CAP_SYS_NICE or a sufficient RLIMIT_RTPRIO,
+ * on windows the thread is raised to THREAD_PRIORITY_TIME_CRITICAL.
+ * @return PERMISSION_DENIED if the process is not allowed to do so, the thread
+ * scheduling is then left untouched.
+ */
+RtCode SetThreadRealtimePriority(int priority);
+
+/**
+ * @brief Switch the given thread to the realtime FIFO scheduling policy.
+ */
+RtCode SetThreadRealtimePriority(std::thread& thread, int priority);
+
+/**
+ * @brief Bring the calling thread back to the default time sharing policy.
+ */
+RtCode ResetThreadPriority();
+
+/**
+ * @brief Bring the given thread back to the default time sharing policy.
+ */
+RtCode ResetThreadPriority(std::thread& thread);
+
+/**
+ * @brief Retrieve the realtime priority of the calling thread.
+ * @param priority is set to 0 if the thread does not run under a realtime policy.
+ */
+RtCode GetThreadRealtimePriority(int& priority);
+
+/**
+ * @brief Retrieve the realtime priority of the given thread.
+ */
+RtCode GetThreadRealtimePriority(std::thread& thread, int& priority);
+
+/**
+ * @brief Lock the current and future pages of the process in RAM (mlockall).
+ * This prevent page faults on realtime paths. Without privilege the call is
+ * bounded by RLIMIT_MEMLOCK and usually return PERMISSION_DENIED.
+ */
+RtCode LockProcessMemory();
+
+/**
+ * @brief Release a previous LockProcessMemory.
+ */
+RtCode UnlockProcessMemory();
+
 } // namespace Netero::Os
@@ -0,0 +1,527 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Parallel.hpp
+ * @brief Data parallel algorithms running on the JobSystem.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Netero/JobSystem.hpp>
+
+namespace Netero {
+
+namespace Detail {
+
+    constexpr std::size_t CacheLineSize = 64;
+
+    /**
+     * @brief Value alone on its cache line, written by a single thread.
+     */
+    template<typename T>
+    struct alignas(CacheLineSize) PaddedValue {
+        T value;
+    };
+
+    /**
+     * @brief Default grain, a few chunks per thread so that stealing can balance the load.
+     */
+    inline std::size_t GetDefaultGrain(std::size_t count, const JobSystem& jobs)
+    {
+        const std::size_t chunks = (jobs.GetWorkerCount() + 1) * 4;
+        return std::max<std::size_t>(1, (count + chunks - 1) / chunks);
+    }
+
+    /**
+     * @brief Round a grain up to a whole number of cache lines of T, chunks written
+     * by different threads then never share a line.
+     */
+    template<typename T>
+    std::size_t AlignGrain(std::size_t grain)
+    {
+        constexpr std::size_t perLine =
+            sizeof(T) >= CacheLineSize ? 1 : CacheLineSize / sizeof(T);
+        return (grain + perLine - 1) / perLine * perLine;
+    }
+
+    /**
+     * @brief Recursively split the chunks [first, last) in halves.
+     * The upper half is pushed on the worker deque and left to thieves, the lower half
+     * is split further by the current thread. Thieves therefore take big contiguous
+     * blocks and every thread keep walking memory sequentially.
+     */
+    template<typename F>
+    void SplitChunks(JobSystem&  jobs,
+                     JobCounter& counter,
+                     std::size_t first,
+                     std::size_t last,
+                     F&          fn)
+    {
+        while (last - first > 1) {
+            const std::size_t middle = first + (last - first) / 2;
+            jobs.Run(
+                [&jobs, &counter, middle, last, &fn]() {
+                    SplitChunks(jobs, counter, middle, last, fn);
+                },
+                &counter);
+            last = middle;
+        }
+        fn(first);
+    }
+
+    /**
+     * @brief Call fn(chunkIndex) for every chunk in parallel and wait for completion.
+     */
+    template<typename F>
+    void ForEachChunk(JobSystem& jobs, std::size_t chunkCount, F&& fn)
+    {
+        if (chunkCount == 0) {
+            return;
+        }
+        if (chunkCount == 1) {
+            fn(std::size_t(0));
+            return;
+        }
+        JobCounter counter;
+        SplitChunks(jobs, counter, 0, chunkCount, fn);
+        jobs.WaitFor(counter);
+    }
+
+    /**
+     * @brief Stable merge of two sorted runs, split between jobs while bigger than grain.
+     */
+    template<typename InputIt, typename OutputIt, typename Compare>
+    void ParallelMerge(JobSystem&  jobs,
+                       JobCounter& counter,
+                       InputIt     first1,
+                       InputIt     last1,
+                       InputIt     first2,
+                       InputIt     last2,
+                       OutputIt    out,
+                       Compare&    comp,
+                       std::size_t grain)
+    {
+        const auto size1 = last1 - first1;
+        const auto size2 = last2 - first2;
+        if (static_cast<std::size_t>(size1 + size2) <= grain) {
+            std::merge(std::make_move_iterator(first1),
+                       std::make_move_iterator(last1),
+                       std::make_move_iterator(first2),
+                       std::make_move_iterator(last2),
+                       out,
+                       comp);
+            return;
+        }
+        // Split the bigger run at its middle, the other one where the pivot would go.
+        // Elements of the first run stay before equal elements of the second one.
+        InputIt middle1;
+        InputIt middle2;
+        if (size1 >= size2) {
+            middle1 = first1 + size1 / 2;
+            middle2 = std::lower_bound(first2, last2, *middle1, comp);
+        }
+        else {
+            middle2 = first2 + size2 / 2;
+            middle1 = std::upper_bound(first1, last1, *middle2, comp);
+        }
+        OutputIt middleOut = out + (middle1 - first1) + (middle2 - first2);
+        jobs.Run(
+            [&jobs, &counter, middle1, last1, middle2, last2, middleOut, &comp, grain]() {
+                ParallelMerge(jobs,
+                              counter,
+                              middle1,
+                              last1,
+                              middle2,
+                              last2,
+                              middleOut,
+                              comp,
+                              grain);
+            },
+            &counter);
+        ParallelMerge(jobs, counter, first1, middle1, first2, middle2, out, comp, grain);
+    }
+
+} // namespace Detail
+
+/**
+ * @brief One value per thread of a job system, the scratch storage of parallel loops.
+ * Slot 0 belong to the threads that are not workers, the calling thread of a parallel
+ * loop, slot i + 1 to the worker i. Slots are cache line aligned so threads never share
+ * a line. Only one non worker thread may use the values at a time.
+ * @code
+ * Netero::PerWorker<std::vector<Contact>> contacts;
+ * Netero::ParallelFor(std::size_t(0), bodies.size(), [&](std::size_t idx) {
+ *     Collide(bodies[idx], contacts.Local());
+ * });
+ * contacts.ForEach([&](std::vector<Contact>& local) { Solve(local); });
+ * @endcode
+ */
+template<typename T>
+class PerWorker {
+    public:
+    explicit PerWorker(JobSystem& jobs = JobSystem::GetDefault())
+        : _jobs(jobs), _slots(jobs.GetWorkerCount() + 1)
+    {
+    }
+
+    PerWorker(JobSystem& jobs, const T& value)
+        : _jobs(jobs), _slots(jobs.GetWorkerCount() + 1, Slot { value })
+    {
+    }
+
+    /**
+     * @brief Value of the calling thread.
+     */
+    T& Local() noexcept { return _slots[_jobs.GetCurrentWorkerIndex() + 1].value; }
+
+    T&       operator[](std::size_t slot) noexcept { return _slots[slot].value; }
+    const T& operator[](std::size_t slot) const noexcept { return _slots[slot].value; }
+
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _slots.size(); }
+
+    /**
+     * @brief Call fn(value) for every slot, in slot order, from the calling thread.
+     */
+    template<typename F>
+    void ForEach(F&& fn)
+    {
+        for (auto& slot : _slots) {
+            fn(slot.value);
+        }
+    }
+
+    private:
+    struct alignas(Detail::CacheLineSize) Slot {
+        T value;
+    };
+
+    JobSystem&        _jobs;
+    std::vector<Slot> _slots;
+};
+
+/**
+ * @brief Call fn(first, last) on contiguous sub ranges of [begin, end) in parallel.
+ * The range is cut in chunks of grain indices, 0 letting the library choose. The calling
+ * thread take part in the work and the call return once every chunk is processed.
+ * @code
+ * auto integrate = [&](std::size_t first, std::size_t last) {
+ *     for (std::size_t idx = first; idx < last; ++idx) {
+ *         positions[idx] += velocities[idx] * dt;
+ *     }
+ * };
+ * Netero::ParallelForRange(std::size_t(0), positions.size(), integrate, 4096);
+ * @endcode
+ */
+template<typename Index, typename F>
+void ParallelForRange(Index       begin,
+                      Index       end,
+                      F&&         fn,
+                      std::size_t grain = 0,
+                      JobSystem&  jobs = JobSystem::GetDefault())
+{
+    static_assert(std::is_integral_v<Index>, "ParallelForRange require an integral index.");
+    if (begin >= end) {
+        return;
+    }
+    const auto count = static_cast<std::size_t>(end - begin);
+    grain = grain == 0 ? Detail::GetDefaultGrain(count, jobs) : grain;
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    Detail::ForEachChunk(jobs, chunkCount, [&](std::size_t chunk) {
+        const Index first = begin + static_cast<Index>(chunk * grain);
+        const Index last = chunk + 1 == chunkCount ? end : first + static_cast<Index>(grain);
+        fn(first, last);
+    });
+}
+
+/**
+ * @brief Call fn(index) for every index of [begin, end) in parallel.
+ * @param grain number of consecutive indices processed by a job, 0 letting the library choose.
+ */
+template<typename Index, typename F>
+void ParallelFor(Index       begin,
+                 Index       end,
+                 F&&         fn,
+                 std::size_t grain = 0,
+                 JobSystem&  jobs = JobSystem::GetDefault())
+{
+    ParallelForRange(
+        begin,
+        end,
+        [&fn](Index first, Index last) {
+            for (Index idx = first; idx < last; ++idx) {
+                fn(idx);
+            }
+        },
+        grain,
+        jobs);
+}
+
+/**
+ * @brief Parallel map reduce over [begin, end).
+ * map(first, last) compute the partial result of a chunk, reduce(a, b) combine two
+ * partial results. Partial results are combined in chunk order from identity, so a
+ * given grain always give the same result, even for non associative floating point sums.
+ */
+template<typename Index, typename T, typename Map, typename Reduce>
+T ParallelReduce(Index       begin,
+                 Index       end,
+                 T           identity,
+                 Map&&       map,
+                 Reduce&&    reduce,
+                 std::size_t grain = 0,
+                 JobSystem&  jobs = JobSystem::GetDefault())
+{
+    static_assert(std::is_integral_v<Index>, "ParallelReduce require an integral index.");
+    if (begin >= end) {
+        return identity;
+    }
+    const auto count = static_cast<std::size_t>(end - begin);
+    grain = grain == 0 ? Detail::GetDefaultGrain(count, jobs) : grain;
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    // Padded, partials of neighbour chunks are not packed in a line, nor in bits for bool.
+    std::vector<Detail::PaddedValue<T>> partials(chunkCount, Detail::PaddedValue<T> { identity });
+    Detail::ForEachChunk(jobs, chunkCount, [&](std::size_t chunk) {
+        const Index first = begin + static_cast<Index>(chunk * grain);
+        const Index last = chunk + 1 == chunkCount ? end : first + static_cast<Index>(grain);
+        partials[chunk].value = map(first, last);
+    });
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = reduce(std::move(result), std::move(partial.value));
+    }
+    return result;
+}
+
+/**
+ * @brief Parallel std::transform over random access iterators.
+ * Chunk boundaries are aligned on the cache lines of the output.
+ * @return Iterator past the last written element.
+ */
+template<typename InputIt, typename OutputIt, typename F>
+OutputIt ParallelTransform(InputIt     first,
+                           InputIt     last,
+                           OutputIt    out,
+                           F&&         fn,
+                           std::size_t grain = 0,
+                           JobSystem&  jobs = JobSystem::GetDefault())
+{
+    using Output = std::remove_reference_t<decltype(*out)>;
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    if (count == 0) {
+        return out;
+    }
+    grain = Detail::AlignGrain<Output>(grain == 0 ? Detail::GetDefaultGrain(count, jobs) : grain);
+    ParallelForRange(
+        std::size_t(0),
+        count,
+        [&](std::size_t begin, std::size_t end) {
+            std::transform(first + begin, first + end, out + begin, fn);
+        },
+        grain,
+        jobs);
+    return out + count;
+}
+
+/**
+ * @brief Parallel binary transform, out[i] = fn(first1[i], first2[i]).
+ */
+template<typename InputIt1,
+         typename InputIt2,
+         typename OutputIt,
+         typename F,
+         typename = std::enable_if_t<std::is_invocable_v<F&,
+                                                         decltype(*std::declval<InputIt1>()),
+                                                         decltype(*std::declval<InputIt2>())>>>
+OutputIt ParallelTransform(InputIt1    first1,
+                           InputIt1    last1,
+                           InputIt2    first2,
+                           OutputIt    out,
+                           F&&         fn,
+                           std::size_t grain = 0,
+                           JobSystem&  jobs = JobSystem::GetDefault())
+{
+    using Output = std::remove_reference_t<decltype(*out)>;
+    const auto count = static_cast<std::size_t>(std::distance(first1, last1));
+    if (count == 0) {
+        return out;
+    }
+    grain = Detail::AlignGrain<Output>(grain == 0 ? Detail::GetDefaultGrain(count, jobs) : grain);
+    ParallelForRange(
+        std::size_t(0),
+        count,
+        [&](std::size_t begin, std::size_t end) {
+            std::transform(first1 + begin, first1 + end, first2 + begin, out + begin, fn);
+        },
+        grain,
+        jobs);
+    return out + count;
+}
+
+/**
+ * @brief Stable parallel merge sort.
+ * Chunks are sorted in parallel with std::stable_sort then merged pairwise, large
+ * merges being split between threads. Use an intermediate buffer of the range size.
+ */
+template<typename RandomIt, typename Compare>
+void ParallelSort(RandomIt   first,
+                  RandomIt   last,
+                  Compare    comp,
+                  JobSystem& jobs = JobSystem::GetDefault())
+{
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr std::size_t minimumChunk = 2048;
+    const auto            count = static_cast<std::size_t>(last - first);
+    const std::size_t     grain = std::max(minimumChunk, Detail::GetDefaultGrain(count, jobs));
+    if (count <= grain) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+    std::size_t chunkCount = (count + grain - 1) / grain;
+    Detail::ForEachChunk(jobs, chunkCount, [&](std::size_t chunk) {
+        const auto begin = first + chunk * grain;
+        const auto end = chunk + 1 == chunkCount ? last : begin + grain;
+        std::stable_sort(begin, end, comp);
+    });
+
+    // Runs are merged back and forth between the range and the buffer.
+    std::vector<Value> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+    bool               inBuffer = true;
+    auto               mergeRuns = [&](auto source, auto destination, std::size_t width) {
+        JobCounter        counter;
+        const std::size_t pairCount = (count + 2 * width - 1) / (2 * width);
+        for (std::size_t pair = 0; pair < pairCount; ++pair) {
+            const std::size_t begin = pair * 2 * width;
+            const std::size_t middle = std::min(begin + width, count);
+            const std::size_t end = std::min(begin + 2 * width, count);
+            jobs.Run(
+                [&jobs, &counter, &comp, source, destination, begin, middle, end, grain]() {
+                    Detail::ParallelMerge(jobs,
+                                          counter,
+                                          source + begin,
+                                          source + middle,
+                                          source + middle,
+                                          source + end,
+                                          destination + begin,
+                                          comp,
+                                          grain);
+                },
+                &counter);
+        }
+        jobs.WaitFor(counter);
+    };
+    for (std::size_t width = grain; width < count; width *= 2) {
+        if (inBuffer) {
+            mergeRuns(buffer.begin(), first, width);
+        }
+        else {
+            mergeRuns(first, buffer.begin(), width);
+        }
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer) {
+        std::move(buffer.begin(), buffer.end(), first);
+    }
+}
+
+/**
+ * @brief Stable parallel merge sort in ascending order.
+ */
+template<typename RandomIt>
+void ParallelSort(RandomIt first, RandomIt last, JobSystem& jobs = JobSystem::GetDefault())
+{
+    ParallelSort(first, last, std::less<>(), jobs);
+}
+
+/**
+ * @brief Stable parallel LSD radix sort on an unsigned integer key.
+ * Each pass sort one byte of the key: every chunk build its histogram in parallel,
+ * the histograms are prefixed and every chunk scatter its elements in parallel.
+ * Passes where every key share the same byte are skipped.
+ * @param key functor returning the unsigned integer key of an element.
+ */
+template<typename RandomIt, typename KeyFn>
+void ParallelRadixSort(RandomIt   first,
+                       RandomIt   last,
+                       KeyFn      key,
+                       JobSystem& jobs = JobSystem::GetDefault())
+{
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = std::decay_t<decltype(key(*first))>;
+    static_assert(std::is_unsigned_v<Key>, "ParallelRadixSort require an unsigned integer key.");
+    constexpr std::size_t radix = 256;
+    constexpr std::size_t minimumChunk = 4096;
+    const auto            count = static_cast<std::size_t>(last - first);
+    if (count < 2) {
+        return;
+    }
+    const std::size_t grain = std::max(minimumChunk, Detail::GetDefaultGrain(count, jobs));
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+
+    std::vector<Value> values(std::make_move_iterator(first), std::make_move_iterator(last));
+    std::vector<Value> buffer(count);
+    std::vector<std::array<std::size_t, radix>> histograms(chunkCount);
+    Value* source = values.data();
+    Value* destination = buffer.data();
+    for (std::size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+        Detail::ForEachChunk(jobs, chunkCount, [&](std::size_t chunk) {
+            auto&             histogram = histograms[chunk];
+            const std::size_t end = std::min(count, (chunk + 1) * grain);
+            histogram.fill(0);
+            for (std::size_t idx = chunk * grain; idx < end; ++idx) {
+                histogram[(key(source[idx]) >> shift) & (radix - 1)] += 1;
+            }
+        });
+        // Turn the histograms into scatter offsets, digit major then chunk order.
+        std::size_t offset = 0;
+        bool        skip = false;
+        for (std::size_t digit = 0; digit < radix && !skip; ++digit) {
+            std::size_t total = 0;
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                total += histograms[chunk][digit];
+            }
+            skip = total == count;
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                const std::size_t size = histograms[chunk][digit];
+                histograms[chunk][digit] = offset;
+                offset += size;
+            }
+        }
+        if (skip) {
+            continue;
+        }
+        Detail::ForEachChunk(jobs, chunkCount, [&](std::size_t chunk) {
+            auto&             offsets = histograms[chunk];
+            const std::size_t end = std::min(count, (chunk + 1) * grain);
+            for (std::size_t idx = chunk * grain; idx < end; ++idx) {
+                destination[offsets[(key(source[idx]) >> shift) & (radix - 1)]++] =
+                    std::move(source[idx]);
+            }
+        });
+        std::swap(source, destination);
+    }
+    std::move(source, source + count, first);
+}
+
+/**
+ * @brief Stable parallel LSD radix sort of unsigned integers.
+ */
+template<typename RandomIt>
+void ParallelRadixSort(RandomIt first, RandomIt last, JobSystem& jobs = JobSystem::GetDefault())
+{
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    ParallelRadixSort(first, last, [](const Value& value) { return value; }, jobs);
+}
+
+} // namespace Netero
@@ -0,0 +1,154 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file PerfCounters.hpp
+ * @brief Hardware performance counters of the calling thread.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Netero {
+
+/**
+ * @brief Cycles, instructions, cache, branch and TLB misses of the calling thread,
+ * read through perf_event_open on Linux, user space only.
+ * A counter may be unavailable: other platforms, perf_event_paranoid too restrictive,
+ * a virtual machine without PMU... It then read as 0 and is flagged as such in the
+ * samples, callers are expected to check IsAvailable before reporting a value.
+ * @code
+ * Netero::PerfCounters counters;
+ * counters.Enable();
+ * Netero::PerfCounters::Sample sample;
+ * {
+ *     Netero::ScopedPerfCounters scope(counters, sample);
+ *     world.Update();
+ * }
+ * if (sample.IsAvailable(Netero::PerfCounters::Event::CYCLES)) {
+ *     LOG_INFO << "IPC " << sample.GetIpc() << std::endl;
+ * }
+ * @endcode
+ */
+class PerfCounters {
+    public:
+    enum class Event {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,  /**< Last level cache misses. */
+        BRANCH_MISSES, /**< Mispredicted branches. */
+        TLB_MISSES     /**< Data TLB read misses. */
+    };
+
+    static constexpr std::size_t eventCount = 5;
+
+    /**
+     * @brief Counter values, scaled when the kernel multiplexed the counters.
+     */
+    struct Sample {
+        std::array<std::uint64_t, eventCount> values {};
+        std::uint32_t                         availableMask = 0; /**< Bit per Event. */
+
+        [[nodiscard]] bool IsAvailable(Event event) const noexcept
+        {
+            return (availableMask >> static_cast<unsigned>(event)) & 1u;
+        }
+
+        [[nodiscard]] std::uint64_t Get(Event event) const noexcept
+        {
+            return values[static_cast<std::size_t>(event)];
+        }
+
+        /**
+         * @brief Instructions per cycle, 0 if one of the two is unavailable.
+         */
+        [[nodiscard]] double GetIpc() const noexcept
+        {
+            if (!IsAvailable(Event::CYCLES) || !IsAvailable(Event::INSTRUCTIONS)
+                || Get(Event::CYCLES) == 0) {
+                return 0.;
+            }
+            return static_cast<double>(Get(Event::INSTRUCTIONS))
+                / static_cast<double>(Get(Event::CYCLES));
+        }
+
+        /**
+         * @brief Difference of two reads of the same counters.
+         */
+        Sample operator-(const Sample& other) const noexcept
+        {
+            Sample result;
+            result.availableMask = availableMask & other.availableMask;
+            for (std::size_t idx = 0; idx < eventCount; ++idx) {
+                result.values[idx] = values[idx] > other.values[idx]
+                    ? values[idx] - other.values[idx]
+                    : 0;
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief Open the counters of the calling thread, disabled.
+     * Never throw, the counters that cannot be opened are left unavailable.
+     */
+    PerfCounters() noexcept;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    /**
+     * @brief true if at least one counter is available.
+     */
+    [[nodiscard]] bool IsAvailable() const noexcept { return _availableMask != 0; }
+    [[nodiscard]] bool IsAvailable(Event event) const noexcept
+    {
+        return (_availableMask >> static_cast<unsigned>(event)) & 1u;
+    }
+
+    void Enable() noexcept;
+    void Disable() noexcept;
+    void Reset() noexcept;
+
+    /**
+     * @brief Values accumulated while enabled since the last Reset.
+     * Only meaningful on the thread that opened the counters.
+     */
+    [[nodiscard]] Sample Read() const noexcept;
+
+    /**
+     * @brief Counters of the calling thread, opened and enabled on first use.
+     * Used by the profiler, the first call from a thread open the counters.
+     */
+    static PerfCounters& GetThreadCounters() noexcept;
+
+    private:
+    std::array<int, eventCount> _descriptors;
+    std::uint32_t               _availableMask = 0;
+};
+
+/**
+ * @brief Store in result the counters consumed during the lifetime of the object.
+ */
+class ScopedPerfCounters {
+    public:
+    ScopedPerfCounters(const PerfCounters& counters, PerfCounters::Sample& result) noexcept
+        : _counters(counters), _result(result), _begin(counters.Read())
+    {
+    }
+    ScopedPerfCounters(const ScopedPerfCounters&) = delete;
+    ScopedPerfCounters& operator=(const ScopedPerfCounters&) = delete;
+    ~ScopedPerfCounters() { _result = _counters.Read() - _begin; }
+
+    private:
+    const PerfCounters&        _counters;
+    PerfCounters::Sample&      _result;
+    const PerfCounters::Sample _begin;
+};
+
+} // namespace Netero
@@ -0,0 +1,159 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Profiler.hpp
+ * @brief Scoped hot path profiler with Chrome trace export.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <Netero/Clock.hpp>
+#include <Netero/PerfCounters.hpp>
+
+/**
+ * @brief Scopes are recorded only when the library is configured with NETERO_PROFILER=ON,
+ * the macros expand to nothing otherwise.
+ * @code
+ * void World::Update()
+ * {
+ *     NETERO_PROFILE_FUNCTION();
+ *     for (auto& system : _systems) {
+ *         NETERO_PROFILE_SCOPE("System");
+ *         system.second->exec();
+ *     }
+ * }
+ * @endcode
+ * The name must outlive the export, string literals are expected.
+ */
+#if defined(NETERO_PROFILER)
+#define NETERO_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NETERO_PROFILE_CONCAT(a, b)      NETERO_PROFILE_CONCAT_IMPL(a, b)
+#define NETERO_PROFILE_SCOPE(name) \
+    const ::Netero::Profiler::Scope NETERO_PROFILE_CONCAT(netero_profile_scope_, __LINE__)(name)
+#if defined(_MSC_VER)
+#define NETERO_PROFILE_FUNCTION() NETERO_PROFILE_SCOPE(__FUNCSIG__)
+#else
+#define NETERO_PROFILE_FUNCTION() NETERO_PROFILE_SCOPE(__PRETTY_FUNCTION__)
+#endif
+#else
+#define NETERO_PROFILE_SCOPE(name) ((void)0)
+#define NETERO_PROFILE_FUNCTION()  ((void)0)
+#endif
+
+namespace Netero::Profiler {
+
+/**
+ * @brief A completed scope, timestamps are Netero::Clock nanoseconds.
+ */
+struct Event {
+    const char*          name;
+    std::uint64_t        begin;
+    std::uint64_t        end;
+    PerfCounters::Sample counters; /**< Empty unless the counters are enabled. */
+};
+
+struct ThreadEvents {
+    std::uint32_t      thread; /**< Sequential id, in order of the first recorded scope. */
+    std::string        name;
+    std::vector<Event> events; /**< Oldest first. */
+};
+
+/**
+ * @brief Enable or disable the recording at runtime, enabled by default.
+ */
+void SetEnabled(bool enabled) noexcept;
+bool IsEnabled() noexcept;
+
+/**
+ * @brief Read the hardware counters of the thread around each scope, disabled by default.
+ * Cost a few system calls per scope, the counters of a thread are opened by its first
+ * counted scope. Unavailable counters are left out of the events, see PerfCounters.
+ */
+void SetCountersEnabled(bool enabled) noexcept;
+bool AreCountersEnabled() noexcept;
+
+/**
+ * @brief Capacity in events of the buffers of the threads recording their first scope
+ * from now, 65536 by default. Once full a buffer overwrite its oldest events.
+ */
+void SetBufferCapacity(std::size_t capacity) noexcept;
+
+/**
+ * @brief Name the calling thread in the exported traces.
+ */
+void SetThreadName(const std::string& name);
+
+/**
+ * @brief Append a completed scope to the calling thread buffer.
+ * Wait free, the first call from a thread allocate its buffer.
+ */
+void Record(const char*                 name,
+            Clock::time_point           begin,
+            Clock::time_point           end,
+            const PerfCounters::Sample& counters = PerfCounters::Sample()) noexcept;
+
+/**
+ * @brief Copy the events recorded so far by every thread, exited ones included.
+ * Safe to call while other threads are recording.
+ */
+std::vector<ThreadEvents> Collect();
+
+/**
+ * @brief Drop the recorded events.
+ */
+void Clear();
+
+/**
+ * @brief Write the recorded events as Chrome Trace Event JSON.
+ * Available counters and the IPC are written in the args of the events.
+ * The output can be loaded in chrome://tracing or in the Perfetto UI.
+ */
+void WriteChromeTrace(std::ostream& output);
+
+/**
+ * @return false if the file could not be written.
+ */
+bool WriteChromeTrace(const std::string& path);
+
+/**
+ * @brief Record the lifetime of the object, see NETERO_PROFILE_SCOPE.
+ */
+class Scope {
+    public:
+    explicit Scope(const char* name) noexcept
+        : _name(name),
+          _counting(AreCountersEnabled()),
+          _counters(_counting ? PerfCounters::GetThreadCounters().Read() : PerfCounters::Sample()),
+          _begin(Clock::now())
+    {
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope()
+    {
+        const Clock::time_point end = Clock::now();
+        if (_counting) {
+            Record(_name, _begin, end, PerfCounters::GetThreadCounters().Read() - _counters);
+        }
+        else {
+            Record(_name, _begin, end);
+        }
+    }
+
+    private:
+    const char*                _name;
+    const bool                 _counting;
+    const PerfCounters::Sample _counters;
+    const Clock::time_point    _begin;
+};
+
+} // namespace Netero::Profiler
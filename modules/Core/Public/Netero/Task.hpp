@@ -0,0 +1,519 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Task.hpp
+ * @brief C++20 coroutine task running on the JobSystem.
+ */
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "Netero/Task.hpp require C++20 coroutines."
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <Netero/IoService.hpp>
+#include <Netero/JobSystem.hpp>
+#include <Netero/TaskRuntime.hpp>
+
+namespace Netero {
+
+template<typename T = void>
+class Task;
+
+namespace Detail {
+
+    /**
+     * @brief Route the coroutine frames through the frame pool.
+     */
+    struct PooledFrame {
+        static void* operator new(std::size_t size) { return AllocateFrame(size); }
+        static void  operator delete(void* frame, std::size_t size) noexcept
+        {
+            DeallocateFrame(frame, size);
+        }
+    };
+
+    template<typename T>
+    using NonVoid = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    struct TaskPromiseBase: PooledFrame {
+        struct FinalAwaiter {
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+            {
+                auto continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter        final_suspend() const noexcept { return {}; }
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr      exception;
+    };
+
+    template<typename T>
+    struct TaskPromise: TaskPromiseBase {
+        Task<T> get_return_object() noexcept;
+
+        template<typename U>
+        void return_value(U&& value)
+        {
+            result.emplace(std::forward<U>(value));
+        }
+
+        T TakeResult()
+        {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            return std::move(*result);
+        }
+
+        std::optional<T> result;
+    };
+
+    template<>
+    struct TaskPromise<void>: TaskPromiseBase {
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        void TakeResult() const
+        {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+
+    /**
+     * @brief Eagerly started coroutine destroying itself on completion.
+     */
+    struct DetachedTask {
+        struct promise_type: PooledFrame {
+            DetachedTask        get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void               return_void() const noexcept {}
+            void               unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+} // namespace Detail
+
+/**
+ * @brief Lazily started coroutine producing a T.
+ * A task start when awaited, the awaiting coroutine is resumed once the task completes,
+ * exceptions are propagated to the awaiter. Use Spawn or SyncWait to start a task from
+ * regular code, ResumeOn to move a coroutine on the workers of a JobSystem.
+ * Frames come from a thread local pool, short tasks do not reach malloc.
+ * @code
+ * Netero::Task<std::vector<char>> LoadAsset(Netero::IoService& io, std::string path)
+ * {
+ *     co_await Netero::ResumeOn(Netero::JobSystem::GetDefault());
+ *     auto file = Netero::IoService::OpenFile(path);
+ *     std::vector<char> data(4096);
+ *     auto size = co_await Netero::ReadAsync(io, file, data.data(), data.size(), 0);
+ *     data.resize(size > 0 ? size : 0);
+ *     Netero::IoService::CloseFile(file);
+ *     co_return data;
+ * }
+ * @endcode
+ */
+template<typename T>
+class [[nodiscard]] Task {
+    public:
+    using promise_type = Detail::TaskPromise<T>;
+    using value_type = T;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle): _handle(handle) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept: _handle(std::exchange(other._handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() { Reset(); }
+
+    [[nodiscard]] bool IsValid() const noexcept { return static_cast<bool>(_handle); }
+    [[nodiscard]] bool IsDone() const noexcept { return _handle && _handle.done(); }
+
+    auto operator co_await() noexcept
+    {
+        struct Awaiter {
+            [[nodiscard]] bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().TakeResult(); }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        return Awaiter { _handle };
+    }
+
+    private:
+    void Reset()
+    {
+        if (_handle) {
+            _handle.destroy();
+            _handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+namespace Detail {
+
+    template<typename T>
+    Task<T> TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    /**
+     * @brief Resume the awaiting coroutine once count tasks arrived.
+     */
+    class WhenAllLatch {
+        public:
+        explicit WhenAllLatch(std::size_t count): _count(count + 1) {}
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            _awaiting = awaiting;
+            return _count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+        }
+
+        void await_resume() const
+        {
+            if (_exception) {
+                std::rethrow_exception(_exception);
+            }
+        }
+
+        void Arrive(std::exception_ptr exception)
+        {
+            if (exception) {
+                std::scoped_lock<std::mutex> lock(_exceptionMutex);
+                if (!_exception) {
+                    _exception = exception;
+                }
+            }
+            if (_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                _awaiting.resume();
+            }
+        }
+
+        private:
+        std::atomic<std::size_t> _count;
+        std::coroutine_handle<>  _awaiting;
+        std::mutex               _exceptionMutex;
+        std::exception_ptr       _exception;
+    };
+
+    template<typename T>
+    DetachedTask RunWhenAllChild(JobSystem&                 jobs,
+                                 Task<T>&                   task,
+                                 std::optional<NonVoid<T>>& slot,
+                                 WhenAllLatch&              latch);
+
+} // namespace Detail
+
+/**
+ * @brief Awaitable moving the awaiting coroutine on a worker of the given JobSystem.
+ */
+inline auto ResumeOn(JobSystem& jobs)
+{
+    struct Awaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+        void               await_suspend(std::coroutine_handle<> handle) const
+        {
+            jobs.Run([handle]() { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+
+        JobSystem& jobs;
+    };
+    return Awaiter { jobs };
+}
+
+/**
+ * @brief Awaitable suspending the awaiting coroutine for the given duration without
+ * blocking any thread. The coroutine is resumed on a worker of the JobSystem.
+ */
+template<typename Rep, typename Period>
+auto Delay(std::chrono::duration<Rep, Period> duration, JobSystem& jobs = JobSystem::GetDefault())
+{
+    struct Awaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return delay.count() <= 0; }
+        void               await_suspend(std::coroutine_handle<> handle) const
+        {
+            JobSystem* system = &jobs;
+            Detail::ScheduleTimer(delay, [system, handle]() {
+                system->Run([handle]() { handle.resume(); });
+            });
+        }
+        void await_resume() const noexcept {}
+
+        std::chrono::nanoseconds delay;
+        JobSystem&               jobs;
+    };
+    return Awaiter { std::chrono::duration_cast<std::chrono::nanoseconds>(duration), jobs };
+}
+
+namespace Detail {
+
+    /**
+     * @brief Awaitable submitting a single request to an IoService.
+     * The coroutine is resumed on a worker, not on the I/O completion thread.
+     */
+    struct IoAwaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            request.callback = [this, handle](std::int64_t value) {
+                result = value;
+                jobs.Run([handle]() { handle.resume(); });
+            };
+            io.Submit(std::move(request));
+        }
+
+        [[nodiscard]] std::int64_t await_resume() const noexcept { return result; }
+
+        IoService&         io;
+        JobSystem&         jobs;
+        IoService::Request request;
+        std::int64_t       result = 0;
+    };
+
+} // namespace Detail
+
+/**
+ * @brief Awaitable asynchronous read.
+ * @return The awaited value is the number of bytes read or a negative error code.
+ */
+inline Detail::IoAwaiter ReadAsync(IoService&            io,
+                                   IoService::FileHandle file,
+                                   void*                 buffer,
+                                   std::size_t           size,
+                                   std::uint64_t         offset,
+                                   JobSystem&            jobs = JobSystem::GetDefault())
+{
+    return { io, jobs, { IoService::Operation::READ, file, buffer, size, offset, {}, -1 } };
+}
+
+/**
+ * @brief Awaitable asynchronous write.
+ * @return The awaited value is the number of bytes written or a negative error code.
+ */
+inline Detail::IoAwaiter WriteAsync(IoService&            io,
+                                    IoService::FileHandle file,
+                                    const void*           buffer,
+                                    std::size_t           size,
+                                    std::uint64_t         offset,
+                                    JobSystem&            jobs = JobSystem::GetDefault())
+{
+    void* data = const_cast<void*>(buffer);
+    return { io, jobs, { IoService::Operation::WRITE, file, data, size, offset, {}, -1 } };
+}
+
+/**
+ * @brief Run every task concurrently on the JobSystem and wait for all of them.
+ * The first exception thrown by a task is rethrown once every task completed.
+ * @return A tuple of the results, void tasks giving std::monostate.
+ */
+template<typename... Ts>
+Task<std::tuple<Detail::NonVoid<Ts>...>> WhenAll(JobSystem& jobs, Task<Ts>... tasks)
+{
+    Detail::WhenAllLatch                              latch(sizeof...(Ts));
+    std::tuple<std::optional<Detail::NonVoid<Ts>>...> results;
+    std::apply(
+        [&](auto&... slots) { (Detail::RunWhenAllChild(jobs, tasks, slots, latch), ...); },
+        results);
+    co_await latch;
+    co_return std::apply([](auto&... slots) { return std::make_tuple(std::move(*slots)...); },
+                         results);
+}
+
+/**
+ * @brief Run every task concurrently on the default JobSystem and wait for all of them.
+ */
+template<typename... Ts>
+Task<std::tuple<Detail::NonVoid<Ts>...>> WhenAll(Task<Ts>... tasks)
+{
+    return WhenAll(JobSystem::GetDefault(), std::move(tasks)...);
+}
+
+/**
+ * @brief Run every task of the vector concurrently and wait for all of them.
+ * @return The results in the order of the tasks.
+ */
+template<typename T>
+Task<std::vector<Detail::NonVoid<T>>> WhenAll(std::vector<Task<T>> tasks,
+                                              JobSystem& jobs = JobSystem::GetDefault())
+{
+    Detail::WhenAllLatch                           latch(tasks.size());
+    std::vector<std::optional<Detail::NonVoid<T>>> slots(tasks.size());
+    for (std::size_t idx = 0; idx < tasks.size(); ++idx) {
+        Detail::RunWhenAllChild(jobs, tasks[idx], slots[idx], latch);
+    }
+    co_await latch;
+    std::vector<Detail::NonVoid<T>> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots) {
+        results.push_back(std::move(*slot));
+    }
+    co_return results;
+}
+
+namespace Detail {
+
+    template<typename T>
+    DetachedTask RunWhenAllChild(JobSystem&                 jobs,
+                                 Task<T>&                   task,
+                                 std::optional<NonVoid<T>>& slot,
+                                 WhenAllLatch&              latch)
+    {
+        co_await ResumeOn(jobs);
+        std::exception_ptr exception;
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                slot.emplace();
+            }
+            else {
+                slot.emplace(co_await task);
+            }
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        latch.Arrive(exception);
+    }
+
+    template<typename T>
+    DetachedTask RunSpawned(JobSystem& jobs, Task<T> task)
+    {
+        co_await ResumeOn(jobs);
+        co_await task;
+    }
+
+    template<typename T>
+    DetachedTask RunSyncWait(JobSystem&                 jobs,
+                             Task<T>&                   task,
+                             std::optional<NonVoid<T>>& slot,
+                             std::exception_ptr&        exception,
+                             std::mutex&                mutex,
+                             std::condition_variable&   condition,
+                             bool&                      done)
+    {
+        co_await ResumeOn(jobs);
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                slot.emplace();
+            }
+            else {
+                slot.emplace(co_await task);
+            }
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        std::scoped_lock<std::mutex> lock(mutex);
+        done = true;
+        condition.notify_all();
+    }
+
+} // namespace Detail
+
+/**
+ * @brief Start a task on the JobSystem without waiting for it.
+ * An exception escaping the task terminate the program.
+ */
+template<typename T>
+void Spawn(Task<T> task, JobSystem& jobs = JobSystem::GetDefault())
+{
+    Detail::RunSpawned(jobs, std::move(task));
+}
+
+/**
+ * @brief Run a task on the JobSystem and wait for its result.
+ * The calling thread execute pending jobs meanwhile, it must not be a coroutine.
+ */
+template<typename T>
+T SyncWait(Task<T> task, JobSystem& jobs = JobSystem::GetDefault())
+{
+    std::optional<Detail::NonVoid<T>> slot;
+    std::exception_ptr                exception;
+    std::mutex                        mutex;
+    std::condition_variable           condition;
+    bool                              done = false;
+    Detail::RunSyncWait(jobs, task, slot, exception, mutex, condition, done);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (done) {
+                break;
+            }
+        }
+        if (!jobs.RunPendingJob()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait_for(lock, std::chrono::microseconds(100), [&done]() { return done; });
+        }
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*slot);
+    }
+}
+
+} // namespace Netero
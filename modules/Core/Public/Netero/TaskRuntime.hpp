@@ -0,0 +1,36 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file TaskRuntime.hpp
+ * @brief Runtime support of Netero::Task, built with the library in C++17.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace Netero::Detail {
+
+/**
+ * @brief Allocate a coroutine frame from the calling thread pool.
+ * Frames up to 4KiB are recycled through thread local free lists, bigger ones
+ * go to the heap.
+ */
+void* AllocateFrame(std::size_t size);
+
+/**
+ * @brief Release a frame allocated by AllocateFrame, size must be the allocation size.
+ */
+void DeallocateFrame(void* frame, std::size_t size) noexcept;
+
+/**
+ * @brief Invoke callback once delay elapsed, from the default TimerWheel thread.
+ */
+void ScheduleTimer(std::chrono::nanoseconds delay, std::function<void()> callback);
+
+} // namespace Netero::Detail
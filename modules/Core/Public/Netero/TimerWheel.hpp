@@ -0,0 +1,156 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file TimerWheel.hpp
+ * @brief Hierarchical timing wheel.
+ */
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Netero/Clock.hpp>
+
+namespace Netero {
+
+/**
+ * @brief Hierarchical timing wheel, four levels of 256 slots.
+ * Schedule and Cancel are O(1): a timer is linked in the slot of the level matching
+ * its distance to the deadline and moved to a finer level when the wheel turn
+ * (cascade). Time advance by ticks of the wheel resolution, timers fire on the first
+ * tick at or past their deadline, never before it.
+ * Expired timers are collected under the lock and their callbacks invoked as a batch
+ * once the lock is released, a callback can therefore schedule or cancel timers.
+ * The wheel is either ticked manually, from a frame loop for instance, or by a
+ * dedicated thread sleeping until the next populated slot.
+ * @code
+ * Netero::TimerWheel timers;
+ * auto handle = timers.Schedule(std::chrono::seconds(2), []() { RescanDevices(); });
+ * // Each frame
+ * timers.Tick();
+ * @endcode
+ */
+class TimerWheel {
+    public:
+    using Callback = std::function<void()>;
+    using Duration = Clock::duration;
+    using TimePoint = Clock::time_point;
+
+    /**
+     * @brief Identify a scheduled timer, a stale handle never match a newer timer.
+     */
+    struct Handle {
+        std::uint32_t index = UINT32_MAX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool IsValid() const noexcept { return index != UINT32_MAX; }
+    };
+
+    struct Options {
+        Duration resolution = std::chrono::milliseconds(1); /**< Duration of a tick. */
+        bool     dedicatedThread = false;                   /**< Tick from an internal thread. */
+    };
+
+    /**
+     * @brief Manually ticked wheel with a resolution of 1ms.
+     */
+    TimerWheel();
+    explicit TimerWheel(const Options& options);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Stop the dedicated thread if any, pending timers are dropped.
+     */
+    ~TimerWheel();
+
+    /**
+     * @brief Process wide wheel with a 1ms resolution ticked by its own thread.
+     */
+    static TimerWheel& GetDefault();
+
+    /**
+     * @brief Fire callback once, after delay.
+     */
+    Handle Schedule(Duration delay, Callback callback);
+
+    /**
+     * @brief Fire callback every period, the first time after one period.
+     * Deadlines are computed from the previous deadline, a late tick does not drift.
+     */
+    Handle SchedulePeriodic(Duration period, Callback callback);
+
+    /**
+     * @brief Cancel a pending timer.
+     * @return false if the timer already fired or was cancelled.
+     * A callback already collected for execution may still run once.
+     */
+    bool Cancel(Handle handle);
+
+    [[nodiscard]] bool        IsPending(Handle handle) const;
+    [[nodiscard]] std::size_t GetPendingCount() const;
+    [[nodiscard]] Duration    GetResolution() const noexcept { return _resolution; }
+
+    /**
+     * @brief Advance the wheel up to now and fire the expired timers.
+     * @return The number of callbacks invoked.
+     */
+    std::size_t Tick();
+
+    /**
+     * @brief Advance the wheel up to the given time and fire the expired timers.
+     */
+    std::size_t Tick(TimePoint now);
+
+    private:
+    static constexpr unsigned      levelCount = 4;
+    static constexpr unsigned      levelBits = 8;
+    static constexpr std::uint32_t slotCount = 1u << levelBits;
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    struct Node {
+        Callback      callback;
+        std::uint64_t expiry = 0; /**< Deadline in ticks. */
+        std::uint64_t period = 0; /**< In ticks, 0 for one shot timers. */
+        std::uint32_t generation = 0;
+        std::uint32_t previous = none;
+        std::uint32_t next = none;
+        std::uint32_t slot = none; /**< level * slotCount + slot, none when not linked. */
+    };
+
+    Handle        Add(Duration delay, Duration period, Callback callback);
+    void          Link(std::uint32_t index);
+    void          Unlink(std::uint32_t index);
+    void          Release(std::uint32_t index);
+    void          Cascade(unsigned level);
+    std::uint64_t GetTicksUntilNextSlot() const;
+    void          Run();
+
+    const Duration  _resolution;
+    const TimePoint _start;
+    std::uint64_t   _currentTick = 0;
+    std::size_t     _pendingCount = 0;
+
+    std::vector<Node>                                 _nodes;
+    std::uint32_t                                     _freeList = none;
+    std::array<std::uint32_t, levelCount * slotCount> _slots;
+    std::vector<Callback> _batch; /**< Expired callbacks, guarded by _tickMutex. */
+
+    mutable std::mutex      _mutex;
+    std::mutex              _tickMutex;
+    std::condition_variable _condition;
+    bool                    _stop = false;
+    std::thread             _thread;
+};
+
+} // namespace Netero
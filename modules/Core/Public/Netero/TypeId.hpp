@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <string_view>
 
 namespace Netero {
 
@@ -41,4 +42,30 @@ class TypeID {
 template<typename BaseClass>
 std::atomic<type_id> TypeID<BaseClass>::myBaseTypeCounter { 0 };
 
+/**
+ * @brief Human readable name of a type, without RTTI.
+ * Extracted from the compiler function signature, the spelling is compiler dependent.
+ */
+template<typename T>
+std::string_view GetTypeName() noexcept
+{
+#if defined(_MSC_VER)
+    const std::string_view signature = __FUNCSIG__;
+    const std::string_view prefix = "GetTypeName<";
+    const auto             first = signature.find(prefix) + prefix.size();
+    std::string_view       name = signature.substr(first, signature.rfind(">(void)") - first);
+    for (const std::string_view keyword : { "class ", "struct ", "enum " }) {
+        if (name.substr(0, keyword.size()) == keyword) {
+            name.remove_prefix(keyword.size());
+        }
+    }
+    return name;
+#else
+    const std::string_view signature = __PRETTY_FUNCTION__;
+    const std::string_view prefix = "T = ";
+    const auto             first = signature.find(prefix) + prefix.size();
+    return signature.substr(first, signature.find_first_of(";]", first) - first);
+#endif
+}
+
 } // namespace Netero
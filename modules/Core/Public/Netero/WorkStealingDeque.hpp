@@ -0,0 +1,172 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#pragma once
+
+/**
+ * @file WorkStealingDeque.hpp
+ * @brief Chase-Lev work stealing deque.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Netero {
+
+/**
+ * @brief Lock free single owner, multiple thieves deque (Chase-Lev).
+ * The owner thread push and pop at the bottom (LIFO, hot in cache), other threads
+ * steal from the top (FIFO, the oldest and usually biggest pieces of work).
+ * The buffer grow when full, previous buffers are kept alive until destruction
+ * since a thief may still be reading from them.
+ * Memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+ * @tparam T trivially copyable element, usually a pointer.
+ */
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "WorkStealingDeque element must be trivially copyable.");
+
+    class Ring {
+        public:
+        explicit Ring(std::int64_t capacity)
+            : _mask(capacity - 1), _items(new std::atomic<T>[static_cast<std::size_t>(capacity)])
+        {
+        }
+
+        [[nodiscard]] std::int64_t GetCapacity() const { return _mask + 1; }
+
+        void Store(std::int64_t index, T item)
+        {
+            _items[index & _mask].store(item, std::memory_order_relaxed);
+        }
+
+        T Load(std::int64_t index) const
+        {
+            return _items[index & _mask].load(std::memory_order_relaxed);
+        }
+
+        Ring* Grow(std::int64_t bottom, std::int64_t top) const
+        {
+            auto* ring = new Ring(GetCapacity() * 2);
+            for (std::int64_t idx = top; idx < bottom; ++idx) {
+                ring->Store(idx, Load(idx));
+            }
+            return ring;
+        }
+
+        private:
+        const std::int64_t                 _mask;
+        std::unique_ptr<std::atomic<T>[]> _items;
+    };
+
+    public:
+    /**
+     * @param capacity initial capacity, rounded up to a power of two.
+     */
+    explicit WorkStealingDeque(std::size_t capacity = 1024)
+    {
+        std::int64_t size = 2;
+        while (size < static_cast<std::int64_t>(capacity)) {
+            size *= 2;
+        }
+        _rings.emplace_back(new Ring(size));
+        _ring.store(_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Push an item at the bottom, owner thread only.
+     */
+    void Push(T item)
+    {
+        const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = _top.load(std::memory_order_acquire);
+        Ring*              ring = _ring.load(std::memory_order_relaxed);
+        if (bottom - top > ring->GetCapacity() - 1) {
+            ring = ring->Grow(bottom, top);
+            _rings.emplace_back(ring);
+            _ring.store(ring, std::memory_order_release);
+        }
+        ring->Store(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Pop the most recently pushed item, owner thread only.
+     * @return false if the deque is empty.
+     */
+    bool Pop(T& item)
+    {
+        const std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Ring*              ring = _ring.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = _top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = ring->Load(bottom);
+        if (top == bottom) {
+            // Last item, race against the thieves.
+            const bool won = _top.compare_exchange_strong(top,
+                                                          top + 1,
+                                                          std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Steal the oldest item, any thread.
+     * @return false if the deque is empty or the item was taken by another thread.
+     */
+    bool Steal(T& item)
+    {
+        std::int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+        Ring* ring = _ring.load(std::memory_order_acquire);
+        item = ring->Load(top);
+        return _top.compare_exchange_strong(top,
+                                            top + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Approximate number of items, exact from the owner thread when no thief is active.
+     */
+    [[nodiscard]] std::size_t GetSize() const
+    {
+        const std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = _top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+    [[nodiscard]] bool IsEmpty() const { return GetSize() == 0; }
+
+    private:
+    alignas(64) std::atomic<std::int64_t> _top = 0;
+    alignas(64) std::atomic<std::int64_t> _bottom = 0;
+    alignas(64) std::atomic<Ring*> _ring = nullptr;
+    std::vector<std::unique_ptr<Ring>> _rings; /**< Owner only, every buffer ever used. */
+};
+
+} // namespace Netero
@@ -109,3 +109,21 @@ TEST(NeteroCore, shared_buffer_circular_write)
     EXPECT_EQ(buffer.Write(buf, 6), 5);
     EXPECT_EQ(buffer.GetPadding(), 4);
 }
+
+TEST(NeteroCore, shared_buffer_fill_gauge)
+{
+    int                       buf[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    Netero::Metrics::Gauge    fill;
+    Netero::SharedBuffer<int> buffer(10);
+    buffer.SetFillGauge(&fill);
+    EXPECT_EQ(fill.GetValue(), 0);
+    buffer.Write(buf, 6);
+    EXPECT_EQ(fill.GetValue(), buffer.GetPadding());
+    buffer.Read(buf, 4);
+    EXPECT_EQ(fill.GetValue(), buffer.GetPadding());
+    buffer.Clear();
+    EXPECT_EQ(fill.GetValue(), 0);
+    buffer.SetFillGauge(nullptr);
+    buffer.Write(buf, 6);
+    EXPECT_EQ(fill.GetValue(), 0);
+}
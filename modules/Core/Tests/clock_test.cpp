@@ -0,0 +1,67 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <chrono>
+#include <thread>
+
+#include <Netero/Clock.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(NeteroCore, clock_is_monotonic)
+{
+    Netero::Clock::time_point previous = Netero::Clock::now();
+    for (int idx = 0; idx < 100000; ++idx) {
+        const Netero::Clock::time_point now = Netero::Clock::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+    EXPECT_NE(Netero::Clock::GetSource(), Netero::ClockSource::UNCALIBRATED);
+}
+
+TEST(NeteroCore, clock_follow_os_clock)
+{
+    const auto start = Netero::Clock::now();
+    const auto reference = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto elapsed = Netero::Clock::now() - start;
+    const auto referenceElapsed = std::chrono::steady_clock::now() - reference;
+    const auto error = std::chrono::abs(elapsed - referenceElapsed);
+    EXPECT_LT(error, std::chrono::milliseconds(1));
+}
+
+TEST(NeteroCore, clock_cycles_conversion)
+{
+    if (Netero::Clock::GetSource() != Netero::ClockSource::TSC) {
+        EXPECT_EQ(Netero::Clock::CyclesToDuration(1000).count(), 0);
+        GTEST_SKIP() << "Invariant TSC not available.";
+    }
+    const double frequency = Netero::Clock::GetCyclesFrequency();
+    EXPECT_GT(frequency, 0);
+    const auto oneSecond = static_cast<std::uint64_t>(frequency);
+    const auto duration = Netero::Clock::CyclesToDuration(oneSecond);
+    EXPECT_NEAR(static_cast<double>(duration.count()), 1e9, 1e3);
+    const std::uint64_t first = Netero::Clock::ReadCycles();
+    const std::uint64_t second = Netero::Clock::ReadCyclesOrdered();
+    EXPECT_LE(first, second);
+}
+
+TEST(NeteroCore, clock_stopwatch)
+{
+    Netero::Stopwatch       stopwatch;
+    Netero::Clock::duration accumulated {};
+    Netero::Clock::duration reported {};
+    {
+        Netero::ScopedStopwatch watch(accumulated);
+        Netero::ScopedStopwatchCallback callback(
+            [&reported](Netero::Clock::duration elapsed) { reported = elapsed; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_GE(accumulated, std::chrono::milliseconds(5));
+    EXPECT_GE(reported, std::chrono::milliseconds(5));
+    const auto lap = stopwatch.Lap();
+    EXPECT_GE(lap, accumulated);
+    EXPECT_LT(stopwatch.Elapsed(), lap);
+}
@@ -0,0 +1,185 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Netero/Epoch.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+    std::atomic<int> g_deleted = 0;
+
+    struct Node {
+        static constexpr std::uint32_t aliveMagic = 0xA11FE;
+
+        explicit Node(int value): value(value) {}
+        ~Node()
+        {
+            magic = 0;
+            g_deleted += 1;
+        }
+
+        std::uint32_t magic = aliveMagic;
+        int           value;
+    };
+
+} // namespace
+
+TEST(NeteroCore, epoch_retire_after_unpin)
+{
+    g_deleted = 0;
+    Netero::EpochDomain epoch;
+    {
+        auto guard = epoch.Pin();
+        auto nested = epoch.Pin();
+        epoch.Retire(new Node(1));
+        EXPECT_EQ(epoch.GetGarbageCount(), 1);
+        // The calling thread is pinned, the node must survive any collect.
+        for (int idx = 0; idx < 8; ++idx) {
+            epoch.Collect();
+        }
+        EXPECT_EQ(g_deleted, 0);
+        nested.Release();
+        epoch.Collect();
+        EXPECT_EQ(g_deleted, 0);
+    }
+    epoch.Synchronize();
+    EXPECT_EQ(g_deleted, 1);
+    EXPECT_EQ(epoch.GetGarbageCount(), 0);
+}
+
+TEST(NeteroCore, epoch_reader_blocks_reclamation)
+{
+    g_deleted = 0;
+    Netero::EpochDomain epoch;
+    std::atomic<bool>   pinned = false;
+    std::atomic<bool>   release = false;
+    std::thread         reader([&]() {
+        auto guard = epoch.Pin();
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+    epoch.Retire(new Node(1));
+    for (int idx = 0; idx < 8; ++idx) {
+        epoch.Collect();
+    }
+    EXPECT_EQ(g_deleted, 0);
+    release = true;
+    reader.join();
+    epoch.Synchronize();
+    EXPECT_EQ(g_deleted, 1);
+}
+
+TEST(NeteroCore, epoch_thread_exit_hand_garbage)
+{
+    g_deleted = 0;
+    Netero::EpochDomain epoch;
+    {
+        auto        guard = epoch.Pin();
+        std::thread writer([&]() {
+            for (int idx = 0; idx < 100; ++idx) {
+                epoch.Retire(new Node(idx));
+            }
+        });
+        writer.join();
+        EXPECT_EQ(g_deleted, 0);
+        EXPECT_EQ(epoch.GetGarbageCount(), 100);
+    }
+    epoch.Synchronize();
+    EXPECT_EQ(g_deleted, 100);
+}
+
+TEST(NeteroCore, epoch_bounded_garbage)
+{
+    g_deleted = 0;
+    Netero::EpochDomain::Options options;
+    options.collectThreshold = 16;
+    options.maxGarbage = 128;
+    Netero::EpochDomain epoch(options);
+    std::atomic<bool>   stop = false;
+    std::thread         reader([&]() {
+        while (!stop) {
+            auto guard = epoch.Pin();
+            std::this_thread::yield();
+        }
+    });
+    std::size_t maxGarbage = 0;
+    for (int idx = 0; idx < 5000; ++idx) {
+        epoch.Retire(new Node(idx));
+        maxGarbage = std::max(maxGarbage, epoch.GetGarbageCount());
+    }
+    stop = true;
+    reader.join();
+    EXPECT_LE(maxGarbage, options.maxGarbage);
+    epoch.Synchronize();
+    EXPECT_EQ(g_deleted, 5000);
+}
+
+TEST(NeteroCore, epoch_destructor_release_garbage)
+{
+    g_deleted = 0;
+    {
+        Netero::EpochDomain epoch;
+        auto                guard = epoch.Pin();
+        epoch.Retire(new Node(1));
+        guard.Release();
+    }
+    EXPECT_EQ(g_deleted, 1);
+}
+
+/**
+ * Readers dereference the shared node while writers swap and retire it, run under
+ * ThreadSanitizer (THREAD_SANITIZER=ON) to catch accesses to reclaimed nodes.
+ */
+TEST(NeteroCore, epoch_stress)
+{
+    g_deleted = 0;
+    constexpr int       writerCount = 2;
+    constexpr int       readerCount = 4;
+    constexpr int       swapCount = 20000;
+    Netero::EpochDomain epoch;
+    std::atomic<Node*>  shared = new Node(0);
+    std::atomic<int>    writersDone = 0;
+    std::atomic<bool>   corrupted = false;
+
+    std::vector<std::thread> threads;
+    for (int idx = 0; idx < readerCount; ++idx) {
+        threads.emplace_back([&]() {
+            while (writersDone < writerCount) {
+                auto  guard = epoch.Pin();
+                Node* node = shared.load(std::memory_order_acquire);
+                if (node->magic != Node::aliveMagic || node->value < 0) {
+                    corrupted = true;
+                }
+            }
+        });
+    }
+    for (int idx = 0; idx < writerCount; ++idx) {
+        threads.emplace_back([&]() {
+            for (int swap = 1; swap <= swapCount; ++swap) {
+                Node* old = shared.exchange(new Node(swap), std::memory_order_acq_rel);
+                epoch.Retire(old);
+            }
+            writersDone += 1;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(corrupted);
+    epoch.Synchronize();
+    EXPECT_EQ(g_deleted, writerCount * swapCount);
+    delete shared.load();
+}
@@ -0,0 +1,154 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <Netero/IoService.hpp>
+
+#include <gtest/gtest.h>
+
+using Netero::IoService;
+
+static void WriteAndReadBack(IoService::Backend backend, const char* path)
+{
+    IoService service(backend, 8);
+    if (backend == IoService::Backend::THREAD_POOL) {
+        EXPECT_EQ(service.GetBackend(), IoService::Backend::THREAD_POOL);
+    }
+    auto file = IoService::OpenFile(path, true);
+    ASSERT_TRUE(IoService::IsValid(file));
+
+    const std::string content = "Netero asynchronous file content.";
+    auto              written = service.Write(file, content.data(), content.size(), 0);
+    EXPECT_EQ(written.get(), static_cast<std::int64_t>(content.size()));
+
+    std::vector<char> buffer(content.size(), 0);
+    auto              read = service.Read(file, buffer.data(), buffer.size(), 0);
+    ASSERT_EQ(read.get(), static_cast<std::int64_t>(content.size()));
+    EXPECT_EQ(std::memcmp(buffer.data(), content.data(), content.size()), 0);
+
+    std::atomic<std::int64_t> partial = 0;
+    char                      tail[64] = {};
+    service.Read(file, tail, sizeof(tail), 8, [&partial](std::int64_t result) {
+        partial = result;
+    });
+    service.WaitIdle();
+    EXPECT_EQ(service.GetPendingCount(), 0);
+    EXPECT_EQ(partial, static_cast<std::int64_t>(content.size() - 8));
+    EXPECT_EQ(std::memcmp(tail, content.data() + 8, content.size() - 8), 0);
+
+    IoService::CloseFile(file);
+    std::remove(path);
+}
+
+static void SubmitBatch(IoService::Backend backend, const char* path)
+{
+    constexpr std::size_t blockCount = 32;
+    constexpr std::size_t blockSize = 512;
+    IoService             service(backend, 4);
+    auto                  file = IoService::OpenFile(path, true);
+    ASSERT_TRUE(IoService::IsValid(file));
+
+    std::vector<char> source(blockCount * blockSize);
+    for (std::size_t idx = 0; idx < source.size(); ++idx) {
+        source[idx] = static_cast<char>(idx / blockSize);
+    }
+    std::atomic<std::size_t>        completed = 0;
+    std::atomic<std::size_t>        maxPending = 0;
+    std::vector<IoService::Request> requests;
+    for (std::size_t idx = 0; idx < blockCount; ++idx) {
+        // The request does not set registeredBuffer, it use a plain buffer.
+        requests.push_back({ IoService::Operation::WRITE,
+                             file,
+                             source.data() + idx * blockSize,
+                             blockSize,
+                             idx * blockSize,
+                             [&](std::int64_t result) {
+                                 if (result == blockSize) {
+                                     completed += 1;
+                                 }
+                                 const std::size_t pending = service.GetPendingCount();
+                                 if (pending > maxPending) {
+                                     maxPending = pending;
+                                 }
+                             } });
+    }
+    // Larger than the queue depth, submitted by slices.
+    service.Submit(requests);
+    service.WaitIdle();
+    EXPECT_EQ(completed, blockCount);
+    EXPECT_LE(maxPending, 4);
+
+    std::vector<char> destination(source.size(), 0);
+    auto              read = service.Read(file, destination.data(), destination.size(), 0);
+    EXPECT_EQ(read.get(), static_cast<std::int64_t>(destination.size()));
+    EXPECT_EQ(destination, source);
+    IoService::CloseFile(file);
+    std::remove(path);
+}
+
+TEST(NeteroCore, io_service_thread_pool)
+{
+    WriteAndReadBack(IoService::Backend::THREAD_POOL, "netero_io_thread_pool.bin");
+    SubmitBatch(IoService::Backend::THREAD_POOL, "netero_io_thread_pool_batch.bin");
+}
+
+TEST(NeteroCore, io_service_auto)
+{
+    WriteAndReadBack(IoService::Backend::AUTO, "netero_io_auto.bin");
+    SubmitBatch(IoService::Backend::AUTO, "netero_io_auto_batch.bin");
+}
+
+TEST(NeteroCore, io_service_registered_buffers)
+{
+    const char*       path = "netero_io_registered.bin";
+    IoService         service;
+    std::vector<char> memory(4096, 'n');
+    auto              file = IoService::OpenFile(path, true);
+    ASSERT_TRUE(IoService::IsValid(file));
+    ASSERT_TRUE(service.RegisterBuffers({ { memory.data(), memory.size() } }));
+
+    std::atomic<std::int64_t> result = 0;
+    service.Submit({ IoService::Operation::WRITE,
+                     file,
+                     memory.data(),
+                     1024,
+                     0,
+                     [&result](std::int64_t size) { result = size; },
+                     0 });
+    service.WaitIdle();
+    EXPECT_EQ(result, 1024);
+
+    std::memset(memory.data(), 0, memory.size());
+    service.Submit({ IoService::Operation::READ,
+                     file,
+                     memory.data() + 2048,
+                     1024,
+                     0,
+                     [&result](std::int64_t size) { result = size; },
+                     0 });
+    service.WaitIdle();
+    EXPECT_EQ(result, 1024);
+    EXPECT_EQ(memory[2048], 'n');
+    EXPECT_EQ(memory[3071], 'n');
+    service.UnregisterBuffers();
+    IoService::CloseFile(file);
+    std::remove(path);
+}
+
+TEST(NeteroCore, io_service_error)
+{
+    IoService service;
+    char      buffer[16];
+    EXPECT_FALSE(IoService::IsValid(IoService::OpenFile("netero_io_does_not_exist.bin")));
+#if !defined(_WIN32)
+    auto read = service.Read(-1, buffer, sizeof(buffer), 0);
+    EXPECT_LT(read.get(), 0);
+#endif
+}
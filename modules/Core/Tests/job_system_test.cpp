@@ -0,0 +1,116 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <vector>
+
+#include <Netero/JobSystem.hpp>
+
+#include <gtest/gtest.h>
+
+using Netero::JobCounter;
+using Netero::JobSystem;
+
+TEST(NeteroCore, job_system_run)
+{
+    JobSystem::Options options;
+    options.workerCount = 3;
+    JobSystem jobs(options);
+    EXPECT_EQ(jobs.GetWorkerCount(), 3);
+    EXPECT_EQ(jobs.GetCurrentWorkerIndex(), -1);
+
+    std::atomic<int> sum = 0;
+    JobCounter       counter;
+    for (int idx = 1; idx <= 1000; ++idx) {
+        jobs.Run([&sum, idx]() { sum += idx; }, &counter);
+    }
+    jobs.WaitFor(counter);
+    EXPECT_TRUE(counter.IsDone());
+    EXPECT_EQ(counter.GetValue(), 0);
+    EXPECT_EQ(sum, 500500);
+}
+
+TEST(NeteroCore, job_system_nested)
+{
+    JobSystem::Options options;
+    options.workerCount = 2;
+    JobSystem        jobs(options);
+    std::atomic<int> leaves = 0;
+    JobCounter       counter;
+    for (int idx = 0; idx < 16; ++idx) {
+        jobs.Run(
+            [&]() {
+                JobCounter children;
+                for (int child = 0; child < 16; ++child) {
+                    jobs.Run([&leaves]() { leaves += 1; }, &children);
+                }
+                // The worker run pending jobs instead of blocking.
+                jobs.WaitFor(children);
+            },
+            &counter);
+    }
+    jobs.WaitFor(counter);
+    EXPECT_EQ(leaves, 256);
+}
+
+TEST(NeteroCore, job_system_dependencies)
+{
+    JobSystem        jobs;
+    std::vector<int> order;
+    std::atomic<int> firstStage = 0;
+    JobCounter       first;
+    JobCounter       second;
+    JobCounter       third;
+    for (int idx = 0; idx < 8; ++idx) {
+        jobs.Run([&firstStage]() { firstStage += 1; }, &first);
+    }
+    jobs.RunAfter(
+        first,
+        [&]() {
+            order.push_back(firstStage);
+        },
+        &second);
+    jobs.RunAfter(second, [&order]() { order.push_back(-1); }, &third);
+    jobs.WaitFor(third);
+    ASSERT_EQ(order.size(), 2);
+    EXPECT_EQ(order[0], 8);
+    EXPECT_EQ(order[1], -1);
+
+    // A dependency already done release the job immediately.
+    JobCounter last;
+    jobs.RunAfter(first, [&order]() { order.push_back(1); }, &last);
+    jobs.WaitFor(last);
+    EXPECT_EQ(order.size(), 3);
+}
+
+TEST(NeteroCore, job_system_pinned_workers)
+{
+    JobSystem::Options options;
+    options.workerCount = 2;
+    options.pinWorkers = true;
+    JobSystem        jobs(options);
+    std::atomic<int> count = 0;
+    JobCounter       counter;
+    for (int idx = 0; idx < 64; ++idx) {
+        jobs.Run([&count]() { count += 1; }, &counter);
+    }
+    jobs.WaitFor(counter);
+    EXPECT_EQ(count, 64);
+}
+
+TEST(NeteroCore, job_system_default)
+{
+    auto&            jobs = JobSystem::GetDefault();
+    std::atomic<int> count = 0;
+    JobCounter       counter;
+    for (int round = 0; round < 3; ++round) {
+        for (int idx = 0; idx < 10; ++idx) {
+            jobs.Run([&count]() { count += 1; }, &counter);
+        }
+        jobs.WaitFor(counter);
+        EXPECT_EQ(count, (round + 1) * 10);
+    }
+    EXPECT_GE(jobs.GetWorkerCount(), 1);
+}
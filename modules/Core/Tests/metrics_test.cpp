@@ -0,0 +1,131 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Netero/Metrics.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(NeteroCore, metrics_counter_shards)
+{
+    Netero::Metrics::Counter counter;
+    std::vector<std::thread> threads;
+    for (int idx = 0; idx < 8; ++idx) {
+        threads.emplace_back([&counter]() {
+            for (int count = 0; count < 10000; ++count) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.GetValue(), 80000);
+    counter.Reset();
+    EXPECT_EQ(counter.GetValue(), 0);
+}
+
+TEST(NeteroCore, metrics_histogram_buckets)
+{
+    using Netero::Metrics::Histogram;
+    const std::vector<std::uint64_t> values = { 0,    1,         31,         32,        33,
+                                                100,  1000,      123456789,  1ull << 40,
+                                                UINT64_MAX };
+    for (std::uint64_t value : values) {
+        const std::size_t index = Histogram::GetBucketIndex(value);
+        ASSERT_LT(index, Histogram::bucketCount) << value;
+        EXPECT_LE(Histogram::GetBucketLowerBound(index), value);
+        EXPECT_GE(Histogram::GetBucketUpperBound(index), value);
+        const auto lower = Histogram::GetBucketLowerBound(index);
+        const auto width = Histogram::GetBucketUpperBound(index) - lower;
+        EXPECT_LE(static_cast<double>(width), static_cast<double>(lower) / 16. + 1.);
+    }
+    for (std::size_t index = 1; index < Histogram::bucketCount; ++index) {
+        ASSERT_EQ(Histogram::GetBucketLowerBound(index),
+                  Histogram::GetBucketUpperBound(index - 1) + 1);
+    }
+}
+
+TEST(NeteroCore, metrics_histogram_percentiles)
+{
+    Netero::Metrics::Histogram histogram;
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value * 1000);
+    }
+    const auto snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 1000);
+    EXPECT_EQ(snapshot.sum, 500500000);
+    EXPECT_DOUBLE_EQ(snapshot.GetMean(), 500500.);
+    EXPECT_LE(snapshot.min, 1000);
+    EXPECT_GE(snapshot.max, 1000000);
+    const auto median = static_cast<double>(snapshot.GetPercentile(50));
+    EXPECT_NEAR(median, 500000., 500000. * 0.0625);
+    const auto p99 = static_cast<double>(snapshot.GetPercentile(99));
+    EXPECT_NEAR(p99, 990000., 990000. * 0.0625);
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetSnapshot().count, 0);
+}
+
+TEST(NeteroCore, metrics_rolling_histogram)
+{
+    Netero::Metrics::RollingHistogram histogram(4);
+    EXPECT_EQ(histogram.GetLast(), 0);
+    EXPECT_EQ(histogram.GetSnapshot().count, 0);
+    for (std::uint64_t value = 1; value <= 10; ++value) {
+        histogram.Record(value);
+    }
+    auto snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(histogram.GetLast(), 10);
+    EXPECT_EQ(snapshot.count, 4);
+    EXPECT_EQ(snapshot.sum, 7 + 8 + 9 + 10);
+    EXPECT_EQ(snapshot.min, 7);
+    EXPECT_EQ(snapshot.max, 10);
+    EXPECT_EQ(snapshot.GetPercentile(50), 8);
+
+    histogram.SetCapacity(2);
+    snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 2);
+    EXPECT_EQ(snapshot.sum, 9 + 10);
+    histogram.Record(1000);
+    histogram.Record(1000);
+    snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.count, 2);
+    EXPECT_EQ(snapshot.buckets.size(), 1);
+    EXPECT_EQ(histogram.GetLast(), 1000);
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetSize(), 0);
+}
+
+TEST(NeteroCore, metrics_registry_snapshot)
+{
+    Netero::Metrics::Registry registry;
+    auto&                     frames = registry.GetCounter("gfx.frames");
+    EXPECT_EQ(&frames, &registry.GetCounter("gfx.frames"));
+    frames.Add(3);
+    registry.GetGauge("buffer.fill").Set(-4);
+    {
+        Netero::Metrics::ScopedTimer timer(registry.GetHistogram("frame_ns"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto snapshot = registry.TakeSnapshot();
+    EXPECT_EQ(snapshot.counters.at("gfx.frames"), 3);
+    EXPECT_EQ(snapshot.gauges.at("buffer.fill"), -4);
+    EXPECT_EQ(snapshot.histograms.at("frame_ns").count, 1);
+    EXPECT_GE(snapshot.histograms.at("frame_ns").max, 1000000);
+
+    const auto text = snapshot.ToText();
+    EXPECT_NE(text.find("counter gfx.frames 3\n"), std::string::npos);
+    EXPECT_NE(text.find("gauge buffer.fill -4\n"), std::string::npos);
+    EXPECT_NE(text.find("histogram frame_ns count=1 "), std::string::npos);
+
+    const auto json = snapshot.ToJson();
+    EXPECT_EQ(json.rfind("{\"counters\":{\"gfx.frames\":3},\"gauges\":{\"buffer.fill\":-4},", 0),
+              0);
+    EXPECT_NE(json.find("\"frame_ns\":{\"count\":1,"), std::string::npos);
+    EXPECT_EQ(json.back(), '}');
+}
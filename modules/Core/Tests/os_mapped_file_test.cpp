@@ -0,0 +1,87 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <Netero/MappedFile.hpp>
+
+#include <gtest/gtest.h>
+
+using Netero::Os::MappedFile;
+using Netero::Os::RtCode;
+
+static const std::string g_content = "Netero mapped file content.";
+
+static std::string CreateTestFile(const char* name, const std::string& content)
+{
+    std::ofstream file(name, std::ofstream::binary | std::ofstream::trunc);
+    file << content;
+    return name;
+}
+
+TEST(NeteroCore, mapped_file_read_only)
+{
+    const std::string path = CreateTestFile("netero_mapped_file_ro.bin", g_content);
+    MappedFile        file;
+    ASSERT_EQ(file.Open(path), RtCode::SUCCESS);
+    ASSERT_TRUE(file.IsOpen());
+    ASSERT_EQ(file.GetSize(), g_content.size());
+    EXPECT_EQ(std::memcmp(file.GetData(), g_content.data(), g_content.size()), 0);
+    EXPECT_EQ(file.Advise(MappedFile::Access::SEQUENTIAL), RtCode::SUCCESS);
+    EXPECT_EQ(file.Advise(MappedFile::Access::WILL_NEED, 4, 8), RtCode::SUCCESS);
+    EXPECT_EQ(file.Advise(MappedFile::Access::RANDOM, g_content.size() + 1),
+              RtCode::INVALID_ARGUMENT);
+
+    MappedFile moved(std::move(file));
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_TRUE(moved.IsOpen());
+    EXPECT_EQ(moved.GetSize(), g_content.size());
+    moved.Close();
+    EXPECT_FALSE(moved.IsOpen());
+    EXPECT_EQ(moved.GetData(), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(NeteroCore, mapped_file_read_write)
+{
+    const char*         path = "netero_mapped_file_rw.bin";
+    MappedFile::Options options;
+    options.mode = MappedFile::Mode::READ_WRITE;
+    options.create = true;
+    options.size = 4096;
+    options.populate = true;
+    options.hugePages = true;
+    {
+        MappedFile file;
+        ASSERT_EQ(file.Open(path, options), RtCode::SUCCESS);
+        ASSERT_EQ(file.GetSize(), 4096);
+        std::memcpy(file.GetData(), g_content.data(), g_content.size());
+        EXPECT_EQ(file.Flush(), RtCode::SUCCESS);
+    }
+    std::ifstream stream(path, std::ifstream::binary);
+    std::string   content(g_content.size(), '\0');
+    stream.read(content.data(), content.size());
+    EXPECT_EQ(content, g_content);
+    stream.close();
+    std::remove(path);
+}
+
+TEST(NeteroCore, mapped_file_errors)
+{
+    MappedFile file;
+    EXPECT_EQ(file.Open("netero_file_that_does_not_exist.bin"), RtCode::NOT_FOUND);
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_EQ(file.Flush(), RtCode::INVALID_ARGUMENT);
+
+    const std::string path = CreateTestFile("netero_mapped_file_empty.bin", "");
+    EXPECT_EQ(file.Open(path), RtCode::SUCCESS);
+    EXPECT_EQ(file.GetSize(), 0);
+    EXPECT_EQ(file.GetData(), nullptr);
+    file.Close();
+    std::remove(path.c_str());
+}
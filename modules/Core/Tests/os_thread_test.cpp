@@ -0,0 +1,88 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <thread>
+
+#include <Netero/Os.hpp>
+
+#include <gtest/gtest.h>
+
+using Netero::Os::RtCode;
+
+TEST(NeteroCore, os_cpu_count)
+{
+    EXPECT_GE(Netero::Os::GetCpuCount(), 1);
+}
+
+TEST(NeteroCore, os_cpu_topology)
+{
+    const auto topology = Netero::Os::GetCpuTopology();
+    ASSERT_FALSE(topology.empty());
+    for (std::size_t idx = 1; idx < topology.size(); ++idx) {
+        EXPECT_LT(topology[idx - 1].cpu, topology[idx].cpu);
+    }
+}
+
+TEST(NeteroCore, os_thread_affinity)
+{
+    Netero::Os::CpuMask mask;
+    RtCode              result = Netero::Os::GetThreadAffinity(mask);
+    if (result == RtCode::NOT_SUPPORTED) {
+        GTEST_SKIP() << Netero::Os::RtCodeToString(result);
+    }
+    ASSERT_EQ(result, RtCode::SUCCESS);
+    EXPECT_TRUE(mask.any());
+    EXPECT_EQ(Netero::Os::SetThreadAffinity(mask), RtCode::SUCCESS);
+    EXPECT_EQ(Netero::Os::SetThreadAffinity(Netero::Os::CpuMask()), RtCode::INVALID_ARGUMENT);
+
+    std::atomic<bool> stop = false;
+    std::thread       worker([&stop]() {
+        while (!stop) {
+            std::this_thread::yield();
+        }
+    });
+    Netero::Os::CpuMask first;
+    for (size_t cpu = 0; cpu < mask.size(); ++cpu) {
+        if (mask.test(cpu)) {
+            first.set(cpu);
+            break;
+        }
+    }
+    EXPECT_EQ(Netero::Os::SetThreadAffinity(worker, first), RtCode::SUCCESS);
+    Netero::Os::CpuMask workerMask;
+    EXPECT_EQ(Netero::Os::GetThreadAffinity(worker, workerMask), RtCode::SUCCESS);
+    EXPECT_EQ(workerMask, first);
+    stop = true;
+    worker.join();
+}
+
+TEST(NeteroCore, os_thread_realtime_priority)
+{
+    const int max = Netero::Os::GetRealtimePriorityMax();
+    EXPECT_EQ(Netero::Os::SetThreadRealtimePriority(max + 1), RtCode::INVALID_ARGUMENT);
+
+    const RtCode result = Netero::Os::SetThreadRealtimePriority(Netero::Os::GetRealtimePriorityMin());
+    EXPECT_TRUE(result == RtCode::SUCCESS || result == RtCode::PERMISSION_DENIED)
+        << Netero::Os::RtCodeToString(result);
+    int priority = -1;
+    EXPECT_EQ(Netero::Os::GetThreadRealtimePriority(priority), RtCode::SUCCESS);
+    if (result == RtCode::SUCCESS) {
+        EXPECT_EQ(priority, Netero::Os::GetRealtimePriorityMin());
+        EXPECT_EQ(Netero::Os::ResetThreadPriority(), RtCode::SUCCESS);
+    }
+    else {
+        EXPECT_EQ(priority, 0);
+    }
+}
+
+TEST(NeteroCore, os_lock_process_memory)
+{
+    const RtCode result = Netero::Os::LockProcessMemory();
+    EXPECT_NE(result, RtCode::INVALID_ARGUMENT) << Netero::Os::RtCodeToString(result);
+    if (result == RtCode::SUCCESS) {
+        EXPECT_EQ(Netero::Os::UnlockProcessMemory(), RtCode::SUCCESS);
+    }
+}
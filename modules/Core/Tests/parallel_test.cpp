@@ -0,0 +1,195 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Netero/Parallel.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(NeteroCore, parallel_for)
+{
+    std::vector<int> values(100003, 0);
+    Netero::ParallelFor(std::size_t(0), values.size(), [&values](std::size_t idx) {
+        values[idx] += static_cast<int>(idx);
+    });
+    for (std::size_t idx = 0; idx < values.size(); ++idx) {
+        ASSERT_EQ(values[idx], static_cast<int>(idx));
+    }
+
+    std::vector<std::pair<int, int>> ranges(1000);
+    std::atomic<int>                 calls = 0;
+    Netero::ParallelForRange(
+        0,
+        1000,
+        [&](int first, int last) {
+            EXPECT_LE(last - first, 64);
+            ranges[calls++] = { first, last };
+        },
+        64);
+    EXPECT_EQ(calls, 16);
+    ranges.resize(calls);
+    std::sort(ranges.begin(), ranges.end());
+    EXPECT_EQ(ranges.front().first, 0);
+    EXPECT_EQ(ranges.back().second, 1000);
+    for (std::size_t idx = 1; idx < ranges.size(); ++idx) {
+        EXPECT_EQ(ranges[idx - 1].second, ranges[idx].first);
+    }
+
+    Netero::ParallelFor(10, 10, [](int) { FAIL(); });
+}
+
+TEST(NeteroCore, parallel_reduce)
+{
+    std::vector<std::uint64_t> values(1 << 20);
+    std::iota(values.begin(), values.end(), 1);
+    const std::uint64_t sum = Netero::ParallelReduce(
+        std::size_t(0),
+        values.size(),
+        std::uint64_t(0),
+        [&values](std::size_t first, std::size_t last) {
+            return std::accumulate(values.begin() + first, values.begin() + last, std::uint64_t(0));
+        },
+        [](std::uint64_t a, std::uint64_t b) { return a + b; });
+    EXPECT_EQ(sum, std::uint64_t(values.size()) * (values.size() + 1) / 2);
+
+    // Partial results are combined in chunk order.
+    const std::string text = Netero::ParallelReduce(
+        0,
+        26,
+        std::string(),
+        [](int first, int last) {
+            std::string part;
+            for (int idx = first; idx < last; ++idx) {
+                part += static_cast<char>('a' + idx);
+            }
+            return part;
+        },
+        [](std::string a, const std::string& b) { return a + b; },
+        3);
+    EXPECT_EQ(text, "abcdefghijklmnopqrstuvwxyz");
+
+    // Any element matching, bool partials are not packed in bits.
+    const auto any = [&values](std::uint64_t searched) {
+        return Netero::ParallelReduce(
+            std::size_t(0),
+            values.size(),
+            false,
+            [&values, searched](std::size_t first, std::size_t last) {
+                return std::find(values.begin() + first, values.begin() + last, searched)
+                    != values.begin() + last;
+            },
+            [](bool a, bool b) { return a || b; },
+            1000);
+    };
+    EXPECT_TRUE(any(values.size() - 5));
+    EXPECT_FALSE(any(0));
+}
+
+TEST(NeteroCore, parallel_transform)
+{
+    std::vector<float> input(50000);
+    std::iota(input.begin(), input.end(), 0.f);
+    std::vector<float> output(input.size());
+    auto               end = Netero::ParallelTransform(input.begin(),
+                                         input.end(),
+                                         output.begin(),
+                                         [](float value) { return value * 2.f; },
+                                         100);
+    EXPECT_EQ(end, output.end());
+    std::vector<float> sum(input.size());
+    Netero::ParallelTransform(input.begin(),
+                              input.end(),
+                              output.begin(),
+                              sum.begin(),
+                              [](float a, float b) { return a + b; });
+    for (std::size_t idx = 0; idx < input.size(); ++idx) {
+        ASSERT_EQ(output[idx], input[idx] * 2.f);
+        ASSERT_EQ(sum[idx], input[idx] * 3.f);
+    }
+}
+
+TEST(NeteroCore, parallel_sort)
+{
+    std::mt19937     random(42);
+    std::vector<int> values(200000);
+    for (auto& value : values) {
+        value = static_cast<int>(random() % 1000);
+    }
+    auto expected = values;
+    std::stable_sort(expected.begin(), expected.end());
+    Netero::ParallelSort(values.begin(), values.end());
+    EXPECT_EQ(values, expected);
+
+    // Stability, elements of equal keys keep their original order.
+    std::vector<std::pair<int, int>> pairs(100000);
+    for (std::size_t idx = 0; idx < pairs.size(); ++idx) {
+        pairs[idx] = { static_cast<int>(random() % 100), static_cast<int>(idx) };
+    }
+    auto byKey = [](const auto& a, const auto& b) { return a.first > b.first; };
+    auto expectedPairs = pairs;
+    std::stable_sort(expectedPairs.begin(), expectedPairs.end(), byKey);
+    Netero::ParallelSort(pairs.begin(), pairs.end(), byKey);
+    EXPECT_EQ(pairs, expectedPairs);
+
+    std::vector<int> small = { 3, 1, 2 };
+    Netero::ParallelSort(small.begin(), small.end());
+    EXPECT_EQ(small, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(NeteroCore, parallel_radix_sort)
+{
+    std::mt19937_64            random(7);
+    std::vector<std::uint64_t> values(300000);
+    for (auto& value : values) {
+        value = random();
+    }
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    Netero::ParallelRadixSort(values.begin(), values.end());
+    EXPECT_EQ(values, expected);
+
+    struct Item {
+        std::uint16_t key;
+        std::size_t   order;
+    };
+    std::vector<Item> items(50000);
+    for (std::size_t idx = 0; idx < items.size(); ++idx) {
+        items[idx] = { static_cast<std::uint16_t>(random() % 64), idx };
+    }
+    auto key = [](const Item& item) { return item.key; };
+    Netero::ParallelRadixSort(items.begin(), items.end(), key);
+    for (std::size_t idx = 1; idx < items.size(); ++idx) {
+        ASSERT_LE(items[idx - 1].key, items[idx].key);
+        if (items[idx - 1].key == items[idx].key) {
+            ASSERT_LT(items[idx - 1].order, items[idx].order);
+        }
+    }
+}
+
+TEST(NeteroCore, parallel_per_worker)
+{
+    Netero::JobSystem            jobs(Netero::JobSystem::Options { 3 });
+    Netero::PerWorker<long long> sums(jobs, 0);
+    EXPECT_EQ(sums.GetSize(), 4);
+    Netero::ParallelFor(
+        0,
+        100000,
+        [&sums](int idx) { sums.Local() += idx; },
+        64,
+        jobs);
+    long long total = 0;
+    sums.ForEach([&total](long long value) { total += value; });
+    EXPECT_EQ(total, 100000LL * 99999 / 2);
+    sums.Local() = 7;
+    EXPECT_EQ(sums[0], 7);
+}
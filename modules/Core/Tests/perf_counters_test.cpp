@@ -0,0 +1,60 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <vector>
+
+#include <Netero/PerfCounters.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(NeteroCore, perf_counters_scope)
+{
+    using Event = Netero::PerfCounters::Event;
+    Netero::PerfCounters counters;
+    counters.Enable();
+    Netero::PerfCounters::Sample sample;
+    {
+        Netero::ScopedPerfCounters scope(counters, sample);
+        std::vector<int>           values(100000, 1);
+        int                        sum = 0;
+        for (const int value : values) {
+            sum += value;
+        }
+        EXPECT_EQ(sum, 100000);
+    }
+    counters.Disable();
+    // perf events are often not permitted in containers, only the fallback is checked then.
+    EXPECT_EQ(sample.availableMask & ~0x1Fu, 0u);
+    for (std::size_t idx = 0; idx < Netero::PerfCounters::eventCount; ++idx) {
+        const auto event = static_cast<Event>(idx);
+        EXPECT_EQ(counters.IsAvailable(event), sample.IsAvailable(event));
+        if (!sample.IsAvailable(event)) {
+            EXPECT_EQ(sample.Get(event), 0u);
+        }
+    }
+    if (sample.IsAvailable(Event::INSTRUCTIONS)) {
+        EXPECT_GE(sample.Get(Event::INSTRUCTIONS), 100000u);
+    }
+    if (!counters.IsAvailable(Event::CYCLES) || !counters.IsAvailable(Event::INSTRUCTIONS)) {
+        EXPECT_EQ(sample.GetIpc(), 0.);
+    }
+}
+
+TEST(NeteroCore, perf_counters_sample_difference)
+{
+    using Event = Netero::PerfCounters::Event;
+    Netero::PerfCounters::Sample begin;
+    Netero::PerfCounters::Sample end;
+    begin.availableMask = 0b00111;
+    end.availableMask = 0b10011;
+    begin.values = { 100, 150, 10, 0, 0 };
+    end.values = { 300, 550, 12, 5, 7 };
+    const auto delta = end - begin;
+    EXPECT_EQ(delta.availableMask, 0b00011u);
+    EXPECT_EQ(delta.Get(Event::CYCLES), 200u);
+    EXPECT_EQ(delta.Get(Event::INSTRUCTIONS), 400u);
+    EXPECT_DOUBLE_EQ(delta.GetIpc(), 2.);
+    EXPECT_FALSE(delta.IsAvailable(Event::TLB_MISSES));
+}
@@ -0,0 +1,131 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#if !defined(NETERO_PROFILER)
+#define NETERO_PROFILER
+#endif
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Netero/Profiler.hpp>
+
+#include <gtest/gtest.h>
+
+static std::vector<Netero::Profiler::Event> CollectCurrentThread(const std::string& name)
+{
+    for (auto& thread : Netero::Profiler::Collect()) {
+        if (thread.name == name) {
+            return thread.events;
+        }
+    }
+    return {};
+}
+
+static void Nested()
+{
+    NETERO_PROFILE_SCOPE("Outer");
+    {
+        NETERO_PROFILE_SCOPE("Inner");
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+TEST(NeteroCore, profiler_scopes)
+{
+    Netero::Profiler::Clear();
+    Netero::Profiler::SetThreadName("profiler_scopes");
+    Nested();
+    const auto events = CollectCurrentThread("profiler_scopes");
+    ASSERT_EQ(events.size(), 2);
+    // Scopes are recorded when they end, the inner one first.
+    EXPECT_STREQ(events[0].name, "Inner");
+    EXPECT_STREQ(events[1].name, "Outer");
+    EXPECT_LE(events[1].begin, events[0].begin);
+    EXPECT_GE(events[1].end, events[0].end);
+    EXPECT_GE(events[0].end - events[0].begin, 100000u);
+
+    Netero::Profiler::SetEnabled(false);
+    Nested();
+    Netero::Profiler::SetEnabled(true);
+    EXPECT_EQ(CollectCurrentThread("profiler_scopes").size(), 2);
+    Netero::Profiler::Clear();
+    EXPECT_TRUE(CollectCurrentThread("profiler_scopes").empty());
+}
+
+TEST(NeteroCore, profiler_ring_overwrite_oldest)
+{
+    Netero::Profiler::SetBufferCapacity(16);
+    std::vector<Netero::Profiler::Event> events;
+    std::thread                          thread([&events]() {
+        Netero::Profiler::SetThreadName("profiler_ring");
+        for (int idx = 0; idx < 40; ++idx) {
+            NETERO_PROFILE_FUNCTION();
+        }
+        events = CollectCurrentThread("profiler_ring");
+    });
+    thread.join();
+    Netero::Profiler::SetBufferCapacity(65536);
+    EXPECT_GE(events.size(), 15);
+    EXPECT_LE(events.size(), 16);
+    for (std::size_t idx = 1; idx < events.size(); ++idx) {
+        EXPECT_LE(events[idx - 1].end, events[idx].begin);
+    }
+}
+
+TEST(NeteroCore, profiler_chrome_trace)
+{
+    Netero::Profiler::Clear();
+    Netero::Profiler::SetThreadName("chrome \"trace\"");
+    Netero::Profiler::Record("Frame",
+                             Netero::Clock::time_point(std::chrono::nanoseconds(1500)),
+                             Netero::Clock::time_point(std::chrono::nanoseconds(4250)));
+    std::ostringstream output;
+    Netero::Profiler::WriteChromeTrace(output);
+    const std::string trace = output.str();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"chrome \\\"trace\\\"\"}"), std::string::npos);
+    EXPECT_NE(trace.find("{\"name\":\"Frame\",\"cat\":\"netero\",\"ph\":\"X\",\"ts\":1.500,"
+                         "\"dur\":2.750,"),
+              std::string::npos);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+}
+
+TEST(NeteroCore, profiler_counters)
+{
+    Netero::Profiler::Clear();
+    Netero::Profiler::SetThreadName("profiler_counters");
+    Netero::PerfCounters::Sample counters;
+    counters.availableMask = 0b00011;
+    counters.values = { 2000, 3000, 0, 0, 0 };
+    Netero::Profiler::Record("Counted",
+                             Netero::Clock::time_point(std::chrono::nanoseconds(1000)),
+                             Netero::Clock::time_point(std::chrono::nanoseconds(2000)),
+                             counters);
+    const auto events = CollectCurrentThread("profiler_counters");
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].counters.availableMask, 0b00011u);
+    EXPECT_EQ(events[0].counters.Get(Netero::PerfCounters::Event::INSTRUCTIONS), 3000u);
+    std::ostringstream output;
+    Netero::Profiler::WriteChromeTrace(output);
+    EXPECT_NE(output.str().find(",\"args\":{\"cycles\":2000,\"instructions\":3000,\"ipc\":1.5}}"),
+              std::string::npos);
+
+    // Enabled counters are recorded only when the platform let us open them.
+    Netero::Profiler::Clear();
+    Netero::Profiler::SetCountersEnabled(true);
+    Nested();
+    Netero::Profiler::SetCountersEnabled(false);
+    const auto counted = CollectCurrentThread("profiler_counters");
+    ASSERT_EQ(counted.size(), 2);
+    const auto& threadCounters = Netero::PerfCounters::GetThreadCounters();
+    for (std::size_t idx = 0; idx < Netero::PerfCounters::eventCount; ++idx) {
+        const auto event = static_cast<Netero::PerfCounters::Event>(idx);
+        EXPECT_EQ(counted[1].counters.IsAvailable(event), threadCounters.IsAvailable(event));
+    }
+}
@@ -0,0 +1,151 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Netero/Task.hpp>
+
+#include <gtest/gtest.h>
+
+using Netero::Task;
+
+static Task<int> Square(int value)
+{
+    co_return value * value;
+}
+
+static Task<int> SumOfSquares(int count)
+{
+    int sum = 0;
+    for (int idx = 1; idx <= count; ++idx) {
+        sum += co_await Square(idx);
+    }
+    co_return sum;
+}
+
+static Task<void> Throw()
+{
+    throw std::runtime_error("task failure");
+    co_return;
+}
+
+TEST(NeteroCore, task_sync_wait)
+{
+    EXPECT_EQ(Netero::SyncWait(SumOfSquares(10)), 385);
+    EXPECT_THROW(Netero::SyncWait(Throw()), std::runtime_error);
+
+    auto task = Square(3);
+    EXPECT_TRUE(task.IsValid());
+    EXPECT_FALSE(task.IsDone());
+    EXPECT_EQ(Netero::SyncWait(std::move(task)), 9);
+}
+
+static Task<std::chrono::nanoseconds> Sleep(std::chrono::milliseconds duration)
+{
+    const auto start = std::chrono::steady_clock::now();
+    co_await Netero::Delay(duration);
+    co_return std::chrono::steady_clock::now() - start;
+}
+
+TEST(NeteroCore, task_delay)
+{
+    const auto elapsed = Netero::SyncWait(Sleep(std::chrono::milliseconds(20)));
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+}
+
+static Task<std::string> Name()
+{
+    co_await Netero::Delay(std::chrono::milliseconds(5));
+    co_return "netero";
+}
+
+static Task<void> Increment(std::atomic<int>& value)
+{
+    value += 1;
+    co_return;
+}
+
+TEST(NeteroCore, task_when_all)
+{
+    std::atomic<int> counter = 0;
+    auto [square, nothing, name] =
+        Netero::SyncWait(Netero::WhenAll(Square(4), Increment(counter), Name()));
+    EXPECT_EQ(square, 16);
+    EXPECT_EQ(counter, 1);
+    EXPECT_EQ(name, "netero");
+    (void)nothing;
+
+    std::vector<Task<int>> tasks;
+    for (int idx = 0; idx < 32; ++idx) {
+        tasks.push_back(Square(idx));
+    }
+    const auto results = Netero::SyncWait(Netero::WhenAll(std::move(tasks)));
+    ASSERT_EQ(results.size(), 32);
+    for (int idx = 0; idx < 32; ++idx) {
+        EXPECT_EQ(results[idx], idx * idx);
+    }
+
+    std::vector<Task<void>> failing;
+    failing.push_back(Increment(counter));
+    failing.push_back(Throw());
+    EXPECT_THROW(Netero::SyncWait(Netero::WhenAll(std::move(failing))), std::runtime_error);
+    EXPECT_EQ(counter, 2);
+}
+
+static Task<bool> RoundTrip(Netero::IoService& io, const char* path)
+{
+    auto file = Netero::IoService::OpenFile(path, true);
+    if (!Netero::IoService::IsValid(file)) {
+        co_return false;
+    }
+    const std::string content = "coroutine file content";
+    const auto written = co_await Netero::WriteAsync(io, file, content.data(), content.size(), 0);
+    std::vector<char> buffer(content.size());
+    const auto        read = co_await Netero::ReadAsync(io, file, buffer.data(), buffer.size(), 0);
+    Netero::IoService::CloseFile(file);
+    co_return written == static_cast<std::int64_t>(content.size()) && read == written &&
+        std::memcmp(buffer.data(), content.data(), content.size()) == 0;
+}
+
+TEST(NeteroCore, task_async_io)
+{
+    const char*       path = "netero_task_io.bin";
+    Netero::IoService io;
+    EXPECT_TRUE(Netero::SyncWait(RoundTrip(io, path)));
+    std::remove(path);
+}
+
+TEST(NeteroCore, task_spawn)
+{
+    std::atomic<int> counter = 0;
+    for (int idx = 0; idx < 8; ++idx) {
+        Netero::Spawn(Increment(counter));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (counter < 8 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(counter, 8);
+}
+
+TEST(NeteroCore, task_frame_pool)
+{
+    void* first = Netero::Detail::AllocateFrame(200);
+    Netero::Detail::DeallocateFrame(first, 200);
+    void* second = Netero::Detail::AllocateFrame(250);
+    EXPECT_EQ(first, second);
+    Netero::Detail::DeallocateFrame(second, 250);
+
+    void* large = Netero::Detail::AllocateFrame(1 << 16);
+    EXPECT_NE(large, nullptr);
+    Netero::Detail::DeallocateFrame(large, 1 << 16);
+}
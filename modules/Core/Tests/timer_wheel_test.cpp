@@ -0,0 +1,129 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Netero/TimerWheel.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(NeteroCore, timer_wheel_schedule)
+{
+    Netero::TimerWheel timers;
+    const auto         start = Netero::Clock::now();
+    int                fired = 0;
+    auto               handle = timers.Schedule(10ms, [&fired]() { fired += 1; });
+    const auto         scheduled = Netero::Clock::now();
+    EXPECT_TRUE(handle.IsValid());
+    EXPECT_TRUE(timers.IsPending(handle));
+    EXPECT_EQ(timers.GetPendingCount(), 1);
+
+    EXPECT_EQ(timers.Tick(start + 9ms), 0);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(timers.Tick(scheduled + 11ms), 1);
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(timers.IsPending(handle));
+    EXPECT_EQ(timers.GetPendingCount(), 0);
+    EXPECT_EQ(timers.Tick(scheduled + 100ms), 0);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(NeteroCore, timer_wheel_cancel)
+{
+    Netero::TimerWheel timers;
+    int                fired = 0;
+    auto               first = timers.Schedule(5ms, [&fired]() { fired += 1; });
+    auto               second = timers.Schedule(5ms, [&fired]() { fired += 10; });
+    EXPECT_TRUE(timers.Cancel(first));
+    EXPECT_FALSE(timers.Cancel(first));
+    EXPECT_EQ(timers.GetPendingCount(), 1);
+
+    // The released slot is reused, the stale handle must not cancel the new timer.
+    auto third = timers.Schedule(5ms, [&fired]() { fired += 100; });
+    EXPECT_EQ(third.index, first.index);
+    EXPECT_FALSE(timers.Cancel(first));
+    EXPECT_TRUE(timers.IsPending(third));
+
+    EXPECT_EQ(timers.Tick(Netero::Clock::now() + 10ms), 2);
+    EXPECT_EQ(fired, 110);
+    EXPECT_FALSE(timers.Cancel(second));
+    EXPECT_FALSE(timers.Cancel(Netero::TimerWheel::Handle {}));
+}
+
+TEST(NeteroCore, timer_wheel_cascade)
+{
+    Netero::TimerWheel      timers;
+    const auto              start = Netero::Clock::now();
+    const std::vector<long> delays = { 1, 254, 256, 258, 1000, 65534, 65536, 70000, 17000000 };
+    std::vector<long>       fired;
+    for (long delay : delays) {
+        timers.Schedule(std::chrono::milliseconds(delay), [&fired, delay]() {
+            fired.push_back(delay);
+        });
+    }
+    const auto scheduled = Netero::Clock::now();
+    // Advance in coarse steps, the wheel must walk every tick in between.
+    for (long delay : delays) {
+        EXPECT_EQ(timers.Tick(start + std::chrono::milliseconds(delay - 1)), 0) << delay;
+        EXPECT_EQ(timers.Tick(scheduled + std::chrono::milliseconds(delay + 1)), 1) << delay;
+    }
+    EXPECT_EQ(fired, delays);
+    EXPECT_EQ(timers.GetPendingCount(), 0);
+}
+
+TEST(NeteroCore, timer_wheel_periodic)
+{
+    Netero::TimerWheel timers;
+    int                fired = 0;
+    auto               handle = timers.SchedulePeriodic(10ms, [&fired]() { fired += 1; });
+    const auto         scheduled = Netero::Clock::now();
+    EXPECT_EQ(timers.Tick(scheduled + 55ms), 5);
+    EXPECT_TRUE(timers.IsPending(handle));
+    EXPECT_TRUE(timers.Cancel(handle));
+    EXPECT_EQ(timers.Tick(scheduled + 200ms), 0);
+    EXPECT_EQ(fired, 5);
+}
+
+TEST(NeteroCore, timer_wheel_reentrant_callback)
+{
+    Netero::TimerWheel timers;
+    int                fired = 0;
+    timers.Schedule(1ms, [&]() {
+        fired += 1;
+        timers.Schedule(1ms, [&fired]() { fired += 1; });
+    });
+    const auto start = Netero::Clock::now();
+    EXPECT_EQ(timers.Tick(start + 5ms), 1);
+    EXPECT_EQ(fired, 1);
+    // Scheduled from the callback, relative to the wheel time which is ahead of the clock.
+    EXPECT_EQ(timers.Tick(start + 7ms), 1);
+    EXPECT_EQ(fired, 2);
+}
+
+TEST(NeteroCore, timer_wheel_dedicated_thread)
+{
+    Netero::TimerWheel::Options options;
+    options.dedicatedThread = true;
+    Netero::TimerWheel timers(options);
+    std::atomic<int>   fired = 0;
+    const auto         start = std::chrono::steady_clock::now();
+    for (int idx = 1; idx <= 8; ++idx) {
+        timers.Schedule(std::chrono::milliseconds(idx * 5), [&fired]() { fired += 1; });
+    }
+    auto cancelled = timers.Schedule(20ms, [&fired]() { fired += 100; });
+    EXPECT_TRUE(timers.Cancel(cancelled));
+
+    const auto deadline = start + 5s;
+    while (fired < 8 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(fired, 8);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 40ms);
+}
@@ -27,3 +27,11 @@ TEST(NeteroCore, type_id_basic_usage)
     EXPECT_EQ(c, Netero::TypeID<BaseType>::GetTypeID<TypeC>());
     EXPECT_TRUE(a != b && b != c & c != a);
 }
+
+TEST(NeteroCore, type_id_name)
+{
+    EXPECT_EQ(Netero::GetTypeName<int>(), "int");
+    EXPECT_EQ(Netero::GetTypeName<TypeA>(), "TypeA");
+    EXPECT_NE(Netero::GetTypeName<std::string_view>().find("basic_string_view"),
+              std::string_view::npos);
+}
@@ -0,0 +1,79 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENSE.txt
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <Netero/WorkStealingDeque.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(NeteroCore, work_stealing_deque_owner)
+{
+    Netero::WorkStealingDeque<int> deque(2);
+    int                            item = 0;
+    EXPECT_FALSE(deque.Pop(item));
+    EXPECT_FALSE(deque.Steal(item));
+    for (int idx = 0; idx < 100; ++idx) {
+        deque.Push(idx);
+    }
+    EXPECT_EQ(deque.GetSize(), 100);
+    ASSERT_TRUE(deque.Pop(item));
+    EXPECT_EQ(item, 99);
+    ASSERT_TRUE(deque.Steal(item));
+    EXPECT_EQ(item, 0);
+    int count = 2;
+    while (deque.Pop(item)) {
+        count += 1;
+    }
+    EXPECT_EQ(count, 100);
+    EXPECT_TRUE(deque.IsEmpty());
+}
+
+TEST(NeteroCore, work_stealing_deque_concurrent)
+{
+    constexpr int                  itemCount = 100000;
+    Netero::WorkStealingDeque<int> deque(16);
+    std::vector<std::atomic<int>>  taken(itemCount);
+    std::atomic<int>               total = 0;
+    std::atomic<bool>              done = false;
+
+    std::vector<std::thread> thieves;
+    for (int idx = 0; idx < 3; ++idx) {
+        thieves.emplace_back([&]() {
+            int item = 0;
+            while (!done || !deque.IsEmpty()) {
+                if (deque.Steal(item)) {
+                    taken[item] += 1;
+                    total += 1;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    int item = 0;
+    for (int idx = 0; idx < itemCount; ++idx) {
+        deque.Push(idx);
+        if (idx % 3 == 0 && deque.Pop(item)) {
+            taken[item] += 1;
+            total += 1;
+        }
+    }
+    while (deque.Pop(item)) {
+        taken[item] += 1;
+        total += 1;
+    }
+    done = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    EXPECT_EQ(total, itemCount);
+    for (const auto& count : taken) {
+        ASSERT_EQ(count, 1);
+    }
+}
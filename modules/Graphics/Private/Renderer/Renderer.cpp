@@ -8,6 +8,8 @@
 #include "Renderer/Drawable/Drawable.hpp"
 #include "Vulkan/Buffer/Buffer.hpp"
 
+#include <Netero/Profiler.hpp>
+
 namespace Netero::Gfx {
 
 RendererImpl::RendererImpl(Context &aContext)
@@ -100,6 +102,7 @@ GfxResult RendererImpl::Update(Frame &)
 
 GfxResult RendererImpl::PresentFrame()
 {
+    NETERO_PROFILE_SCOPE("RendererImpl::PresentFrame");
     Frame frame;
     auto  result = mySwapchain.PrepareFrame(frame);
     if (result != GfxResult::SUCCESS) {
@@ -0,0 +1,315 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <algorithm>
+
+#include <Netero/ECS/Archetype.hpp>
+
+namespace Netero::ECS {
+
+namespace {
+
+    std::size_t AlignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Keep the chunk version the newest of its rows when a row is moved in.
+     */
+    void RaiseVersion(ChunkVersion &newest, const ComponentVersion &version) noexcept
+    {
+        if (IsNewerVersion(version.changed, newest.changed.load(std::memory_order_relaxed))) {
+            newest.changed.store(version.changed, std::memory_order_relaxed);
+        }
+        if (IsNewerVersion(version.added, newest.added.load(std::memory_order_relaxed))) {
+            newest.added.store(version.added, std::memory_order_relaxed);
+        }
+    }
+
+} // namespace
+
+std::byte *ChunkPool::Acquire(std::size_t bytes)
+{
+    if (bytes == Archetype::chunkSize && !_free.empty()) {
+        std::byte *block = _free.back();
+        _free.pop_back();
+        return block;
+    }
+    return static_cast<std::byte *>(::operator new(bytes, std::align_val_t(chunkAlignment)));
+}
+
+void ChunkPool::Release(std::byte *block, std::size_t bytes) noexcept
+{
+    if (bytes == Archetype::chunkSize) {
+        try {
+            _free.push_back(block);
+            return;
+        }
+        catch (const std::bad_alloc &) {
+        }
+    }
+    ::operator delete(block, std::align_val_t(chunkAlignment));
+}
+
+std::size_t ChunkPool::Trim() noexcept
+{
+    const std::size_t released = _free.size();
+    for (auto *block : _free) {
+        ::operator delete(block, std::align_val_t(chunkAlignment));
+    }
+    _free.clear();
+    _free.shrink_to_fit();
+    return released;
+}
+
+Archetype::Archetype(EntityTable &                      entities,
+                     ChunkPool &                        pool,
+                     std::vector<const ComponentInfo *> components)
+    : _entities(entities), _pool(pool), _components(std::move(components))
+{
+    std::size_t rowBytes = sizeof(EntityId);
+    std::size_t padding = 0;
+    for (std::size_t column = 0; column < _components.size(); ++column) {
+        const auto *component = _components[column];
+        _signature.insert(component->id);
+        _mask.Set(component->id);
+        if (component->id >= _columns.size()) {
+            _columns.resize(component->id + 1, npos);
+        }
+        _columns[component->id] = column;
+        rowBytes += component->size + sizeof(ComponentVersion);
+        padding += component->alignment + sizeof(ChunkVersion);
+    }
+    padding += alignof(ComponentVersion);
+    // At least one row per chunk, bigger chunks for the bigger rows.
+    _capacity = std::max<std::size_t>(1, (chunkSize - std::min(chunkSize, padding)) / rowBytes);
+    std::size_t offset = _capacity * sizeof(EntityId);
+    _chunkVersionOffset = AlignUp(offset, alignof(ChunkVersion));
+    offset = _chunkVersionOffset + _components.size() * sizeof(ChunkVersion);
+    for (const auto *component : _components) {
+        offset = AlignUp(offset, component->alignment);
+        _offsets.push_back(offset);
+        offset += _capacity * component->size;
+    }
+    _versionOffset = AlignUp(offset, alignof(ComponentVersion));
+    offset = _versionOffset + _components.size() * _capacity * sizeof(ComponentVersion);
+    _chunkBytes = AlignUp(std::max(offset, chunkSize), chunkAlignment);
+}
+
+Archetype::~Archetype()
+{
+    Clear();
+}
+
+void Archetype::Clear() noexcept
+{
+    for (auto &chunk : _chunks) {
+        for (std::size_t column = 0; column < _components.size(); ++column) {
+            std::byte *data = GetColumnData(chunk, column);
+            for (std::uint32_t row = 0; row < chunk.count; ++row) {
+                _components[column]->destroy(data + row * _components[column]->size);
+            }
+        }
+        _pool.Release(chunk.data, _chunkBytes);
+    }
+    _chunks.clear();
+    _size = 0;
+}
+
+void Archetype::Allocate(EntityId entity)
+{
+    if (_chunks.empty() || _chunks.back().count == _capacity) {
+        Chunk chunk;
+        chunk.data = _pool.Acquire(_chunkBytes);
+        for (std::size_t column = 0; column < _components.size(); ++column) {
+            new (&GetChunkVersion(chunk, column)) ChunkVersion();
+        }
+        _chunks.push_back(chunk);
+    }
+    Chunk &         chunk = _chunks.back();
+    EntityLocation &location = _entities[entity.index].location;
+    location.archetype = this;
+    location.chunk = static_cast<std::uint32_t>(_chunks.size() - 1);
+    location.row = chunk.count;
+    GetOwners(chunk)[chunk.count] = entity;
+    chunk.count += 1;
+    chunk.disabled += !_entities[entity.index].enabled;
+    _size += 1;
+}
+
+void Archetype::Release(EntityId entity, bool destroy)
+{
+    EntityLocation &    owner = _entities[entity.index].location;
+    Chunk &             chunk = _chunks[owner.chunk];
+    Chunk &             last = _chunks.back();
+    const std::uint32_t lastRow = last.count - 1;
+    const bool          isLast = &chunk == &last && owner.row == lastRow;
+    for (std::size_t column = 0; column < _components.size(); ++column) {
+        const auto *component = _components[column];
+        std::byte * hole = GetColumnData(chunk, column) + owner.row * component->size;
+        if (destroy) {
+            component->destroy(hole);
+        }
+        if (!isLast) {
+            std::byte *moved = GetColumnData(last, column) + lastRow * component->size;
+            component->moveConstruct(hole, moved);
+            component->destroy(moved);
+            const ComponentVersion &version = GetVersions(last, column)[lastRow];
+            GetVersions(chunk, column)[owner.row] = version;
+            RaiseVersion(GetChunkVersion(chunk, column), version);
+        }
+    }
+    chunk.disabled -= !_entities[entity.index].enabled;
+    if (!isLast) {
+        const EntityId  moved = GetOwners(last)[lastRow];
+        EntityLocation &movedLocation = _entities[moved.index].location;
+        const bool      movedDisabled = !_entities[moved.index].enabled;
+        last.disabled -= movedDisabled;
+        chunk.disabled += movedDisabled;
+        GetOwners(chunk)[owner.row] = moved;
+        movedLocation.chunk = owner.chunk;
+        movedLocation.row = owner.row;
+    }
+    last.count -= 1;
+    if (last.count == 0) {
+        _pool.Release(last.data, _chunkBytes);
+        _chunks.pop_back();
+    }
+    _size -= 1;
+    owner.archetype = nullptr;
+}
+
+void Archetype::SetEnabled(EntityId entity, bool enabled)
+{
+    EntityRecord &record = _entities[entity.index];
+    if (record.enabled == enabled) {
+        return;
+    }
+    record.enabled = enabled;
+    Chunk &chunk = _chunks[record.location.chunk];
+    if (enabled) {
+        chunk.disabled -= 1;
+    }
+    else {
+        chunk.disabled += 1;
+    }
+}
+
+void Archetype::MarkChanged(const EntityLocation &location,
+                            std::size_t           column,
+                            std::uint32_t         version,
+                            std::uint32_t         count) const noexcept
+{
+    const Chunk &     chunk = _chunks[location.chunk];
+    ComponentVersion *versions = GetVersions(chunk, column) + location.row;
+    for (std::uint32_t row = 0; row < count; ++row) {
+        versions[row].changed = version;
+    }
+    GetChunkVersion(chunk, column).changed.store(version, std::memory_order_relaxed);
+}
+
+void Archetype::MarkAdded(const EntityLocation &location,
+                          std::size_t           column,
+                          std::uint32_t         version,
+                          std::uint32_t         count) const noexcept
+{
+    const Chunk &     chunk = _chunks[location.chunk];
+    ComponentVersion *versions = GetVersions(chunk, column) + location.row;
+    for (std::uint32_t row = 0; row < count; ++row) {
+        versions[row].changed = version;
+        versions[row].added = version;
+    }
+    ChunkVersion &newest = GetChunkVersion(chunk, column);
+    newest.changed.store(version, std::memory_order_relaxed);
+    newest.added.store(version, std::memory_order_relaxed);
+}
+
+ArchetypeStorage::ArchetypeStorage(): _empty(&GetOrCreate({}))
+{
+}
+
+Archetype &ArchetypeStorage::GetOrCreate(std::vector<const ComponentInfo *> components)
+{
+    std::vector<Netero::type_id> key;
+    key.reserve(components.size());
+    for (const auto *component : components) {
+        key.push_back(component->id);
+    }
+    auto &archetype = _archetypes[key];
+    if (!archetype) {
+        archetype = std::make_unique<Archetype>(_entities, _pool, std::move(components));
+        _archetypeList.push_back(archetype.get());
+    }
+    return *archetype;
+}
+
+Archetype &ArchetypeStorage::GetArchetypeWith(Archetype &archetype, const ComponentInfo &component)
+{
+    auto edge = archetype._addEdges.find(component.id);
+    if (edge != archetype._addEdges.end()) {
+        return *edge->second;
+    }
+    auto components = archetype.GetComponents();
+    components.insert(std::upper_bound(components.begin(),
+                                       components.end(),
+                                       &component,
+                                       [](const ComponentInfo *lhs, const ComponentInfo *rhs) {
+                                           return lhs->id < rhs->id;
+                                       }),
+                      &component);
+    Archetype &target = GetOrCreate(std::move(components));
+    archetype._addEdges[component.id] = &target;
+    target._removeEdges[component.id] = &archetype;
+    return target;
+}
+
+Archetype &ArchetypeStorage::GetArchetypeWithout(Archetype &archetype, Netero::type_id component)
+{
+    auto edge = archetype._removeEdges.find(component);
+    if (edge != archetype._removeEdges.end()) {
+        return *edge->second;
+    }
+    auto components = archetype.GetComponents();
+    components.erase(std::remove_if(components.begin(),
+                                    components.end(),
+                                    [component](const ComponentInfo *info) {
+                                        return info->id == component;
+                                    }),
+                     components.end());
+    Archetype &target = GetOrCreate(std::move(components));
+    archetype._removeEdges[component] = &target;
+    target._addEdges[component] = &archetype;
+    return target;
+}
+
+void ArchetypeStorage::Move(EntityId entity, Archetype &target)
+{
+    EntityLocation &location = _entities[entity.index].location;
+    EntityLocation  source = location;
+    // Allocate first, the release may move the last row of the source in the hole.
+    target.Allocate(entity);
+    const EntityLocation destination = location;
+    location = source;
+    for (std::size_t column = 0; column < source.archetype->GetComponents().size(); ++column) {
+        const auto *component = source.archetype->GetComponents()[column];
+        void *      data = source.archetype->GetComponent(source, column);
+        const auto  targetColumn = target.GetColumn(component->id);
+        if (targetColumn != Archetype::npos) {
+            component->moveConstruct(target.GetComponent(destination, targetColumn), data);
+            const Chunk &           chunk = target.GetChunks()[destination.chunk];
+            const ComponentVersion &version =
+                source.archetype->GetVersions(source.archetype->GetChunks()[source.chunk],
+                                              column)[source.row];
+            target.GetVersions(chunk, targetColumn)[destination.row] = version;
+            RaiseVersion(target.GetChunkVersion(chunk, targetColumn), version);
+        }
+        component->destroy(data);
+    }
+    source.archetype->Release(entity, false);
+    location = destination;
+}
+
+} // namespace Netero::ECS
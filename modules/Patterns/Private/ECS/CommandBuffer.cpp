@@ -0,0 +1,91 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <atomic>
+
+#include <Netero/ECS/CommandBuffer.hpp>
+
+namespace Netero::ECS {
+
+CommandBuffer::CommandBuffer(): _pendingGeneration(NextPendingGeneration())
+{
+}
+
+CommandBuffer::~CommandBuffer()
+{
+    Clear();
+}
+
+Entity CommandBuffer::CreateEntity(const std::string &name)
+{
+    const EntityId id { _pendingEntities, _pendingGeneration };
+    _pendingEntities += 1;
+    _names.push_back(name);
+    Push(Command { Type::CREATE_ENTITY, id, nullptr, nullptr, _names.size() - 1 });
+    return Entity(nullptr, id);
+}
+
+void CommandBuffer::KillEntity(const Entity &entity)
+{
+    Push(Command { Type::KILL_ENTITY, entity.GetId(), nullptr, nullptr, 0 });
+}
+
+void CommandBuffer::EnableEntity(const Entity &entity)
+{
+    Push(Command { Type::ENABLE_ENTITY, entity.GetId(), nullptr, nullptr, 0 });
+}
+
+void CommandBuffer::DisableEntity(const Entity &entity)
+{
+    Push(Command { Type::DISABLE_ENTITY, entity.GetId(), nullptr, nullptr, 0 });
+}
+
+void CommandBuffer::Clear()
+{
+    for (const auto &command : _commands) {
+        if (command.payload) {
+            command.component->destroy(command.payload);
+        }
+    }
+    _commands.clear();
+    _names.clear();
+    _largeBlocks.clear();
+    _blockIndex = 0;
+    _blockOffset = 0;
+    _pendingEntities = 0;
+    _pendingGeneration = NextPendingGeneration();
+}
+
+std::uint32_t CommandBuffer::NextPendingGeneration() noexcept
+{
+    static std::atomic<std::uint32_t> recordings { 0 };
+    return EntityId::pendingFlag
+        | (recordings.fetch_add(1, std::memory_order_relaxed) & ~EntityId::pendingFlag);
+}
+
+void *CommandBuffer::Allocate(std::size_t size, std::size_t alignment)
+{
+    if (size > blockSize) {
+        _largeBlocks.emplace_back(
+            static_cast<std::byte *>(::operator new(size, std::align_val_t(blockAlignment))));
+        return _largeBlocks.back().get();
+    }
+    // Blocks are kept once the commands are cleared, the next frames reuse them.
+    std::size_t offset = (_blockOffset + alignment - 1) / alignment * alignment;
+    if (_blockIndex == _blocks.size() || offset + size > blockSize) {
+        if (_blockIndex < _blocks.size()) {
+            _blockIndex += 1;
+        }
+        if (_blockIndex == _blocks.size()) {
+            _blocks.emplace_back(static_cast<std::byte *>(
+                ::operator new(blockSize, std::align_val_t(blockAlignment))));
+        }
+        offset = 0;
+    }
+    _blockOffset = offset + size;
+    return _blocks[_blockIndex].get() + offset;
+}
+
+} // namespace Netero::ECS
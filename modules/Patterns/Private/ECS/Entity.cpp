@@ -8,81 +8,55 @@
 
 namespace Netero::ECS {
 
-Entity::Entity(): _base(nullptr)
+const std::string &Entity::GetName() const
 {
+    static const std::string unnamed = "unnamed";
+    if (!Valid())
+        throw std::runtime_error("Entity is not alive.");
+    auto name = _world->_names.find(_id.index);
+    return name == _world->_names.end() ? unnamed : name->second;
 }
 
-Entity::Entity(const Entity &rhs)
-{
-    _base = rhs._base;
-}
-
-Entity::Entity(EntityContainer *entityContainer)
-{
-    _base = entityContainer;
-}
-
-Entity &Entity::operator=(EntityContainer *rhs)
-{
-    _base = rhs;
-    return *this;
-}
-
-Entity &Entity::operator=(const Entity &rhs)
-{
-    _base = rhs._base;
-    return *this;
-}
-
-Entity &Entity::operator=(Entity &&rhs) noexcept
-{
-    _base = rhs._base;
-    rhs._base = nullptr;
-    return *this;
-}
-
-EntityContainer *Entity::operator->()
-{
-    return _base;
-}
-
-bool Entity::operator==(const Entity &rhs)
-{
-    return _base == rhs._base;
-}
-
-bool Entity::operator==(const EntityContainer *rhs)
+bool Entity::Valid() const noexcept
 {
-    return _base == rhs;
+    return _world && _world->IsAlive(*this);
 }
 
-bool Entity::Valid() const noexcept
+bool Entity::IsEnabled() const
 {
-    return _base != nullptr;
+    return _world->_getRecord(_id).enabled;
 }
 
 void Entity::Enable()
 {
-    if (_base) {
-        _base->GetWorld()->EnableEntity(*this);
+    if (_world) {
+        _world->EnableEntity(*this);
     }
 }
 
 void Entity::Disable()
 {
-    if (_base) {
-        _base->GetWorld()->DisableEntity(*this);
+    if (_world) {
+        _world->DisableEntity(*this);
     }
 }
 
 void Entity::Unregister()
 {
-    _base = nullptr;
+    _world = nullptr;
+    _id = EntityId();
 }
 
 void Entity::Kill()
 {
-    auto *entityWorld = this->_base->GetWorld();
-    entityWorld->KillEntity(*this);
+    if (_world) {
+        _world->KillEntity(*this);
+    }
 }
+
+const Netero::Set<Netero::type_id> &Entity::GetComponentsFilter() const
+{
+    return _world->_getRecord(_id).location.archetype->GetSignature();
+}
+
 } // namespace Netero::ECS
@@ -0,0 +1,57 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <Netero/ECS/Query.hpp>
+
+namespace Netero::ECS {
+
+Query::Query(const ComponentMask &               include,
+             const ComponentMask &               exclude,
+             const std::atomic<std::uint32_t> &version)
+    : _include(include), _exclude(exclude), _version(version)
+{
+}
+
+void Query::Insert(const Entity &entity, bool enabled)
+{
+    const std::uint32_t index = entity.GetId().index;
+    if (index >= _slots.size()) {
+        _slots.resize(index + 1);
+    }
+    auto &list = GetList(enabled);
+    _slots[index].position = static_cast<std::uint32_t>(list.size());
+    _slots[index].enabled = enabled;
+    list.push_back(entity);
+}
+
+void Query::Erase(EntityId entity)
+{
+    Slot &slot = _slots[entity.index];
+    auto &list = GetList(slot.enabled);
+    list[slot.position] = list.back();
+    _slots[list.back().GetId().index].position = slot.position;
+    list.pop_back();
+    slot.position = npos;
+}
+
+void Query::SetEnabled(EntityId entity, bool enabled)
+{
+    const Slot slot = _slots[entity.index];
+    if (slot.enabled == enabled) {
+        return;
+    }
+    const Entity handle = GetList(slot.enabled)[slot.position];
+    Erase(entity);
+    Insert(handle, enabled);
+}
+
+void Query::Clear() noexcept
+{
+    _activeEntities.clear();
+    _unactiveEntities.clear();
+    _slots.clear();
+}
+
+} // namespace Netero::ECS
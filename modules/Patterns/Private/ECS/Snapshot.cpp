@@ -0,0 +1,393 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <Netero/ECS/Snapshot.hpp>
+#include <Netero/ECS/World.hpp>
+#include <Netero/Profiler.hpp>
+
+namespace Netero::ECS {
+
+namespace {
+
+    constexpr std::uint32_t g_magic = 0x5343454E; /**< "NECS" */
+    constexpr std::uint32_t g_format = 1;
+    constexpr std::size_t   g_blockAlignment = 64;
+
+    static_assert(std::is_trivially_copyable<EntityRecord>::value,
+                  "Entity records are copied as raw bytes.");
+    static_assert(std::is_trivially_copyable<EntityId>::value,
+                  "Entity ids are copied as raw bytes.");
+
+    /**
+     * Layout: Header, TypeHeader and name of each type, then aligned on g_blockAlignment
+     * the entity records, the free list, the NameHeader and name of each named entity,
+     * then for each archetype its ArchetypeHeader and type indexes, its owners and one
+     * block per column, each aligned.
+     */
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t format;
+        std::uint32_t recordSize; /**< sizeof(EntityRecord), differ between platforms. */
+        std::uint32_t typeCount;
+        std::uint32_t archetypeCount;
+        std::uint32_t nameCount;
+        std::uint64_t recordCount;
+        std::uint64_t freeCount;
+    };
+
+    struct TypeHeader {
+        std::uint32_t version;
+        std::uint32_t size;
+        std::uint32_t alignment;
+        std::uint32_t nameLength;
+    };
+
+    struct NameHeader {
+        std::uint32_t index;
+        std::uint32_t length;
+    };
+
+    struct ArchetypeHeader {
+        std::uint32_t componentCount;
+        std::uint32_t rowCount;
+    };
+
+    /**
+     * @brief Append to a buffer sized beforehand, or only measure if the buffer is null.
+     */
+    class Writer {
+        public:
+        explicit Writer(std::byte *buffer) noexcept: _buffer(buffer) {}
+
+        void Write(const void *data, std::size_t size) noexcept
+        {
+            if (_buffer && size) {
+                std::memcpy(_buffer + _offset, data, size);
+            }
+            _offset += size;
+        }
+
+        template<typename T>
+        void WriteValue(const T &value) noexcept
+        {
+            Write(&value, sizeof(T));
+        }
+
+        void Align(std::size_t alignment) noexcept
+        {
+            const std::size_t aligned = (_offset + alignment - 1) / alignment * alignment;
+            if (_buffer) {
+                std::memset(_buffer + _offset, 0, aligned - _offset);
+            }
+            _offset = aligned;
+        }
+
+        [[nodiscard]] std::size_t GetOffset() const noexcept { return _offset; }
+
+        private:
+        std::byte * _buffer;
+        std::size_t _offset = 0;
+    };
+
+    /**
+     * @brief Bound checked view on a snapshot.
+     */
+    class Reader {
+        public:
+        explicit Reader(const std::vector<std::byte> &data) noexcept: _data(data) {}
+
+        /**
+         * @throw std::runtime_error if less than count T remain.
+         */
+        template<typename T>
+        const T *ReadArray(std::uint64_t count)
+        {
+            if (count > (_data.size() - _offset) / sizeof(T))
+                throw std::runtime_error("Malformed snapshot.");
+            const std::byte *data = _data.data() + _offset;
+            _offset += static_cast<std::size_t>(count) * sizeof(T);
+            return reinterpret_cast<const T *>(data);
+        }
+
+        template<typename T>
+        T ReadValue()
+        {
+            T value;
+            std::memcpy(&value, ReadArray<std::byte>(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        void Align(std::size_t alignment)
+        {
+            const std::size_t aligned = (_offset + alignment - 1) / alignment * alignment;
+            if (aligned > _data.size())
+                throw std::runtime_error("Malformed snapshot.");
+            _offset = aligned;
+        }
+
+        private:
+        const std::vector<std::byte> &_data;
+        std::size_t                   _offset = 0;
+    };
+
+    /**
+     * @brief Archetype of a snapshot, components sorted by the ids of this program.
+     */
+    struct ArchetypeBlock {
+        std::vector<const ComponentInfo *> components;
+        std::vector<const std::byte *>     columns;
+        const EntityId *                   owners;
+        std::uint32_t                      rowCount;
+    };
+
+} // namespace
+
+void SnapshotRegistry::Add(const ComponentInfo &info,
+                           const std::string &  name,
+                           std::uint32_t        version)
+{
+    auto named = _byName.find(name);
+    if (named != _byName.end() && _entries[named->second].info != &info)
+        throw std::runtime_error("Snapshot component name already registered.");
+    if (info.id < _byId.size() && _byId[info.id] != npos && named == _byName.end())
+        throw std::runtime_error("Snapshot component already registered under another name.");
+    if (named != _byName.end()) {
+        _entries[named->second].version = version;
+        return;
+    }
+    if (info.id >= _byId.size()) {
+        _byId.resize(info.id + 1, npos);
+    }
+    _byId[info.id] = _entries.size();
+    _byName.emplace(name, _entries.size());
+    _entries.push_back(Entry { &info, name, version });
+}
+
+const SnapshotRegistry::Entry *SnapshotRegistry::Find(Netero::type_id id) const noexcept
+{
+    if (id >= _byId.size() || _byId[id] == npos) {
+        return nullptr;
+    }
+    return &_entries[_byId[id]];
+}
+
+const SnapshotRegistry::Entry *SnapshotRegistry::Find(std::string_view name) const noexcept
+{
+    auto entry = _byName.find(name);
+    return entry != _byName.end() ? &_entries[entry->second] : nullptr;
+}
+
+void Snapshot::Capture(const World &world, const SnapshotRegistry &registry)
+{
+    NETERO_PROFILE_SCOPE("Snapshot::Capture");
+    const ArchetypeStorage &storage = world._storage;
+    const EntityTable &     table = storage.GetEntities();
+    // Types are written in the order they are met, archetypes refer to them by index.
+    std::vector<const SnapshotRegistry::Entry *> types;
+    std::vector<std::uint32_t>                   typeIndexes; /**< By component id. */
+    std::vector<const Archetype *>               archetypes;
+    for (const auto *archetype : storage.GetArchetypes()) {
+        if (archetype->GetSize() == 0) {
+            continue;
+        }
+        archetypes.push_back(archetype);
+        for (const auto *component : archetype->GetComponents()) {
+            if (component->id >= typeIndexes.size()) {
+                typeIndexes.resize(component->id + 1, ~std::uint32_t(0));
+            }
+            if (typeIndexes[component->id] != ~std::uint32_t(0)) {
+                continue;
+            }
+            const auto *entry = registry.Find(component->id);
+            if (!entry)
+                throw std::runtime_error("Snapshot component is not registered.");
+            typeIndexes[component->id] = static_cast<std::uint32_t>(types.size());
+            types.push_back(entry);
+        }
+    }
+
+    const auto write = [&](Writer &writer) {
+        const auto &records = table.GetRecords();
+        const auto &free = table.GetFreeList();
+        writer.WriteValue(Header { g_magic,
+                                   g_format,
+                                   sizeof(EntityRecord),
+                                   static_cast<std::uint32_t>(types.size()),
+                                   static_cast<std::uint32_t>(archetypes.size()),
+                                   static_cast<std::uint32_t>(world._names.size()),
+                                   records.size(),
+                                   free.size() });
+        for (const auto *type : types) {
+            writer.WriteValue(TypeHeader { type->version,
+                                           static_cast<std::uint32_t>(type->info->size),
+                                           static_cast<std::uint32_t>(type->info->alignment),
+                                           static_cast<std::uint32_t>(type->name.size()) });
+            writer.Write(type->name.data(), type->name.size());
+        }
+        writer.Align(g_blockAlignment);
+        writer.Write(records.data(), records.size() * sizeof(EntityRecord));
+        writer.Write(free.data(), free.size() * sizeof(std::uint32_t));
+        for (const auto &[index, name] : world._names) {
+            writer.WriteValue(NameHeader { index, static_cast<std::uint32_t>(name.size()) });
+            writer.Write(name.data(), name.size());
+        }
+        for (const auto *archetype : archetypes) {
+            const auto &components = archetype->GetComponents();
+            writer.Align(g_blockAlignment);
+            writer.WriteValue(ArchetypeHeader { static_cast<std::uint32_t>(components.size()),
+                                                static_cast<std::uint32_t>(archetype->GetSize()) });
+            for (const auto *component : components) {
+                writer.WriteValue(typeIndexes[component->id]);
+            }
+            writer.Align(g_blockAlignment);
+            for (const auto &chunk : archetype->GetChunks()) {
+                writer.Write(archetype->GetOwners(chunk), chunk.count * sizeof(EntityId));
+            }
+            for (std::size_t column = 0; column < components.size(); ++column) {
+                writer.Align(g_blockAlignment);
+                for (const auto &chunk : archetype->GetChunks()) {
+                    writer.Write(archetype->GetColumnData(chunk, column),
+                                 chunk.count * components[column]->size);
+                }
+            }
+        }
+    };
+    Writer measure(nullptr);
+    write(measure);
+    _data.resize(measure.GetOffset());
+    Writer writer(_data.data());
+    write(writer);
+}
+
+void Snapshot::Restore(World &world, const SnapshotRegistry &registry) const
+{
+    NETERO_PROFILE_SCOPE("Snapshot::Restore");
+    // Everything is read and checked before the world is touched.
+    Reader       reader(_data);
+    const Header header = reader.ReadValue<Header>();
+    if (header.magic != g_magic || header.format != g_format
+        || header.recordSize != sizeof(EntityRecord))
+        throw std::runtime_error("Snapshot was not taken by this version of Netero.");
+    std::vector<const ComponentInfo *> types;
+    for (std::uint32_t idx = 0; idx < header.typeCount; ++idx) {
+        const auto             type = reader.ReadValue<TypeHeader>();
+        const std::string_view name(reader.ReadArray<char>(type.nameLength), type.nameLength);
+        const auto *           entry = registry.Find(name);
+        if (!entry)
+            throw std::runtime_error("Snapshot component is not registered.");
+        if (entry->version != type.version || entry->info->size != type.size
+            || entry->info->alignment != type.alignment)
+            throw std::runtime_error("Snapshot component registered with another version.");
+        types.push_back(entry->info);
+    }
+    reader.Align(g_blockAlignment);
+    const EntityRecord * records = reader.ReadArray<EntityRecord>(header.recordCount);
+    const std::uint32_t *free = reader.ReadArray<std::uint32_t>(header.freeCount);
+    for (std::uint64_t idx = 0; idx < header.freeCount; ++idx) {
+        if (free[idx] >= header.recordCount || records[free[idx]].alive)
+            throw std::runtime_error("Malformed snapshot.");
+    }
+    std::vector<std::pair<std::uint32_t, std::string_view>> names;
+    for (std::uint32_t idx = 0; idx < header.nameCount; ++idx) {
+        const auto name = reader.ReadValue<NameHeader>();
+        if (name.index >= header.recordCount)
+            throw std::runtime_error("Malformed snapshot.");
+        names.emplace_back(name.index,
+                           std::string_view(reader.ReadArray<char>(name.length), name.length));
+    }
+    std::vector<ArchetypeBlock> blocks(header.archetypeCount);
+    std::vector<bool>           allocated(static_cast<std::size_t>(header.recordCount), false);
+    std::uint64_t               rowCount = 0;
+    for (auto &block : blocks) {
+        reader.Align(g_blockAlignment);
+        const auto   archetype = reader.ReadValue<ArchetypeHeader>();
+        const auto * indexes = reader.ReadArray<std::uint32_t>(archetype.componentCount);
+        std::vector<std::pair<const ComponentInfo *, std::uint32_t>> columns;
+        for (std::uint32_t column = 0; column < archetype.componentCount; ++column) {
+            if (indexes[column] >= types.size())
+                throw std::runtime_error("Malformed snapshot.");
+            columns.emplace_back(types[indexes[column]], column);
+        }
+        reader.Align(g_blockAlignment);
+        block.rowCount = archetype.rowCount;
+        block.owners = reader.ReadArray<EntityId>(archetype.rowCount);
+        for (std::uint32_t row = 0; row < archetype.rowCount; ++row) {
+            const EntityId owner = block.owners[row];
+            if (owner.index >= header.recordCount || !records[owner.index].alive
+                || records[owner.index].generation != owner.generation || allocated[owner.index])
+                throw std::runtime_error("Malformed snapshot.");
+            allocated[owner.index] = true;
+        }
+        rowCount += archetype.rowCount;
+        std::vector<const std::byte *> data;
+        for (const auto &column : columns) {
+            reader.Align(g_blockAlignment);
+            data.push_back(reader.ReadArray<std::byte>(std::uint64_t(archetype.rowCount)
+                                                       * column.first->size));
+        }
+        // Columns follow the ids of this program, which may differ from the capture.
+        std::sort(columns.begin(), columns.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first->id < rhs.first->id;
+        });
+        for (std::size_t idx = 0; idx < columns.size(); ++idx) {
+            if (idx > 0 && columns[idx - 1].first == columns[idx].first)
+                throw std::runtime_error("Malformed snapshot.");
+            block.components.push_back(columns[idx].first);
+            block.columns.push_back(data[columns[idx].second]);
+        }
+    }
+    std::uint64_t aliveCount = 0;
+    std::size_t   enabledCount = 0;
+    for (std::uint64_t idx = 0; idx < header.recordCount; ++idx) {
+        if (records[idx].generation & EntityId::pendingFlag)
+            throw std::runtime_error("Malformed snapshot.");
+        aliveCount += records[idx].alive;
+        enabledCount += records[idx].alive && records[idx].enabled;
+    }
+    if (aliveCount != rowCount)
+        throw std::runtime_error("Malformed snapshot.");
+
+    ArchetypeStorage &storage = world._storage;
+    for (auto *archetype : storage.GetArchetypes()) {
+        archetype->Clear();
+    }
+    storage.GetEntities().Restore(records,
+                                  static_cast<std::size_t>(header.recordCount),
+                                  free,
+                                  static_cast<std::size_t>(header.freeCount));
+    const std::uint32_t version = world._changeVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+    for (const auto &block : blocks) {
+        Archetype &archetype = storage.GetOrCreate(block.components);
+        for (std::uint32_t row = 0; row < block.rowCount; ++row) {
+            archetype.Allocate(block.owners[row]);
+        }
+        // Rows were allocated in order in the empty archetype, chunk after chunk.
+        std::size_t first = 0;
+        for (std::uint32_t idx = 0; idx < archetype.GetChunks().size(); ++idx) {
+            const Chunk &        chunk = archetype.GetChunks()[idx];
+            const EntityLocation location { &archetype, idx, 0 };
+            for (std::size_t column = 0; column < block.components.size(); ++column) {
+                const std::size_t size = block.components[column]->size;
+                std::memcpy(archetype.GetColumnData(chunk, column),
+                            block.columns[column] + first * size,
+                            chunk.count * size);
+                archetype.MarkAdded(location, column, version, chunk.count);
+            }
+            first += chunk.count;
+        }
+    }
+    world._names.clear();
+    for (const auto &[index, name] : names) {
+        world._names.emplace(index, name);
+    }
+    world._enabledEntities = enabledCount;
+    world._resetQueries();
+}
+
+} // namespace Netero::ECS
@@ -0,0 +1,70 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <algorithm>
+
+#include <Netero/ECS/SystemGraph.hpp>
+
+namespace Netero::ECS {
+
+void SystemGraph::Build(const std::vector<SystemAccess> &accesses)
+{
+    _nodes.assign(accesses.size(), Node());
+    _pending = std::make_unique<std::atomic<std::size_t>[]>(accesses.size());
+    _depth = 0;
+    std::vector<std::size_t> levels(accesses.size(), 0);
+    for (std::size_t system = 0; system < accesses.size(); ++system) {
+        for (std::size_t previous = 0; previous < system; ++previous) {
+            if (accesses[system].ConflictWith(accesses[previous])) {
+                _nodes[system].dependencies.push_back(previous);
+                _nodes[previous].successors.push_back(system);
+                levels[system] = std::max(levels[system], levels[previous] + 1);
+            }
+        }
+        _depth = std::max(_depth, levels[system] + 1);
+    }
+}
+
+void SystemGraph::RunSequential(const std::function<void(std::size_t)> &task) const
+{
+    for (std::size_t system = 0; system < _nodes.size(); ++system) {
+        task(system);
+    }
+}
+
+void SystemGraph::RunParallel(Netero::JobSystem &                      jobs,
+                              const std::function<void(std::size_t)> &task)
+{
+    Netero::JobCounter counter;
+    for (std::size_t system = 0; system < _nodes.size(); ++system) {
+        _pending[system].store(_nodes[system].dependencies.size(), std::memory_order_relaxed);
+    }
+    for (std::size_t system = 0; system < _nodes.size(); ++system) {
+        if (_nodes[system].dependencies.empty()) {
+            Schedule(jobs, counter, task, system);
+        }
+    }
+    jobs.WaitFor(counter);
+}
+
+void SystemGraph::Schedule(Netero::JobSystem &                      jobs,
+                           Netero::JobCounter &                     counter,
+                           const std::function<void(std::size_t)> &task,
+                           std::size_t                              system)
+{
+    jobs.Run(
+        [this, &jobs, &counter, &task, system]() {
+            task(system);
+            // Successors are run before this job complete, the counter can not reach zero.
+            for (const auto successor : _nodes[system].successors) {
+                if (_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    Schedule(jobs, counter, task, successor);
+                }
+            }
+        },
+        &counter);
+}
+
+} // namespace Netero::ECS
@@ -6,110 +6,486 @@
 #include <algorithm>
 
 #include <Netero/ECS/World.hpp>
+#include <Netero/Profiler.hpp>
 
 namespace Netero::ECS {
 
 World::World()
+    : _commandBuffers(std::make_unique<Netero::PerWorker<CommandBuffer>>()),
+      _ownerThread(std::this_thread::get_id()),
+      _updateHistory(_statisticWindow),
+      _cacheRebuildHistory(_statisticWindow),
+      _updateDuration(
+          Netero::Metrics::Registry::GetDefault().GetHistogram("ecs.world.update.duration_ns")),
+      _cacheRebuildDuration(Netero::Metrics::Registry::GetDefault().GetHistogram(
+          "ecs.world.cache_rebuild.duration_ns"))
 {
 }
 
 World::~World()
 {
-    _deleteEntities();
-    for (auto &system : _systems) {
-        delete system.second;
+    for (auto *system : _systems) {
+        delete system;
     }
 }
 
-void World::_deleteEntities()
+EntityRecord &World::_getRecord(EntityId id)
 {
-    for (auto *e : _entitiesDisable) {
-        delete e;
-    }
-    for (auto *e : _entitiesEnable) {
-        delete e;
-    }
-    _entitiesDisable.clear();
-    _entitiesEnable.clear();
+    if (!_storage.GetEntities().IsAlive(id))
+        throw std::runtime_error("Entity is not alive.");
+    return _storage.GetEntities()[id.index];
+}
+
+const EntityRecord &World::_getRecord(EntityId id) const
+{
+    if (!_storage.GetEntities().IsAlive(id))
+        throw std::runtime_error("Entity is not alive.");
+    return _storage.GetEntities()[id.index];
 }
 
 Entity World::CreateEntity()
 {
     std::lock_guard<std::mutex> lock(_entityAllocatorLock);
-    auto                        newEntityContainer = new EntityContainer(this);
-    _entitiesDisable.insert(newEntityContainer);
-    Entity newEntity(newEntityContainer);
-    return newEntity;
+    const EntityId              id = _storage.GetEntities().Create();
+    _storage.GetEmptyArchetype().Allocate(id);
+    const Entity entity(this, id);
+    for (auto *query : _getQueries(_storage.GetEmptyArchetype())) {
+        query->Insert(entity, false);
+    }
+    return entity;
 }
 
 Entity World::CreateEntity(const std::string &name)
 {
+    Entity                      entity = CreateEntity();
     std::lock_guard<std::mutex> lock(_entityAllocatorLock);
-    auto                        newEntityContainer = new EntityContainer(this, name);
-    _entitiesDisable.insert(newEntityContainer);
-    return Entity(newEntityContainer);
+    _names[entity.GetId().index] = name;
+    return entity;
+}
+
+std::vector<Entity> World::CreateEntities(std::size_t count, const Entity &prototype, bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_entityAllocatorLock);
+    if (!IsAlive(prototype))
+        throw std::runtime_error("Entity is not alive.");
+    EntityTable &        table = _storage.GetEntities();
+    const EntityLocation source = table[prototype.GetId().index].location;
+    Archetype &          archetype = *source.archetype;
+    const auto &         components = archetype.GetComponents();
+    for (const auto *component : components) {
+        if (!component->fill)
+            throw std::runtime_error("Prototype components must be copy constructible.");
+    }
+    const auto &        queries = _getQueries(archetype);
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    while (entities.size() < count) {
+        // Rows allocated in the same chunk are contiguous, they are filled together.
+        EntityLocation first;
+        std::uint32_t  rows = 0;
+        do {
+            const EntityId id = table.Create();
+            table[id.index].enabled = enabled;
+            archetype.Allocate(id);
+            if (rows == 0) {
+                first = table[id.index].location;
+            }
+            rows += 1;
+            entities.emplace_back(this, id);
+        } while (entities.size() < count
+                 && archetype.GetChunks()[first.chunk].count < archetype.GetChunkCapacity());
+        for (std::size_t column = 0; column < components.size(); ++column) {
+            components[column]->fill(archetype.GetComponent(first, column),
+                                     archetype.GetComponent(source, column),
+                                     rows);
+            archetype.MarkAdded(first, column, GetChangeVersion(), rows);
+        }
+    }
+    for (const auto &entity : entities) {
+        for (auto *query : queries) {
+            query->Insert(entity, enabled);
+        }
+    }
+    _enabledEntities += enabled ? count : 0;
+    return entities;
 }
 
 void World::KillEntity(Entity &entity)
 {
     std::lock_guard<std::mutex> lock(_entityAllocatorLock);
-    entity.Disable();
-    auto entIt = std::find_if(_entitiesDisable.begin(),
-                              _entitiesDisable.end(),
-                              [&entity](EntityContainer *ent) { return entity == ent; });
-    if (entIt == _entitiesDisable.end())
+    if (!IsAlive(entity))
         return;
-    delete *entIt;
-    _entitiesDisable.erase(*entIt);
+    const EntityId id = entity.GetId();
+    EntityRecord & record = _storage.GetEntities()[id.index];
+    _enabledEntities -= record.enabled;
+    for (auto *query : _getQueries(*record.location.archetype)) {
+        query->Erase(id);
+    }
+    record.location.archetype->Release(id);
+    _storage.GetEntities().Destroy(id);
+    _names.erase(id.index);
     entity.Unregister();
 }
 
 void World::EnableEntity(Netero::ECS::Entity &entity)
 {
-    auto findIt = _entitiesDisable.find(
-        entity.operator->()); // TODO : create method to access the container properly
-    if (findIt == _entitiesDisable.end())
+    if (!IsAlive(entity))
+        return;
+    EntityRecord &record = _storage.GetEntities()[entity.GetId().index];
+    if (record.enabled)
         return;
-    _entitiesEnable.insert(*findIt);
-    _entitiesDisable.erase(*findIt);
-    entity->status = true;
+    _enabledEntities += 1;
+    record.location.archetype->SetEnabled(entity.GetId(), true);
+    for (auto *query : _getQueries(*record.location.archetype)) {
+        query->SetEnabled(entity.GetId(), true);
+    }
 }
 
 void World::DisableEntity(Netero::ECS::Entity &entity)
 {
-    auto findIt = _entitiesEnable.find(
-        entity.operator->()); // TODO : create method to access the container properly
-    if (findIt == _entitiesEnable.end())
+    if (!IsAlive(entity))
+        return;
+    EntityRecord &record = _storage.GetEntities()[entity.GetId().index];
+    if (!record.enabled)
         return;
-    _entitiesDisable.insert(*findIt);
-    _entitiesEnable.erase(*findIt);
-    entity->status = false;
+    _enabledEntities -= 1;
+    record.location.archetype->SetEnabled(entity.GetId(), false);
+    for (auto *query : _getQueries(*record.location.archetype)) {
+        query->SetEnabled(entity.GetId(), false);
+    }
+}
+
+bool World::IsAlive(const Entity &entity) const noexcept
+{
+    return entity.GetWorld() == this && _storage.GetEntities().IsAlive(entity.GetId());
 }
 
 std::size_t World::Size()
 {
-    return _entitiesDisable.size();
+    return _storage.GetEntities().GetSize();
 }
 
 World::Statistic &World::GetStatistic()
 {
-    _statistic.size = _entitiesEnable.size();
+    const EntityTable &table = _storage.GetEntities();
+    _statistic.size = _enabledEntities;
+    _statistic.activeEntities = _enabledEntities;
+    _statistic.unactiveEntities = table.GetSize() - _enabledEntities;
+    _statistic.garbadgeSize = table.GetCapacity() - table.GetSize();
+    _statistic.systems.clear();
+    for (const auto *system : _systems) {
+        _statistic.systems.push_back(SystemStatistic {
+            system->_name, system->_history.GetLast(), system->_matchedEntities });
+    }
     return _statistic;
 }
 
-void World::_generateCache()
+void World::SetStatisticWindow(std::size_t frames)
 {
-    for (auto &system : _systems) {
-        system.second->generateCache(_entitiesEnable);
+    _statisticWindow = frames;
+    _updateHistory.SetCapacity(frames);
+    _cacheRebuildHistory.SetCapacity(frames);
+    for (auto *system : _systems) {
+        system->_history.SetCapacity(frames);
     }
 }
 
+Query &World::GetQuery(const ComponentMask &include, const ComponentMask &exclude)
+{
+    auto &query = _queries[QueryKey(include, exclude)];
+    if (query) {
+        return *query;
+    }
+    // Archetypes never seen are resolved before the query exists, then it is added to them.
+    for (auto *archetype : _storage.GetArchetypes()) {
+        _getQueries(*archetype);
+    }
+    query = std::make_unique<Query>(include, exclude, _changeVersion);
+    for (auto *archetype : _storage.GetArchetypes()) {
+        if (!query->Match(archetype->GetMask())) {
+            continue;
+        }
+        query->AddArchetype(archetype);
+        _archetypeQueries[archetype].push_back(query.get());
+        for (const auto &chunk : archetype->GetChunks()) {
+            const EntityId *owners = archetype->GetOwners(chunk);
+            for (std::uint32_t row = 0; row < chunk.count; ++row) {
+                query->Insert(Entity(this, owners[row]),
+                              _storage.GetEntities()[owners[row].index].enabled);
+            }
+        }
+    }
+    return *query;
+}
+
+const std::vector<Query *> &World::_getQueries(Archetype &archetype)
+{
+    auto [entry, inserted] = _archetypeQueries.try_emplace(&archetype);
+    if (inserted) {
+        for (auto &query : _queries) {
+            if (query.second && query.second->Match(archetype.GetMask())) {
+                query.second->AddArchetype(&archetype);
+                entry->second.push_back(query.second.get());
+            }
+        }
+    }
+    return entry->second;
+}
+
+void World::_resetQueries()
+{
+    for (auto &query : _queries) {
+        query.second->Clear();
+    }
+    for (auto *archetype : _storage.GetArchetypes()) {
+        const auto &queries = _getQueries(*archetype);
+        if (queries.empty()) {
+            continue;
+        }
+        for (const auto &chunk : archetype->GetChunks()) {
+            const EntityId *owners = archetype->GetOwners(chunk);
+            for (std::uint32_t row = 0; row < chunk.count; ++row) {
+                const bool enabled = _storage.GetEntities()[owners[row].index].enabled;
+                for (auto *query : queries) {
+                    query->Insert(Entity(this, owners[row]), enabled);
+                }
+            }
+        }
+    }
+}
+
+void World::_moveEntity(EntityId id, Archetype &target)
+{
+    EntityRecord &record = _storage.GetEntities()[id.index];
+    const auto &  leaving = _getQueries(*record.location.archetype);
+    const auto &  entering = _getQueries(target);
+    _storage.Move(id, target);
+    for (auto *query : leaving) {
+        if (!query->Match(target.GetMask())) {
+            query->Erase(id);
+        }
+    }
+    for (auto *query : entering) {
+        if (!query->Contains(id)) {
+            query->Insert(Entity(this, id), record.enabled);
+        }
+    }
+}
+
+void *World::_addComponent(EntityId id, const ComponentInfo &component, void *source)
+{
+    EntityRecord &record = _storage.GetEntities()[id.index];
+    Archetype &   target = _storage.GetArchetypeWith(*record.location.archetype, component);
+    _moveEntity(id, target);
+    const std::size_t column = target.GetColumn(component.id);
+    void *            address = target.GetComponent(record.location, column);
+    component.moveConstruct(address, source);
+    target.MarkAdded(record.location, column, GetChangeVersion());
+    return address;
+}
+
+void World::_deleteComponent(EntityId id, Netero::type_id component)
+{
+    EntityRecord &record = _storage.GetEntities()[id.index];
+    _moveEntity(id, _storage.GetArchetypeWithout(*record.location.archetype, component));
+}
+
+void World::SetJobSystem(Netero::JobSystem &jobs)
+{
+    FlushCommands();
+    _jobs = &jobs;
+    _commandBuffers = std::make_unique<Netero::PerWorker<CommandBuffer>>(jobs);
+    for (auto *system : _systems) {
+        system->_jobs = &jobs;
+    }
+}
+
+Netero::JobSystem &World::GetJobSystem() const noexcept
+{
+    return _jobs ? *_jobs : Netero::JobSystem::GetDefault();
+}
+
+CommandBuffer &World::GetCommandBuffer()
+{
+    const std::thread::id thread = std::this_thread::get_id();
+    if (GetJobSystem().GetCurrentWorkerIndex() >= 0 || thread == _ownerThread) {
+        return _commandBuffers->Local();
+    }
+    // Any other thread would share the slot of the owner, it get a buffer of its own.
+    std::scoped_lock<std::mutex> lock(_foreignBuffersLock);
+    auto                         buffer = std::find_if(
+        _foreignBuffers.begin(), _foreignBuffers.end(), [thread](const auto &foreign) {
+            return foreign.first == thread;
+        });
+    if (buffer == _foreignBuffers.end()) {
+        _foreignBuffers.emplace_back(thread, std::make_unique<CommandBuffer>());
+        return *_foreignBuffers.back().second;
+    }
+    return *buffer->second;
+}
+
+void World::FlushCommands()
+{
+    NETERO_PROFILE_SCOPE("World::FlushCommands");
+    _commandBuffers->ForEach([this](CommandBuffer &buffer) {
+        if (!buffer.IsEmpty()) {
+            Playback(buffer);
+        }
+    });
+    std::scoped_lock<std::mutex> lock(_foreignBuffersLock);
+    for (auto &foreign : _foreignBuffers) {
+        if (!foreign.second->IsEmpty()) {
+            Playback(*foreign.second);
+        }
+    }
+}
+
+std::size_t World::TrimMemory()
+{
+    return _storage.GetChunkPool().Trim() * Archetype::chunkSize;
+}
+
+void World::Playback(CommandBuffer &buffer)
+{
+    std::vector<EntityId> created;
+    created.reserve(buffer._pendingEntities);
+    for (auto &command : buffer._commands) {
+        if (command.type == CommandBuffer::Type::CREATE_ENTITY) {
+            const std::string &name = buffer._names[command.name];
+            created.push_back((name.empty() ? CreateEntity() : CreateEntity(name)).GetId());
+            continue;
+        }
+        Entity entity(this, command.entity);
+        if (command.entity.IsPending()) {
+            // Pending entities of another buffer, or of a previous recording, are dropped.
+            if (command.entity.generation != buffer._pendingGeneration
+                || command.entity.index >= created.size()) {
+                continue;
+            }
+            entity = Entity(this, created[command.entity.index]);
+        }
+        if (!IsAlive(entity)) {
+            continue;
+        }
+        EntityRecord &record = _storage.GetEntities()[entity.GetId().index];
+        switch (command.type) {
+            case CommandBuffer::Type::KILL_ENTITY: KillEntity(entity); break;
+            case CommandBuffer::Type::ENABLE_ENTITY: EnableEntity(entity); break;
+            case CommandBuffer::Type::DISABLE_ENTITY: DisableEntity(entity); break;
+            case CommandBuffer::Type::ADD_COMPONENT: {
+                const ComponentInfo &info = *command.component;
+                Archetype &          archetype = *record.location.archetype;
+                if (archetype.Has(info.id)) {
+                    const std::size_t column = archetype.GetColumn(info.id);
+                    void *            address = archetype.GetComponent(record.location, column);
+                    info.destroy(address);
+                    info.moveConstruct(address, command.payload);
+                    archetype.MarkChanged(record.location, column, GetChangeVersion());
+                }
+                else {
+                    _addComponent(entity.GetId(), info, command.payload);
+                }
+                break;
+            }
+            case CommandBuffer::Type::DELETE_COMPONENT:
+                if (record.location.archetype->Has(command.component->id)) {
+                    _deleteComponent(entity.GetId(), command.component->id);
+                }
+                break;
+            default: break;
+        }
+    }
+    buffer.Clear();
+}
+
+void World::_addSystem(BaseSystem *system)
+{
+    auto previous = std::find_if(_systems.begin(), _systems.end(), [system](BaseSystem *it) {
+        return it->_typeId == system->_typeId;
+    });
+    if (previous != _systems.end()) {
+        delete *previous;
+        *previous = system;
+    }
+    else {
+        _systems.push_back(system);
+    }
+    _systemGraphDirty = true;
+}
+
+const BaseSystem *World::_findSystem(Netero::type_id id) const noexcept
+{
+    auto system = std::find_if(_systems.begin(), _systems.end(), [id](BaseSystem *it) {
+        return it->_typeId == id;
+    });
+    return system != _systems.end() ? *system : nullptr;
+}
+
+void World::_removeSystem(Netero::type_id id)
+{
+    auto system = std::find_if(_systems.begin(), _systems.end(), [id](BaseSystem *it) {
+        return it->_typeId == id;
+    });
+    if (system == _systems.end())
+        return;
+    delete *system;
+    _systems.erase(system);
+    _systemGraphDirty = true;
+}
+
+void World::_runSystem(std::size_t index)
+{
+    BaseSystem &system = *_systems[index];
+    system._matchedEntities = system._query->GetActiveEntities().size();
+    // Changes stamped from now on are newer than the previous run of every other system.
+    const std::uint32_t version = _changeVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+    system._runVersion = version;
+    const auto start = Netero::Clock::now();
+    {
+        const Detail::RunVersionScope scope(this, version);
+        system.exec();
+    }
+    const auto duration = Netero::Clock::now() - start;
+    system._duration->RecordDuration(duration);
+    system._history.RecordDuration(duration);
+    system._lastRunVersion = version;
+}
+
 void World::Update()
 {
-    _generateCache();
-    for (auto &system : _systems) {
-        system.second->exec();
+    NETERO_PROFILE_SCOPE("World::Update");
+    const auto start = Netero::Clock::now();
+    if (_systemGraphDirty) {
+        std::vector<SystemAccess> accesses;
+        accesses.reserve(_systems.size());
+        for (const auto *system : _systems) {
+            accesses.push_back(system->GetAccess());
+        }
+        _systemGraph.Build(accesses);
+        _systemGraphDirty = false;
+    }
+    const auto systemsStart = Netero::Clock::now();
+    const auto task = [this](std::size_t index) { _runSystem(index); };
+    if (_deterministic || _systemGraph.GetDepth() == _systems.size()) {
+        _systemGraph.RunSequential(task);
+    }
+    else {
+        _systemGraph.RunParallel(GetJobSystem(), task);
     }
+    // Played back commands and changes made until the next Update are newer than the run of
+    // the last system.
+    _changeVersion.fetch_add(1, std::memory_order_relaxed);
+    const auto systemsEnd = Netero::Clock::now();
+    FlushCommands();
+    const auto end = Netero::Clock::now();
+    const auto cacheRebuild = (systemsStart - start) + (end - systemsEnd);
+    _statistic.frame += 1;
+    _statistic.updateNs = static_cast<std::uint64_t>((end - start).count());
+    _statistic.cacheRebuildNs = static_cast<std::uint64_t>(cacheRebuild.count());
+    _updateDuration.RecordDuration(end - start);
+    _updateHistory.RecordDuration(end - start);
+    _cacheRebuildDuration.RecordDuration(cacheRebuild);
+    _cacheRebuildHistory.RecordDuration(cacheRebuild);
 }
 
 } // namespace Netero::ECS
@@ -0,0 +1,358 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Archetype.hpp
+ * @brief Chunked structure of arrays storage of the components.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Netero/ECS/Component.hpp>
+#include <Netero/ECS/ComponentMask.hpp>
+#include <Netero/ECS/EntityTable.hpp>
+#include <Netero/Set.hpp>
+#include <Netero/TypeId.hpp>
+
+namespace Netero::ECS {
+
+/**
+ * @brief Type erased operations of a component type.
+ * Any move constructible type can be a component, deriving from Component is not required.
+ */
+struct ComponentInfo {
+    Netero::type_id  id; /**< Dense id, see ComponentTypeID. */
+    std::size_t      size;
+    std::size_t      alignment;
+    std::string_view name;
+    void (*moveConstruct)(void *destination, void *source); /**< source is left to destroy. */
+    void (*destroy)(void *component);
+    /**
+     * @brief Copy construct count components from source, nullptr if the component is not
+     * copy constructible.
+     */
+    void (*fill)(void *destination, const void *source, std::size_t count);
+};
+
+template<typename T>
+constexpr auto GetFill() -> void (*)(void *, const void *, std::size_t)
+{
+    if constexpr (std::is_copy_constructible<T>::value) {
+        return [](void *destination, const void *source, std::size_t count) {
+            std::uninitialized_fill_n(
+                static_cast<T *>(destination), count, *static_cast<const T *>(source));
+        };
+    }
+    else {
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Alignment of the chunk blocks, the strictest alignment a component may require.
+ */
+inline constexpr std::size_t chunkAlignment = 64;
+
+template<typename T>
+const ComponentInfo &GetComponentInfo()
+{
+    static_assert(std::is_move_constructible<T>::value, "Component must be move constructible.");
+    static_assert(alignof(T) <= chunkAlignment,
+                  "Component alignment must not exceed the chunk alignment.");
+    static const ComponentInfo info {
+        ComponentTypeID::GetTypeID<T>(),
+        sizeof(T),
+        alignof(T),
+        Netero::GetTypeName<T>(),
+        [](void *destination, void *source) {
+            new (destination) T(std::move(*static_cast<T *>(source)));
+        },
+        [](void *component) { static_cast<T *>(component)->~T(); },
+        GetFill<T>()
+    };
+    return info;
+}
+
+/**
+ * @brief Fixed size block holding the components of up to GetChunkCapacity() entities,
+ * one contiguous array per component type.
+ */
+struct Chunk {
+    std::byte *   data = nullptr;
+    std::uint32_t count = 0;
+    std::uint32_t disabled = 0; /**< Rows of disabled entities, 0 if every row is enabled. */
+};
+
+/**
+ * @brief World versions of the last change and of the addition of a component.
+ * Versions grow with each system run and wrap around, compare them with IsNewerVersion.
+ */
+struct ComponentVersion {
+    std::uint32_t changed = 0;
+    std::uint32_t added = 0;
+};
+
+/**
+ * @brief Newest ComponentVersion of a column of a chunk, written concurrently when the
+ * rows of the chunk are updated in parallel.
+ */
+struct ChunkVersion {
+    std::atomic<std::uint32_t> changed { 0 };
+    std::atomic<std::uint32_t> added { 0 };
+};
+
+/**
+ * @brief true if version is more recent than since, correct across the wrap around as long
+ * as less than 2^31 versions separate them.
+ */
+constexpr bool IsNewerVersion(std::uint32_t version, std::uint32_t since) noexcept
+{
+    return static_cast<std::int32_t>(version - since) > 0;
+}
+
+/**
+ * @brief Free list of the chunk blocks released by the archetypes of a world.
+ * Entities spawned and killed by waves then reuse the same blocks instead of going back
+ * to the allocator. Blocks of another size than Archetype::chunkSize are not pooled.
+ */
+class ChunkPool {
+    public:
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool &) = delete;
+    ChunkPool &operator=(const ChunkPool &) = delete;
+    ~ChunkPool() { Trim(); }
+
+    [[nodiscard]] std::byte *Acquire(std::size_t bytes);
+    void                     Release(std::byte *block, std::size_t bytes) noexcept;
+
+    /**
+     * @brief Give the free blocks back to the allocator.
+     * @return Number of blocks released.
+     */
+    std::size_t Trim() noexcept;
+
+    [[nodiscard]] std::size_t GetFreeCount() const noexcept { return _free.size(); }
+
+    private:
+    std::vector<std::byte *> _free;
+};
+
+/**
+ * @brief Storage of the entities owning exactly the same component set.
+ * Entities are packed in chunks, rows are kept dense by moving the last row in the hole
+ * left by a removed entity, locations of the moved entity are updated in place.
+ */
+class Archetype {
+    public:
+    static constexpr std::size_t chunkSize = 16384; /**< In byte, a multiple of the page size. */
+    static constexpr std::size_t npos = ~std::size_t(0);
+
+    /**
+     * @param entities table updated when rows are moved.
+     * @param pool where the chunks are taken from and released to.
+     * @param components sorted by id.
+     */
+    Archetype(EntityTable &                      entities,
+              ChunkPool &                        pool,
+              std::vector<const ComponentInfo *> components);
+    Archetype(const Archetype &) = delete;
+    Archetype &operator=(const Archetype &) = delete;
+    ~Archetype();
+
+    [[nodiscard]] const Netero::Set<Netero::type_id> &GetSignature() const noexcept
+    {
+        return _signature;
+    }
+
+    /**
+     * @brief Signature as a bitset, what system filters are matched against.
+     */
+    [[nodiscard]] const ComponentMask &GetMask() const noexcept { return _mask; }
+
+    [[nodiscard]] const std::vector<const ComponentInfo *> &GetComponents() const noexcept
+    {
+        return _components;
+    }
+
+    /**
+     * @return The column of the component, npos if the archetype does not own it.
+     */
+    [[nodiscard]] std::size_t GetColumn(Netero::type_id id) const noexcept
+    {
+        return id < _columns.size() ? _columns[id] : npos;
+    }
+
+    [[nodiscard]] bool Has(Netero::type_id id) const noexcept { return GetColumn(id) != npos; }
+
+    [[nodiscard]] std::size_t GetChunkCapacity() const noexcept { return _capacity; }
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _size; }
+
+    [[nodiscard]] const std::vector<Chunk> &GetChunks() const noexcept { return _chunks; }
+
+    /**
+     * @brief First element of the column in the chunk, the rows follow contiguously.
+     */
+    [[nodiscard]] std::byte *GetColumnData(const Chunk &chunk, std::size_t column) const noexcept
+    {
+        return chunk.data + _offsets[column];
+    }
+
+    /**
+     * @brief Entities stored in the chunk, one per row.
+     */
+    [[nodiscard]] EntityId *GetOwners(const Chunk &chunk) const noexcept
+    {
+        return reinterpret_cast<EntityId *>(chunk.data);
+    }
+
+    /**
+     * @brief Versions of the rows of the column in the chunk.
+     */
+    [[nodiscard]] ComponentVersion *GetVersions(const Chunk &chunk, std::size_t column) const
+        noexcept
+    {
+        return reinterpret_cast<ComponentVersion *>(chunk.data + _versionOffset)
+            + column * _capacity;
+    }
+
+    /**
+     * @brief Newest version of the rows of the column, chunks without recent change are
+     * skipped whole by the Changed and Added filters.
+     */
+    [[nodiscard]] ChunkVersion &GetChunkVersion(const Chunk &chunk, std::size_t column) const
+        noexcept
+    {
+        return reinterpret_cast<ChunkVersion *>(chunk.data + _chunkVersionOffset)[column];
+    }
+
+    /**
+     * @brief Record a change of the component of count rows from location.
+     */
+    void MarkChanged(const EntityLocation &location,
+                     std::size_t           column,
+                     std::uint32_t         version,
+                     std::uint32_t         count = 1) const noexcept;
+
+    /**
+     * @brief Record the addition of the component of count rows from location, an added
+     * component is changed as well.
+     */
+    void MarkAdded(const EntityLocation &location,
+                   std::size_t           column,
+                   std::uint32_t         version,
+                   std::uint32_t         count = 1) const noexcept;
+
+    [[nodiscard]] const EntityTable &GetEntities() const noexcept { return _entities; }
+
+    [[nodiscard]] void *GetComponent(const EntityLocation &location, std::size_t column) const
+    {
+        return GetColumnData(_chunks[location.chunk], column)
+            + location.row * _components[column]->size;
+    }
+
+    /**
+     * @brief Reserve a row for the entity and update its location.
+     * The components and the versions of the row are left uninitialized.
+     */
+    void Allocate(EntityId entity);
+
+    /**
+     * @brief Release the row of the entity, the components are destroyed if destroy is set,
+     * otherwise they are expected to be moved out already.
+     */
+    void Release(EntityId entity, bool destroy = true);
+
+    /**
+     * @brief Enable or disable a live entity of the archetype.
+     */
+    void SetEnabled(EntityId entity, bool enabled);
+
+    /**
+     * @brief Destroy every row and give the chunks back to the pool, the locations of the
+     * entities are left untouched.
+     */
+    void Clear() noexcept;
+
+    private:
+    EntityTable &                      _entities;
+    ChunkPool &                        _pool;
+    std::vector<const ComponentInfo *> _components;
+    Netero::Set<Netero::type_id>       _signature;
+    ComponentMask                      _mask;
+    std::vector<std::size_t>           _columns; /**< By component id. */
+    std::vector<std::size_t>           _offsets; /**< Of the columns in a chunk. */
+    std::size_t                        _chunkVersionOffset = 0;
+    std::size_t                        _versionOffset = 0;
+    std::size_t                        _capacity = 0;
+    std::size_t                        _chunkBytes = 0;
+    std::size_t                        _size = 0;
+    std::vector<Chunk>                 _chunks;
+
+    friend class ArchetypeStorage;
+    std::map<Netero::type_id, Archetype *> _addEdges;    /**< Archetype with one more type. */
+    std::map<Netero::type_id, Archetype *> _removeEdges; /**< Archetype with one less type. */
+};
+
+/**
+ * @brief Entity table and archetypes of a world.
+ * Archetypes are created on demand and never released before the world.
+ */
+class ArchetypeStorage {
+    public:
+    ArchetypeStorage();
+    ArchetypeStorage(const ArchetypeStorage &) = delete;
+    ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+    [[nodiscard]] EntityTable &      GetEntities() noexcept { return _entities; }
+    [[nodiscard]] const EntityTable &GetEntities() const noexcept { return _entities; }
+
+    /**
+     * @brief Archetype without component, where new entities are created.
+     */
+    [[nodiscard]] Archetype &GetEmptyArchetype() noexcept { return *_empty; }
+
+    Archetype &GetArchetypeWith(Archetype &archetype, const ComponentInfo &component);
+    Archetype &GetArchetypeWithout(Archetype &archetype, Netero::type_id component);
+
+    /**
+     * @brief Move the entity and its components to another archetype.
+     * Components missing from the target are destroyed, the new ones are left uninitialized.
+     * Versions of the kept components follow them.
+     */
+    void Move(EntityId entity, Archetype &target);
+
+    [[nodiscard]] const std::vector<Archetype *> &GetArchetypes() const noexcept
+    {
+        return _archetypeList;
+    }
+
+    [[nodiscard]] ChunkPool &GetChunkPool() noexcept { return _pool; }
+
+    /**
+     * @brief Archetype owning exactly the components, sorted by id.
+     */
+    Archetype &GetOrCreate(std::vector<const ComponentInfo *> components);
+
+    private:
+
+    EntityTable                                                        _entities;
+    ChunkPool                                                          _pool;
+    std::map<std::vector<Netero::type_id>, std::unique_ptr<Archetype>> _archetypes;
+    std::vector<Archetype *>                                           _archetypeList;
+    Archetype *                                                        _empty;
+};
+
+} // namespace Netero::ECS
@@ -0,0 +1,128 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file CommandBuffer.hpp
+ * @brief Structural changes of a world recorded to be applied later.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Netero/ECS/Archetype.hpp>
+#include <Netero/ECS/Entity.hpp>
+#include <Netero/ECS/EntityTable.hpp>
+
+namespace Netero::ECS {
+
+/**
+ * @brief Record entity creations, kills, enabling and component changes, the world
+ * applies them in order when the buffer is played back.
+ * Systems record their structural changes in the buffer of their thread, see
+ * World::GetCommandBuffer, so they can run concurrently and keep iterating their entities.
+ * Entities created by the buffer are pending until the play back, their handle is only
+ * valid as the target of the commands of the same buffer until it is played back or
+ * cleared, commands targeting them from another buffer or a later recording are dropped.
+ * Commands targeting an entity dead at play back are dropped, adding a component the
+ * entity already own replace it and deleting a component it does not own is ignored.
+ */
+class CommandBuffer {
+    public:
+    CommandBuffer();
+    CommandBuffer(const CommandBuffer &) = delete;
+    CommandBuffer &operator=(const CommandBuffer &) = delete;
+    ~CommandBuffer();
+
+    /**
+     * @return Pending handle of the entity, see the class description.
+     */
+    Entity CreateEntity(const std::string &name = std::string());
+    void   KillEntity(const Entity &entity);
+    void   EnableEntity(const Entity &entity);
+    void   DisableEntity(const Entity &entity);
+
+    template<typename T, typename... Args>
+    void AddComponent(const Entity &entity, Args &&... args)
+    {
+        static_assert(alignof(T) <= blockAlignment, "Over aligned component can not be recorded.");
+        const ComponentInfo &info = GetComponentInfo<T>();
+        void *               payload = Allocate(sizeof(T), alignof(T));
+        new (payload) T { std::forward<Args>(args)... };
+        Push(Command { Type::ADD_COMPONENT, entity.GetId(), &info, payload, 0 });
+    }
+
+    template<typename T>
+    void DeleteComponent(const Entity &entity)
+    {
+        const ComponentInfo &info = GetComponentInfo<T>();
+        Push(Command { Type::DELETE_COMPONENT, entity.GetId(), &info, nullptr, 0 });
+    }
+
+    [[nodiscard]] bool        IsEmpty() const noexcept { return _commands.empty(); }
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _commands.size(); }
+
+    /**
+     * @brief Drop the recorded commands, the memory is kept for the next ones.
+     */
+    void Clear();
+
+    private:
+    friend class World;
+
+    static constexpr std::size_t blockSize = 16384;
+    static constexpr std::size_t blockAlignment = 64;
+
+    enum class Type : std::uint8_t {
+        CREATE_ENTITY,
+        KILL_ENTITY,
+        ENABLE_ENTITY,
+        DISABLE_ENTITY,
+        ADD_COMPONENT,
+        DELETE_COMPONENT
+    };
+
+    struct Command {
+        Type                 type;
+        EntityId             entity; /**< Pending index for the entities of the buffer. */
+        const ComponentInfo *component;
+        void *               payload; /**< Component to move in, destroyed by Clear. */
+        std::size_t          name;    /**< Index in _names for a creation. */
+    };
+
+    struct BlockDeleter {
+        void operator()(std::byte *block) const
+        {
+            ::operator delete(block, std::align_val_t(blockAlignment));
+        }
+    };
+
+    /**
+     * @brief Generation of the pending entities of a new recording, unique in the process
+     * until 2^31 recordings are made.
+     */
+    static std::uint32_t NextPendingGeneration() noexcept;
+
+    void  Push(const Command &command) { _commands.push_back(command); }
+    void *Allocate(std::size_t size, std::size_t alignment);
+
+    std::vector<Command>                                  _commands;
+    std::vector<std::string>                              _names;
+    std::vector<std::unique_ptr<std::byte, BlockDeleter>> _blocks;
+    std::vector<std::unique_ptr<std::byte, BlockDeleter>> _largeBlocks; /**< Over blockSize. */
+    std::size_t                                           _blockIndex = 0;
+    std::size_t                                           _blockOffset = 0;
+    std::uint32_t                                         _pendingEntities = 0;
+    std::uint32_t                                         _pendingGeneration;
+};
+
+} // namespace Netero::ECS
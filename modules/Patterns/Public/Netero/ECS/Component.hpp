@@ -9,6 +9,9 @@
 
 namespace Netero::ECS {
 
+/**
+ * @brief Optional base of the components, any move constructible type can be a component.
+ */
 class Component {
     public:
     virtual ~Component() = default;
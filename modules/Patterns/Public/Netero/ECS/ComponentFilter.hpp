@@ -6,11 +6,10 @@
 #pragma once
 
 #include <cstddef>
-#include <list>
 #include <type_traits>
 
 #include <Netero/ECS/Component.hpp>
-#include <Netero/ECS/ComponentFilter.hpp>
+#include <Netero/ECS/ComponentMask.hpp>
 #include <Netero/Set.hpp>
 
 namespace Netero::ECS {
@@ -19,44 +18,30 @@ struct BaseComponentFilter {
     virtual ~BaseComponentFilter() = 0;
 };
 
+/**
+ * @brief Compile time list of component types.
+ * Filters are built once, on first use, the initialisation is thread safe.
+ */
 template<typename... Args>
 class ComponentFilter: public BaseComponentFilter {
-    private:
-    template<typename Last>
-    static void Decomposer(Netero::Set<Netero::type_id> &filter)
-    {
-        static_assert(std::is_base_of<Component, Last>(), "Elem is not based on Component");
-        filter.insert(ComponentTypeID::GetTypeID<Last>());
-    }
-
-    template<typename First, typename Second, typename... Rest>
-    static void Decomposer(Set<Netero::type_id> &filter)
-    {
-        static_assert(std::is_base_of<Component, First>(), "Elem is not based on Component");
-        Decomposer<Second, Rest...>(filter);
-        filter.insert(ComponentTypeID::GetTypeID<First>());
-    }
-
     public:
     static const Set<Netero::type_id> &GetFilter()
     {
-        static Set<Netero::type_id> filter;
-        static bool                 isDecomposed = false;
-        if (!isDecomposed) {
-            Decomposer<Args...>(filter);
-            isDecomposed = true;
-        }
+        static const Set<Netero::type_id> filter { ComponentTypeID::GetTypeID<Args>()... };
         return filter;
     }
-};
 
-template<>
-class ComponentFilter<>: public BaseComponentFilter {
-    public:
-    static const Netero::Set<Netero::type_id> &GetFilter()
+    /**
+     * @brief Bit of each component id set, the filter as matched against the archetypes.
+     */
+    static const ComponentMask &GetMask()
     {
-        static Netero::Set<Netero::type_id> filter;
-        return filter;
+        static const ComponentMask mask = [] {
+            ComponentMask result;
+            (result.Set(ComponentTypeID::GetTypeID<Args>()), ...);
+            return result;
+        }();
+        return mask;
     }
 };
 
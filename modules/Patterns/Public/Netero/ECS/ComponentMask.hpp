@@ -0,0 +1,172 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file ComponentMask.hpp
+ * @brief Fixed width bitset of component ids.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <Netero/TypeId.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NETERO_ECS_MASK_SSE2
+#endif
+
+/**
+ * @brief Number of component types a program can use, a multiple of 128.
+ * Configured by the NETERO_ECS_MAX_COMPONENTS cmake cache variable.
+ */
+#if !defined(NETERO_ECS_MAX_COMPONENTS)
+#define NETERO_ECS_MAX_COMPONENTS 256
+#endif
+
+namespace Netero::ECS {
+
+/**
+ * @brief One bit per component id, the signature of an archetype or a system filter.
+ * Matching a filter is a handful of 128 bits AND and compare, whatever the number of
+ * components, instead of a set lookup per component.
+ */
+template<std::size_t Bits>
+class BasicComponentMask {
+    static_assert(Bits > 0 && Bits % 128 == 0, "Mask width must be a multiple of 128 bits.");
+
+    public:
+    static constexpr std::size_t bitCount = Bits;
+    static constexpr std::size_t wordCount = Bits / 64;
+
+    void Set(Netero::type_id id)
+    {
+        CheckId(id);
+        _words[id / 64] |= std::uint64_t(1) << (id % 64);
+    }
+
+    void Reset(Netero::type_id id)
+    {
+        CheckId(id);
+        _words[id / 64] &= ~(std::uint64_t(1) << (id % 64));
+    }
+
+    [[nodiscard]] bool Test(Netero::type_id id) const noexcept
+    {
+        return id < Bits && (_words[id / 64] >> (id % 64)) & 1u;
+    }
+
+    /**
+     * @brief true if every bit of other is set in this mask.
+     */
+    [[nodiscard]] bool Contains(const BasicComponentMask &other) const noexcept
+    {
+#if defined(NETERO_ECS_MASK_SSE2)
+        for (std::size_t idx = 0; idx < wordCount; idx += 2) {
+            const __m128i lhs = Load(idx);
+            const __m128i rhs = other.Load(idx);
+            const __m128i masked = _mm_and_si128(lhs, rhs);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(masked, rhs)) != 0xFFFF) {
+                return false;
+            }
+        }
+        return true;
+#else
+        for (std::size_t idx = 0; idx < wordCount; ++idx) {
+            if ((_words[idx] & other._words[idx]) != other._words[idx]) {
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+    /**
+     * @brief true if at least one bit is set in both masks.
+     */
+    [[nodiscard]] bool Intersects(const BasicComponentMask &other) const noexcept
+    {
+#if defined(NETERO_ECS_MASK_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (std::size_t idx = 0; idx < wordCount; idx += 2) {
+            const __m128i masked = _mm_and_si128(Load(idx), other.Load(idx));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(masked, zero)) != 0xFFFF) {
+                return true;
+            }
+        }
+        return false;
+#else
+        for (std::size_t idx = 0; idx < wordCount; ++idx) {
+            if (_words[idx] & other._words[idx]) {
+                return true;
+            }
+        }
+        return false;
+#endif
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        for (const auto word : _words) {
+            if (word) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    BasicComponentMask &operator|=(const BasicComponentMask &other) noexcept
+    {
+        for (std::size_t idx = 0; idx < wordCount; ++idx) {
+            _words[idx] |= other._words[idx];
+        }
+        return *this;
+    }
+
+    bool operator==(const BasicComponentMask &other) const noexcept
+    {
+        return _words == other._words;
+    }
+    bool operator!=(const BasicComponentMask &other) const noexcept { return !(*this == other); }
+
+    /**
+     * @brief Strict weak order, masks can be used as map keys.
+     */
+    bool operator<(const BasicComponentMask &other) const noexcept
+    {
+        return _words < other._words;
+    }
+
+    [[nodiscard]] const std::array<std::uint64_t, wordCount> &GetWords() const noexcept
+    {
+        return _words;
+    }
+
+    private:
+    static void CheckId(Netero::type_id id)
+    {
+        if (id >= Bits) {
+            throw std::length_error(
+                "Too many component types, raise NETERO_ECS_MAX_COMPONENTS.");
+        }
+    }
+
+#if defined(NETERO_ECS_MASK_SSE2)
+    [[nodiscard]] __m128i Load(std::size_t word) const noexcept
+    {
+        return _mm_load_si128(reinterpret_cast<const __m128i *>(_words.data() + word));
+    }
+#endif
+
+    alignas(16) std::array<std::uint64_t, wordCount> _words {};
+};
+
+using ComponentMask = BasicComponentMask<NETERO_ECS_MAX_COMPONENTS>;
+
+} // namespace Netero::ECS
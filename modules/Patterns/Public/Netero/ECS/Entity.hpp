@@ -5,112 +5,86 @@
 
 #pragma once
 
-#include <algorithm>
-#include <cstddef>
-#include <exception>
-#include <list>
-#include <map>
 #include <string>
 
-#include <Netero/ECS/Component.hpp>
+#include <Netero/ECS/EntityTable.hpp>
 #include <Netero/Set.hpp>
+#include <Netero/TypeId.hpp>
 
 namespace Netero::ECS {
 
 class World;
 
-class EntityContainer {
-    struct id {
-        std::string name;
-    };
-
+/**
+ * @brief Handle on an entity of a world, cheap to copy.
+ * The handle hold the generational id of the entity, once the entity is killed every
+ * copy of the handle become invalid, even if its slot is reused by a new entity.
+ * Components are reached through operator-> for compatibility: entity->GetComponent<T>().
+ */
+class Entity {
     public:
-    friend World;
-    ~EntityContainer();
+    Entity() = default;
+    Entity(World *world, EntityId id) noexcept: _world(world), _id(id) {}
 
-    World *GetWorld();
+    bool operator==(const Entity &rhs) const noexcept
+    {
+        return _world == rhs._world && _id == rhs._id;
+    }
+    bool operator!=(const Entity &rhs) const noexcept { return !(*this == rhs); }
+
+    Entity *operator->() noexcept { return this; }
+
+    [[nodiscard]] EntityId GetId() const noexcept { return _id; }
+    [[nodiscard]] World *  GetWorld() const noexcept { return _world; }
+
+    /**
+     * @brief Name given at creation, "unnamed" otherwise.
+     */
+    [[nodiscard]] const std::string &GetName() const;
+
+    /**
+     * @brief true while the entity is alive, O(1).
+     */
+    [[nodiscard]] bool Valid() const noexcept;
+    [[nodiscard]] bool IsEnabled() const;
+    void               Enable();
+    void               Disable();
+    void               Kill();
+    void               Unregister();
+
+    /**
+     * @attention Adding or deleting a component move the components of the entity,
+     * references previously returned by GetComponent are invalidated.
+     * @throw std::runtime_error if the entity already own a T component or is not alive.
+     */
     template<typename T, typename... Args>
     T &AddComponent(Args &&... args);
+
+    /**
+     * @brief The component is marked as changed, see Changed.
+     * @throw std::runtime_error if the entity does not own a T component or is not alive.
+     */
     template<typename T>
     T &GetComponent();
-    template<typename T>
-    void DeleteComponent();
 
-    [[nodiscard]] const Netero::Set<Netero::type_id> &GetComponentsFilter() const
-    {
-        return _componentsFilterSet;
-    }
-    bool status;
+    /**
+     * @brief Access without marking the component as changed.
+     * @throw std::runtime_error if the entity does not own a T component or is not alive.
+     */
+    template<typename T>
+    const T &ReadComponent() const;
 
-    private:
-    explicit EntityContainer(World *world, const std::string &name = "unnamed");
-    World *                                _world;
-    id                                     id;
-    std::map<Netero::type_id, Component *> _components;
-    Netero::Set<Netero::type_id>           _componentsFilterSet;
-};
+    template<typename T>
+    [[nodiscard]] bool HasComponent() const;
 
-template<typename T, typename... Args>
-T &EntityContainer::AddComponent(Args &&... args)
-{
-    static_assert(std::is_base_of<Component, T>(), "T is not based on Component.");
-    Netero::type_id componentID = ComponentTypeID::GetTypeID<T>();
-    auto            it = _componentsFilterSet.find(componentID);
-    if (it != _componentsFilterSet.end())
-        throw std::runtime_error("One entity could not own the same component twice.");
-    T *dataPtr = new (std::nothrow) T { std::forward<Args>(args)... };
-    if (!dataPtr)
-        throw std::bad_alloc();
-    _components[componentID] = dataPtr;
-    _componentsFilterSet.insert(componentID);
-    return *dataPtr;
-}
-
-template<typename T>
-T &EntityContainer::GetComponent()
-{
-    static_assert(std::is_base_of<Component, T>(), "T is not based on Component.");
-    auto it = _componentsFilterSet.find(ComponentTypeID::GetTypeID<T>());
-    if (it == _componentsFilterSet.end())
-        throw std::runtime_error("Entity does not own T component.");
-    return dynamic_cast<T &>(*_components.at(ComponentTypeID::GetTypeID<T>()));
-}
-
-template<typename T>
-void EntityContainer::DeleteComponent()
-{
-    static_assert(std::is_base_of<Component, T>(), "T is not based on Component.");
-    Netero::type_id componentID = ComponentTypeID::GetTypeID<T>();
-    auto            it = _componentsFilterSet.find(componentID);
-    if (it == _componentsFilterSet.end())
-        throw std::runtime_error("Entity does not own T component.");
-    auto compIt = _components.find(componentID);
-    delete (*compIt).second;
-    _components.erase(compIt);
-    _componentsFilterSet.erase(componentID);
-}
+    template<typename T>
+    void DeleteComponent();
 
-class Entity {
-    public:
-    Entity();
-    Entity(const Entity &rhs);
-    explicit Entity(EntityContainer *entityContainer);
-    Entity &         operator=(EntityContainer *rhs);
-    Entity &         operator=(const Entity &rhs);
-    Entity &         operator=(Entity &&rhs) noexcept;
-    bool             operator==(const Entity &rhs);
-    bool             operator==(const EntityContainer *rhs);
-    EntityContainer *operator->();
-    virtual ~Entity() = default;
-
-    bool Valid() const noexcept;
-    void Enable();
-    void Disable();
-    void Kill();
-    void Unregister();
+    [[nodiscard]] const Netero::Set<Netero::type_id> &GetComponentsFilter() const;
 
     private:
-    EntityContainer *_base;
+    World *  _world = nullptr;
+    EntityId _id;
 };
 
 } // namespace Netero::ECS
@@ -0,0 +1,200 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file EntityTable.hpp
+ * @brief Generational entity ids and the dense table resolving them.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Netero::ECS {
+
+class Archetype;
+
+/**
+ * @brief 32 bits index in the entity table, 32 bits generation of the slot.
+ * The generation is bumped each time the slot is released, handles kept on a killed
+ * entity are then detected as stale even once the slot is reused.
+ */
+struct EntityId {
+    static constexpr std::uint32_t invalidIndex = ~std::uint32_t(0);
+    /**
+     * Generation bit of the entities created by a CommandBuffer and not played back yet,
+     * the other bits tag the buffer and its recording. Slots generations never set it.
+     */
+    static constexpr std::uint32_t pendingFlag = std::uint32_t(1) << 31;
+
+    std::uint32_t index = invalidIndex;
+    std::uint32_t generation = 0;
+
+    [[nodiscard]] bool IsPending() const noexcept { return generation & pendingFlag; }
+
+    [[nodiscard]] std::uint64_t GetValue() const noexcept
+    {
+        return (static_cast<std::uint64_t>(generation) << 32) | index;
+    }
+
+    bool operator==(const EntityId &rhs) const noexcept
+    {
+        return index == rhs.index && generation == rhs.generation;
+    }
+    bool operator!=(const EntityId &rhs) const noexcept { return !(*this == rhs); }
+};
+
+/**
+ * @brief Where the components of an entity are stored.
+ */
+struct EntityLocation {
+    Archetype *   archetype = nullptr;
+    std::uint32_t chunk = 0;
+    std::uint32_t row = 0;
+};
+
+struct EntityRecord {
+    EntityLocation location;
+    std::uint32_t  generation = 0;
+    bool           alive = false;
+    bool           enabled = false;
+};
+
+/**
+ * @brief Records of the entities indexed by EntityId::index, released slots are reused
+ * from a free list so the table stay dense.
+ */
+class EntityTable {
+    public:
+    EntityId Create()
+    {
+        std::uint32_t index;
+        if (_free.empty()) {
+            index = static_cast<std::uint32_t>(_records.size());
+            _records.emplace_back();
+        }
+        else {
+            index = _free.back();
+            _free.pop_back();
+        }
+        EntityRecord &record = _records[index];
+        record.alive = true;
+        record.enabled = false;
+        _size += 1;
+        return EntityId { index, record.generation };
+    }
+
+    /**
+     * @brief Release the slot of a live entity, its components must be released already.
+     */
+    void Destroy(EntityId id)
+    {
+        EntityRecord &record = _records[id.index];
+        record = EntityRecord();
+        std::uint32_t next = id.generation + 1;
+        if (id.index < _minGenerations.size()) {
+            next = std::max(next, _minGenerations[id.index]);
+        }
+        record.generation = next & EntityId::pendingFlag ? 0 : next;
+        _free.push_back(id.index);
+        _size -= 1;
+    }
+
+    [[nodiscard]] bool IsAlive(EntityId id) const noexcept
+    {
+        return id.index < _records.size() && _records[id.index].alive
+            && _records[id.index].generation == id.generation;
+    }
+
+    /**
+     * @brief Record of the slot, the entity may be dead, see IsAlive.
+     */
+    [[nodiscard]] EntityRecord &operator[](std::uint32_t index) noexcept
+    {
+        return _records[index];
+    }
+    [[nodiscard]] const EntityRecord &operator[](std::uint32_t index) const noexcept
+    {
+        return _records[index];
+    }
+
+    /**
+     * @brief Live entities.
+     */
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _size; }
+
+    /**
+     * @brief Slots of the table, live or free.
+     */
+    [[nodiscard]] std::size_t GetCapacity() const noexcept { return _records.size(); }
+
+    [[nodiscard]] const std::vector<EntityRecord> &GetRecords() const noexcept
+    {
+        return _records;
+    }
+
+    /**
+     * @brief Free slots, the last one is reused first.
+     */
+    [[nodiscard]] const std::vector<std::uint32_t> &GetFreeList() const noexcept
+    {
+        return _free;
+    }
+
+    /**
+     * @brief Replace the records and the free list, the locations are reset, the entities
+     * are expected to be allocated in their archetype again.
+     * Live entities take back their generation. Generations of the other slots only grow,
+     * so handles taken since the capture stay stale once the slots are reused. Slots past
+     * the restored ones are kept free, reused after the restored free list.
+     */
+    void Restore(const EntityRecord * records,
+                 std::size_t          count,
+                 const std::uint32_t *free,
+                 std::size_t          freeCount)
+    {
+        const std::size_t previousCount = _records.size();
+        // Lowest generation no handle was given for.
+        std::vector<std::uint32_t> unused(std::max(count, previousCount), 0);
+        for (std::size_t idx = 0; idx < previousCount; ++idx) {
+            const std::uint32_t minGeneration =
+                idx < _minGenerations.size() ? _minGenerations[idx] : 0;
+            unused[idx] = std::max(_records[idx].generation + 1, minGeneration);
+        }
+        _records.assign(records, records + count);
+        _records.resize(unused.size());
+        _minGenerations.assign(unused.size(), 0);
+        _free.clear();
+        for (std::size_t idx = unused.size(); idx-- > count;) {
+            _free.push_back(static_cast<std::uint32_t>(idx));
+        }
+        _free.insert(_free.end(), free, free + freeCount);
+        _size = 0;
+        for (std::size_t idx = 0; idx < _records.size(); ++idx) {
+            EntityRecord &record = _records[idx];
+            record.location = EntityLocation();
+            _size += record.alive;
+            if (record.alive) {
+                _minGenerations[idx] = unused[idx];
+            }
+            else {
+                const std::uint32_t generation = std::max(record.generation, unused[idx]);
+                record.generation = generation & EntityId::pendingFlag ? 0 : generation;
+            }
+        }
+    }
+
+    private:
+    std::vector<EntityRecord>  _records;
+    std::vector<std::uint32_t> _free;
+    /** Lowest generation of a slot once released, raised by Restore, may be shorter. */
+    std::vector<std::uint32_t> _minGenerations;
+    std::size_t                _size = 0;
+};
+
+} // namespace Netero::ECS
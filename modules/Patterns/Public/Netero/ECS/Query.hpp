@@ -0,0 +1,353 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Query.hpp
+ * @brief Entities matching a component filter, maintained as the world changes.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Netero/ECS/Archetype.hpp>
+#include <Netero/ECS/Component.hpp>
+#include <Netero/ECS/ComponentFilter.hpp>
+#include <Netero/ECS/ComponentMask.hpp>
+#include <Netero/ECS/Entity.hpp>
+#include <Netero/ECS/EntityTable.hpp>
+#include <Netero/JobSystem.hpp>
+#include <Netero/Parallel.hpp>
+
+namespace Netero::ECS {
+
+/**
+ * @brief Each argument keeping the entities whose T component changed since the last run
+ * of the system, T being passed to the callback like a plain argument.
+ * @code
+ * Each<Changed<const Position>, Transform>([](const Position &position, Transform &transform) {
+ *     transform.Translate(position);
+ * });
+ * @endcode
+ */
+template<typename T>
+struct Changed {
+};
+
+/**
+ * @brief Each argument keeping the entities whose T component was added since the last run
+ * of the system, see Changed.
+ */
+template<typename T>
+struct Added {
+};
+
+namespace Detail {
+
+    template<typename T>
+    struct EachArgument {
+        using Type = T;
+        static constexpr bool isFiltered = false;
+
+        template<typename Version>
+        static bool Accept(const Version &, std::uint32_t) noexcept
+        {
+            return true;
+        }
+
+        static void Stamp(ComponentVersion &version, std::uint32_t current) noexcept
+        {
+            if constexpr (!std::is_const<T>::value) {
+                version.changed = current;
+            }
+        }
+
+        static void Stamp(ChunkVersion &version, std::uint32_t current) noexcept
+        {
+            if constexpr (!std::is_const<T>::value) {
+                version.changed.store(current, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    template<typename T>
+    struct EachArgument<Changed<T>>: EachArgument<T> {
+        static constexpr bool isFiltered = true;
+
+        static bool Accept(const ComponentVersion &version, std::uint32_t since) noexcept
+        {
+            return IsNewerVersion(version.changed, since);
+        }
+
+        static bool Accept(const ChunkVersion &version, std::uint32_t since) noexcept
+        {
+            return IsNewerVersion(version.changed.load(std::memory_order_relaxed), since);
+        }
+    };
+
+    template<typename T>
+    struct EachArgument<Added<T>>: EachArgument<T> {
+        static constexpr bool isFiltered = true;
+
+        static bool Accept(const ComponentVersion &version, std::uint32_t since) noexcept
+        {
+            return IsNewerVersion(version.added, since);
+        }
+
+        static bool Accept(const ChunkVersion &version, std::uint32_t since) noexcept
+        {
+            return IsNewerVersion(version.added.load(std::memory_order_relaxed), since);
+        }
+    };
+
+    /**
+     * @brief Component type of an Each argument, T for T, Changed<T> and Added<T>.
+     */
+    template<typename T>
+    using EachType = typename EachArgument<T>::Type;
+
+} // namespace Detail
+
+/**
+ * @brief Archetypes and entities matching an include and an exclude mask.
+ * Queries are owned by the world and shared by the systems using the same filters.
+ * The world update them in place when an entity is created, killed, enabled, disabled
+ * or change its components, so no rebuild is needed before the systems run.
+ * Lists are unordered, an erased entity is replaced by the last one.
+ */
+class Query {
+    public:
+    /**
+     * @param version change version of the world, stamped on the components written by Each.
+     */
+    Query(const ComponentMask &               include,
+          const ComponentMask &               exclude,
+          const std::atomic<std::uint32_t> &version);
+    Query(const Query &) = delete;
+    Query &operator=(const Query &) = delete;
+
+    /**
+     * @brief true if a signature owns every included component and none of the excluded.
+     */
+    [[nodiscard]] bool Match(const ComponentMask &signature) const noexcept
+    {
+        return signature.Contains(_include) && !signature.Intersects(_exclude);
+    }
+
+    [[nodiscard]] const ComponentMask &GetIncludeMask() const noexcept { return _include; }
+    [[nodiscard]] const ComponentMask &GetExcludeMask() const noexcept { return _exclude; }
+
+    [[nodiscard]] const std::vector<Archetype *> &GetArchetypes() const noexcept
+    {
+        return _archetypes;
+    }
+
+    [[nodiscard]] const std::vector<Entity> &GetActiveEntities() const noexcept
+    {
+        return _activeEntities;
+    }
+
+    [[nodiscard]] const std::vector<Entity> &GetUnactiveEntities() const noexcept
+    {
+        return _unactiveEntities;
+    }
+
+    [[nodiscard]] bool Contains(EntityId entity) const noexcept
+    {
+        return entity.index < _slots.size() && _slots[entity.index].position != npos;
+    }
+
+    /**
+     * @brief Call fn(entity) for every active entity, batches of grain entities being
+     * processed in parallel on the job system, 0 letting the library choose.
+     * The call return once every entity is processed, fn must not change the structure
+     * of the world.
+     */
+    template<typename F>
+    void ParallelForEach(F &&                fn,
+                         std::size_t         grain = 0,
+                         Netero::JobSystem & jobs = Netero::JobSystem::GetDefault()) const
+    {
+        const std::vector<Entity> &entities = _activeEntities;
+        Netero::ParallelForRange(
+            std::size_t(0),
+            entities.size(),
+            [&entities, &fn](std::size_t first, std::size_t last) {
+                for (std::size_t idx = first; idx < last; ++idx) {
+                    Entity entity = entities[idx];
+                    fn(entity);
+                }
+            },
+            grain,
+            jobs);
+    }
+
+    /**
+     * @brief Call fn(entity, scratch.Local()) for every active entity in parallel, each
+     * thread using its own scratch value.
+     */
+    template<typename T, typename F>
+    void ParallelForEach(Netero::PerWorker<T> &scratch,
+                         F &&                  fn,
+                         std::size_t           grain = 0,
+                         Netero::JobSystem &   jobs = Netero::JobSystem::GetDefault()) const
+    {
+        ParallelForEach([&scratch, &fn](Entity &entity) { fn(entity, scratch.Local()); },
+                        grain,
+                        jobs);
+    }
+
+    /**
+     * @brief Call fn(components...) for every active entity, with a reference on each
+     * component of Components, const qualified types being passed by const reference.
+     * Columns are resolved once per chunk, rows are then walked in memory order.
+     * Non const components are marked as changed. Changed<T> and Added<T> arguments keep
+     * the entities whose T changed or was added after the since version, chunks without
+     * such change are skipped whole.
+     * @throw std::runtime_error if a component is not part of the include filter.
+     * @code
+     * query.Each<Position, const Velocity>([](Position &position, const Velocity &velocity) {
+     *     position.x += velocity.dx;
+     * });
+     * @endcode
+     */
+    template<typename... Components, typename F>
+    void Each(F &&fn, std::uint32_t since = 0) const
+    {
+        Each<Components...>(std::forward<F>(fn), since, _version.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Each, the non const components being stamped with version instead of the
+     * current version of the world.
+     */
+    template<typename... Components, typename F>
+    void Each(F &&fn, std::uint32_t since, std::uint32_t version) const
+    {
+        static_assert(sizeof...(Components) > 0, "Each require at least one component.");
+        if (!_include.Contains(
+                ComponentFilter<std::remove_const_t<Detail::EachType<Components>>...>::GetMask()))
+            throw std::runtime_error("Each components must be part of the include filter.");
+        for (const Archetype *archetype : _archetypes) {
+            const std::size_t columns[] = { archetype->GetColumn(ComponentTypeID::GetTypeID<
+                std::remove_const_t<Detail::EachType<Components>>>())... };
+            for (const Chunk &chunk : archetype->GetChunks()) {
+                EachRow<Components...>(*archetype,
+                                       chunk,
+                                       columns,
+                                       fn,
+                                       since,
+                                       version,
+                                       std::index_sequence_for<Components...>());
+            }
+        }
+    }
+
+    void AddArchetype(Archetype *archetype) { _archetypes.push_back(archetype); }
+
+    /**
+     * @brief Entity entering the query, it must not be part of it already.
+     */
+    void Insert(const Entity &entity, bool enabled);
+
+    /**
+     * @brief Entity leaving the query, O(1).
+     */
+    void Erase(EntityId entity);
+
+    /**
+     * @brief Move the entity to the active or the unactive list, O(1).
+     */
+    void SetEnabled(EntityId entity, bool enabled);
+
+    /**
+     * @brief Remove every entity, the matching archetypes are kept.
+     */
+    void Clear() noexcept;
+
+    private:
+    static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+    struct Slot {
+        std::uint32_t position = npos;
+        bool          enabled = false;
+    };
+
+    template<typename... Components, typename F, std::size_t... Indexes>
+    static void EachRow(const Archetype &  archetype,
+                        const Chunk &      chunk,
+                        const std::size_t *columns,
+                        F &                fn,
+                        std::uint32_t      since,
+                        std::uint32_t      version,
+                        std::index_sequence<Indexes...>)
+    {
+        using Detail::EachArgument;
+        if (chunk.disabled == chunk.count) {
+            return;
+        }
+        // Chunks without a change newer than since are skipped without reading their rows.
+        if (!((!EachArgument<Components>::isFiltered
+               || EachArgument<Components>::Accept(
+                   archetype.GetChunkVersion(chunk, columns[Indexes]), since))
+              && ...)) {
+            return;
+        }
+        const std::tuple<Detail::EachType<Components> *...> rows {
+            reinterpret_cast<Detail::EachType<Components> *>(
+                archetype.GetColumnData(chunk, columns[Indexes]))...
+        };
+        ComponentVersion *const versions[] = { archetype.GetVersions(chunk, columns[Indexes])... };
+        bool       visited = false;
+        const auto visit = [&](std::uint32_t row) {
+            if ((EachArgument<Components>::Accept(versions[Indexes][row], since) && ...)) {
+                (EachArgument<Components>::Stamp(versions[Indexes][row], version), ...);
+                fn(std::get<Indexes>(rows)[row]...);
+                visited = true;
+            }
+        };
+        if (chunk.disabled == 0) {
+            for (std::uint32_t row = 0; row < chunk.count; ++row) {
+                visit(row);
+            }
+        }
+        else {
+            const EntityId *   owners = archetype.GetOwners(chunk);
+            const EntityTable &entities = archetype.GetEntities();
+            for (std::uint32_t row = 0; row < chunk.count; ++row) {
+                if (entities[owners[row].index].enabled) {
+                    visit(row);
+                }
+            }
+        }
+        if (visited) {
+            (EachArgument<Components>::Stamp(archetype.GetChunkVersion(chunk, columns[Indexes]),
+                                             version),
+             ...);
+        }
+    }
+
+    std::vector<Entity> &GetList(bool enabled) noexcept
+    {
+        return enabled ? _activeEntities : _unactiveEntities;
+    }
+
+    ComponentMask                     _include;
+    ComponentMask                     _exclude;
+    const std::atomic<std::uint32_t> &_version;
+    std::vector<Archetype *>          _archetypes;
+    std::vector<Entity>               _activeEntities;
+    std::vector<Entity>               _unactiveEntities;
+    std::vector<Slot>                 _slots; /**< By entity index. */
+};
+
+} // namespace Netero::ECS
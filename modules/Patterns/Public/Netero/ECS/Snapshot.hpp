@@ -0,0 +1,125 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file Snapshot.hpp
+ * @brief Binary copy of the entities and components of a world, for save, load and rollback.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Netero/ECS/Archetype.hpp>
+#include <Netero/TypeId.hpp>
+
+namespace Netero::ECS {
+
+class World;
+
+/**
+ * @brief Components a snapshot may hold, each under a stable name and a version.
+ * Ids of the component types depend on the order they are first used, names and versions
+ * are what a snapshot records to find them back in another run of the program. Restoring
+ * a snapshot holding a type with another version or size fails.
+ * Components are copied as raw bytes, they must be trivially copyable, which exclude the
+ * types deriving from Component.
+ */
+class SnapshotRegistry {
+    public:
+    struct Entry {
+        const ComponentInfo *info;
+        std::string          name;
+        std::uint32_t        version;
+    };
+
+    /**
+     * @throw std::runtime_error if the name is already used by another type or the type
+     * registered under another name.
+     */
+    template<typename T>
+    void Register(const std::string &name, std::uint32_t version = 1)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Snapshot components must be trivially copyable.");
+        Add(GetComponentInfo<T>(), name, version);
+    }
+
+    /**
+     * @return The entry of the component type, nullptr if it is not registered.
+     */
+    [[nodiscard]] const Entry *Find(Netero::type_id id) const noexcept;
+    [[nodiscard]] const Entry *Find(std::string_view name) const noexcept;
+
+    private:
+    static constexpr std::size_t npos = ~std::size_t(0);
+
+    void Add(const ComponentInfo &info, const std::string &name, std::uint32_t version);
+
+    std::vector<Entry>                              _entries;
+    std::vector<std::size_t>                        _byId; /**< Entry index by component id. */
+    std::map<std::string, std::size_t, std::less<>> _byName;
+};
+
+/**
+ * @brief Entity table, names and component columns of a world in one contiguous buffer.
+ * Each archetype is written as the owners of its rows then one block per column, copied
+ * chunk by chunk with memcpy. The buffer is kept between captures, so taking a checkpoint
+ * every few frames does not allocate once the world stopped growing.
+ * The layout follows the byte order and the padding of the platform, it is meant to be
+ * read back by the same build.
+ * @code
+ * Netero::ECS::SnapshotRegistry registry;
+ * registry.Register<Position>("Position");
+ * Netero::ECS::Snapshot checkpoint;
+ * checkpoint.Capture(world, registry);
+ * // ... later on, roll back:
+ * checkpoint.Restore(world, registry);
+ * @endcode
+ */
+class Snapshot {
+    public:
+    Snapshot() = default;
+
+    /**
+     * @brief Snapshot read back from a file, checked when restored.
+     */
+    explicit Snapshot(std::vector<std::byte> data): _data(std::move(data)) {}
+
+    /**
+     * @brief Copy the live entities of the world and their components.
+     * Must not be called while the systems run.
+     * @throw std::runtime_error if an entity own a component missing from the registry.
+     */
+    void Capture(const World &world, const SnapshotRegistry &registry);
+
+    /**
+     * @brief Replace the entities of the world by the ones of the snapshot.
+     * Entities keep their id, handles taken before the capture are valid again, the ones
+     * taken after stay invalid even once their slot is reused. Restored components are
+     * marked as added, see Added. Systems and queries are kept, command buffers are not
+     * played back. Must not be called while the systems run.
+     * @throw std::runtime_error if the snapshot is malformed or holds a component missing
+     * from the registry or registered with another version, the world is then untouched.
+     */
+    void Restore(World &world, const SnapshotRegistry &registry) const;
+
+    [[nodiscard]] const std::vector<std::byte> &GetData() const noexcept { return _data; }
+    [[nodiscard]] std::size_t                   GetSize() const noexcept { return _data.size(); }
+    [[nodiscard]] bool                          IsEmpty() const noexcept { return _data.empty(); }
+
+    private:
+    std::vector<std::byte> _data;
+};
+
+} // namespace Netero::ECS
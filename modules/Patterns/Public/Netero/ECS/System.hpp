@@ -5,79 +5,273 @@
 
 #pragma once
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <Netero/ECS/ComponentFilter.hpp>
 #include <Netero/ECS/Entity.hpp>
-#include <Netero/Set.hpp>
+#include <Netero/ECS/Query.hpp>
+#include <Netero/ECS/SystemGraph.hpp>
+#include <Netero/Metrics.hpp>
+#include <Netero/TypeId.hpp>
 
 namespace Netero::ECS {
 
 class World;
 
-struct SystemCache {
-    std::vector<Entity> _unactiveEntities;
-    std::vector<Entity> _activeEntities;
-    void                flush()
+/**
+ * @brief Components read by a system, see System.
+ */
+template<typename... Components>
+struct Read {
+    static void Declare(SystemAccess &access)
+    {
+        (access.read.Set(ComponentTypeID::GetTypeID<Components>()), ...);
+    }
+};
+
+/**
+ * @brief Components written by a system, see System.
+ */
+template<typename... Components>
+struct Write {
+    static void Declare(SystemAccess &access)
+    {
+        (access.write.Set(ComponentTypeID::GetTypeID<Components>()), ...);
+    }
+};
+
+/**
+ * @brief Components used as passed to Each: const qualified types are read, the others
+ * written, Changed and Added arguments being unwrapped, see System.
+ */
+template<typename... Components>
+struct Access {
+    static void Declare(SystemAccess &access)
     {
-        _unactiveEntities.clear();
-        _activeEntities.clear();
+        const auto declare = [&access](Netero::type_id id, bool isConst) {
+            (isConst ? access.read : access.write).Set(id);
+        };
+        (declare(ComponentTypeID::GetTypeID<std::remove_const_t<Detail::EachType<Components>>>(),
+                 std::is_const<Detail::EachType<Components>>::value),
+         ...);
     }
 };
 
+namespace Detail {
+
+    /**
+     * @brief Version of the system run executed by the calling thread, stamped by
+     * Entity::GetComponent instead of the live version of the world, see BaseSystem.
+     */
+    class RunVersionScope {
+        public:
+        RunVersionScope(const World *world, std::uint32_t version) noexcept
+            : _previousWorld(_world), _previousVersion(_version)
+        {
+            _world = world;
+            _version = version;
+        }
+        ~RunVersionScope()
+        {
+            _world = _previousWorld;
+            _version = _previousVersion;
+        }
+        RunVersionScope(const RunVersionScope &) = delete;
+        RunVersionScope &operator=(const RunVersionScope &) = delete;
+
+        /**
+         * @return true and the version if the calling thread runs a system of the world.
+         */
+        static bool Find(const World *world, std::uint32_t &version) noexcept
+        {
+            if (_world != world)
+                return false;
+            version = _version;
+            return true;
+        }
+
+        private:
+        static inline thread_local const World *_world = nullptr;
+        static inline thread_local std::uint32_t _version = 0;
+
+        const World *       _previousWorld;
+        const std::uint32_t _previousVersion;
+    };
+
+} // namespace Detail
+
 class BaseSystem {
     friend World;
 
     public:
-    BaseSystem(const Netero::Set<Netero::type_id> &includeFilterSet,
-               const Netero::Set<Netero::type_id> &excludeFilterSet)
-        : _includeFilterSet(includeFilterSet), _excludeFilterSet(excludeFilterSet)
+    BaseSystem(const ComponentMask &includeMask,
+               const ComponentMask &excludeMask,
+               const SystemAccess & access = SystemAccess())
+        : _includeMask(includeMask), _excludeMask(excludeMask), _access(access)
     {
     }
     virtual ~BaseSystem() = default;
 
-    private:
-    void generateCache(Netero::Set<EntityContainer *> &entities)
-    {
-        _cache.flush();
-        for (auto *entity : entities) {
-            auto &entityFiltersSet = entity->GetComponentsFilter();
-            if (_includeFilterSet.IsSubsetOf(entityFiltersSet)) {
-                if (_excludeFilterSet.InterWith(entityFiltersSet)) {
-                    if (entity->status) {
-                        _cache._activeEntities.emplace_back(entity);
-                    }
-                    else {
-                        _cache._unactiveEntities.emplace_back(entity);
-                    }
-                }
-            }
-        }
-    }
+    virtual void exec() = 0;
 
-    public:
-    virtual void                        exec() = 0;
-    const Netero::Set<Netero::type_id> &_includeFilterSet;
-    const Netero::Set<Netero::type_id> &_excludeFilterSet;
+    [[nodiscard]] const SystemAccess &GetAccess() const noexcept { return _access; }
+
+    /**
+     * @brief Name of the system type, set by the world.
+     */
+    [[nodiscard]] std::string_view GetName() const noexcept { return _name; }
+
+    const ComponentMask &_includeMask;
+    const ComponentMask &_excludeMask;
 
     protected:
-    SystemCache _cache;
+    /**
+     * @brief Entities matching the filters, shared with the systems using the same filters.
+     * Set by the world when the system is added.
+     */
+    Query *_query = nullptr;
+
+    /**
+     * @brief Change version of the world when the previous exec started, 0 before the first
+     * one. Changes newer than it are the ones the system has not seen yet.
+     */
+    std::uint32_t _lastRunVersion = 0;
+
+    /**
+     * @brief Change version of the world when the current exec started, stamped on the
+     * components the system write. Systems starting meanwhile bump the version of the
+     * world, the system would otherwise see its own changes on its next run.
+     */
+    std::uint32_t _runVersion = 0;
+
+    /**
+     * @brief Job system of the world, running ParallelForEach. Set by the world.
+     */
+    Netero::JobSystem *_jobs = nullptr;
+
+    const World *_ownerWorld = nullptr; /**< Set by the world. */
+
+    private:
+    SystemAccess                      _access;
+    Netero::type_id                   _typeId = 0;
+    std::string_view                  _name;
+    Netero::Metrics::Histogram *      _duration = nullptr; /**< exec duration, set by the world. */
+    Netero::Metrics::RollingHistogram _history;            /**< exec duration, last frames. */
+    std::size_t                       _matchedEntities = 0; /**< Active when exec last ran. */
 };
 
+/**
+ * @brief System running on the entities owning every IncludeComponent and none of the
+ * ExcludeComponent.
+ * Accesses are Read<...>, Write<...> or Access<...> declarations of the components used
+ * by exec.
+ * Systems declaring their access run concurrently with the non conflicting ones, they must
+ * not change the structure of the world (create, kill, enable or disable an entity, add
+ * or remove a component) from exec but record it in World::GetCommandBuffer.
+ * Without declaration a system runs alone.
+ * @code
+ * class Move: public System<ComponentFilter<Position, Velocity>, ComponentFilter<>,
+ *                           Access<Position, const Velocity>> {
+ *     void exec() final
+ *     {
+ *         Each<Position, const Velocity>([](Position &position, const Velocity &velocity) {
+ *             position.x += velocity.dx;
+ *         });
+ *     }
+ * };
+ * @endcode
+ */
 template<typename IncludeComponent = ComponentFilter<>,
          typename ExcludeComponent = ComponentFilter<>,
-         typename = std::enable_if<std::is_base_of<IncludeComponent, BaseComponentFilter>::value>,
-         typename = std::enable_if<std::is_base_of<ExcludeComponent, BaseComponentFilter>::value>>
+         typename... Accesses>
 class System: public BaseSystem {
+    static_assert(std::is_base_of<BaseComponentFilter, IncludeComponent>::value,
+                  "IncludeComponent must be a ComponentFilter.");
+    static_assert(std::is_base_of<BaseComponentFilter, ExcludeComponent>::value,
+                  "ExcludeComponent must be a ComponentFilter.");
+
     public:
-    System(): BaseSystem(IncludeComponent::GetFilter(), ExcludeComponent::GetFilter()) {}
+    System(): BaseSystem(IncludeComponent::GetMask(), ExcludeComponent::GetMask(), MakeAccess())
+    {
+    }
     ~System() override = default;
 
-    const std::vector<Entity> &GetActiveEntities() { return _cache._activeEntities; }
+    /**
+     * @brief Enabled entities matching the filters.
+     * The list is updated in place, components must not be added or removed and entities
+     * not killed, enabled or disabled while iterating it, use World::GetCommandBuffer.
+     */
+    const std::vector<Entity> &GetActiveEntities() { return _query->GetActiveEntities(); }
+
+    const std::vector<Entity> &GetUnActiveEntities() { return _query->GetUnactiveEntities(); }
 
-    const std::vector<Entity> &GetUnActiveEntities() { return _cache._unactiveEntities; }
+    /**
+     * @brief Call fn(entity) for every active entity, in parallel batches of grain
+     * entities on the job system of the world, see Query::ParallelForEach. fn must only
+     * touch the declared components.
+     */
+    template<typename F>
+    void ParallelForEach(F &&fn, std::size_t grain = 0)
+    {
+        _query->ParallelForEach(
+            [&fn, world = _ownerWorld, version = _runVersion](Entity &entity) {
+                const Detail::RunVersionScope scope(world, version);
+                fn(entity);
+            },
+            grain,
+            *_jobs);
+    }
+
+    /**
+     * @brief Call fn(entity, scratch) in parallel, scratch being the value of the thread.
+     */
+    template<typename T, typename F>
+    void ParallelForEach(Netero::PerWorker<T> &scratch, F &&fn, std::size_t grain = 0)
+    {
+        ParallelForEach([&scratch, &fn](Entity &entity) { fn(entity, scratch.Local()); },
+                        grain);
+    }
+
+    /**
+     * @brief Call fn(components...) for every active entity, see Query::Each.
+     * Changed<T> and Added<T> arguments keep the entities changed since the previous exec
+     * of the system, including the changes made after it by the other systems or outside
+     * of Update, but not its own changes.
+     * @throw std::logic_error if the system declared its access without these components.
+     */
+    template<typename... Components, typename F>
+    void Each(F &&fn)
+    {
+        static const bool isDeclared = [] {
+            const SystemAccess declared = MakeAccess();
+            SystemAccess       used;
+            Access<Components...>::Declare(used);
+            ComponentMask readable = declared.read;
+            readable |= declared.write;
+            return declared.exclusive
+                || (declared.write.Contains(used.write) && readable.Contains(used.read));
+        }();
+        if (!isDeclared)
+            throw std::logic_error("Each components are missing from the system access.");
+        _query->Each<Components...>(std::forward<F>(fn), _lastRunVersion, _runVersion);
+    }
+
+    private:
+    static SystemAccess MakeAccess()
+    {
+        SystemAccess access;
+        if constexpr (sizeof...(Accesses) > 0) {
+            access.exclusive = false;
+            (Accesses::Declare(access), ...);
+        }
+        return access;
+    }
 };
 
 } // namespace Netero::ECS
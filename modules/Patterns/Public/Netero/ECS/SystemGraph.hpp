@@ -0,0 +1,105 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#pragma once
+
+/**
+ * @file SystemGraph.hpp
+ * @brief Dependencies between the systems of a world, from their component access.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Netero/ECS/ComponentMask.hpp>
+#include <Netero/JobSystem.hpp>
+
+namespace Netero::ECS {
+
+/**
+ * @brief Components a system read and write.
+ * An exclusive system may touch anything, the structure of the world included, it never
+ * run concurrently with another system.
+ */
+struct SystemAccess {
+    ComponentMask read;
+    ComponentMask write;
+    bool          exclusive = true;
+
+    /**
+     * @brief true if the systems can not run concurrently: one of them is exclusive or
+     * writes a component the other one read or write.
+     */
+    [[nodiscard]] bool ConflictWith(const SystemAccess &other) const noexcept
+    {
+        return exclusive || other.exclusive || write.Intersects(other.write)
+            || write.Intersects(other.read) || read.Intersects(other.write);
+    }
+};
+
+/**
+ * @brief Directed acyclic graph of the systems in registration order.
+ * A system depends on every system registered before it with a conflicting access, so a
+ * parallel run observe the same component values as a sequential run.
+ */
+class SystemGraph {
+    public:
+    SystemGraph() = default;
+    SystemGraph(const SystemGraph &) = delete;
+    SystemGraph &operator=(const SystemGraph &) = delete;
+
+    /**
+     * @param accesses of the systems, in registration order.
+     */
+    void Build(const std::vector<SystemAccess> &accesses);
+
+    [[nodiscard]] std::size_t GetSize() const noexcept { return _nodes.size(); }
+
+    /**
+     * @return Systems the system wait for, by index.
+     */
+    [[nodiscard]] const std::vector<std::size_t> &GetDependencies(std::size_t system) const
+    {
+        return _nodes[system].dependencies;
+    }
+
+    /**
+     * @brief Number of systems on the longest dependency chain, as many as systems if no
+     * two of them can run concurrently.
+     */
+    [[nodiscard]] std::size_t GetDepth() const noexcept { return _depth; }
+
+    /**
+     * @brief Call task for each system in registration order from the calling thread.
+     */
+    void RunSequential(const std::function<void(std::size_t)> &task) const;
+
+    /**
+     * @brief Call task for each system on the job system, a system is scheduled once its
+     * dependencies returned. Return once every task returned.
+     * @warning task must not throw.
+     */
+    void RunParallel(Netero::JobSystem &jobs, const std::function<void(std::size_t)> &task);
+
+    private:
+    struct Node {
+        std::vector<std::size_t> dependencies;
+        std::vector<std::size_t> successors;
+    };
+
+    void Schedule(Netero::JobSystem &                      jobs,
+                  Netero::JobCounter &                     counter,
+                  const std::function<void(std::size_t)> &task,
+                  std::size_t                              system);
+
+    std::vector<Node>                            _nodes;
+    std::unique_ptr<std::atomic<std::size_t>[]> _pending; /**< Dependencies not done. */
+    std::size_t                                  _depth = 0;
+};
+
+} // namespace Netero::ECS
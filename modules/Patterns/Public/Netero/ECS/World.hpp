@@ -5,35 +5,65 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <exception>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <Netero/ECS/Archetype.hpp>
+#include <Netero/ECS/CommandBuffer.hpp>
 #include <Netero/ECS/Entity.hpp>
+#include <Netero/ECS/Query.hpp>
+#include <Netero/ECS/Snapshot.hpp>
 #include <Netero/ECS/System.hpp>
+#include <Netero/ECS/SystemGraph.hpp>
+#include <Netero/JobSystem.hpp>
+#include <Netero/Metrics.hpp>
+#include <Netero/Parallel.hpp>
 #include <Netero/TypeId.hpp>
 
 /**
  * Process to update the world
- * 1 if the status flag is true generate the entity cache for system computation
- * 2 execute each system (they use their own cache so no search needed on entity's world stack)
- * 3 each system make a boolean check on the status of the entity
- * 4 the cache collect entity to be deleted, so delete this entity
- * 5 if the status flag is true clean up the cache
+ * 1 each change of an entity updates the queries it enters or leaves, in place
+ * 2 execute each system on the entities of its query, no search on the world needed
  */
 
 namespace Netero::ECS {
 
 class World {
     public:
+    /**
+     * @brief Measures of a system during the last Update.
+     */
+    struct SystemStatistic {
+        std::string_view name;
+        std::uint64_t    durationNs = 0; /**< Of exec. */
+        std::size_t      matchedEntities = 0; /**< Active entities of its query. */
+    };
+
     struct Statistic {
-        size_t size;
-        size_t activeEntities;
-        size_t unactiveEntities;
-        size_t garbadgeSize;
+        size_t        size = 0; /**< Enabled entities, same as activeEntities. */
+        size_t        activeEntities = 0;
+        size_t        unactiveEntities = 0;
+        size_t        garbadgeSize = 0; /**< Released entity slots waiting to be reused. */
+        std::uint64_t frame = 0;        /**< Update calls. */
+        std::uint64_t updateNs = 0;     /**< Last Update, systems included. */
+        /**
+         * Last Update, rebuilding the system graph and playing back the commands, which
+         * update the queries.
+         */
+        std::uint64_t                cacheRebuildNs = 0;
+        std::vector<SystemStatistic> systems; /**< In registration order. */
     };
 
     public:
@@ -50,16 +80,45 @@ class World {
     void   EnableEntity(Entity &entity);
     void   DisableEntity(Entity &entity);
 
+    /**
+     * @brief Create count entities owning a copy of every component of the prototype.
+     * Rows are allocated chunk by chunk and each component column is copied in bulk, the
+     * queries are updated once per entity. Names are not copied.
+     * @param enabled state of the new entities, disabled like CreateEntity by default.
+     * @throw std::runtime_error if the prototype is not alive in this world or one of its
+     * components is not copy constructible.
+     * @warning The copy constructors of the components must not throw.
+     */
+    std::vector<Entity>
+    CreateEntities(std::size_t count, const Entity &prototype, bool enabled = false);
+
+    /**
+     * @brief true if the entity belong to this world and is alive, O(1).
+     */
+    [[nodiscard]] bool IsAlive(const Entity &entity) const noexcept;
+
+    /**
+     * @brief Add a system, run after the systems already added when their access conflict.
+     * A system of the same type already added is replaced.
+     */
     template<typename T, typename... Args>
-    void AddSystem(Args... args)
+    void AddSystem(Args &&... args)
     {
         static_assert(
             std::is_base_of<BaseSystem, T>::value,
             "System not base on BaseSystem, your system must inherit from netero::system<>");
-        T *data = new (std::nothrow) T(std::forward(args)...);
+        T *data = new (std::nothrow) T(std::forward<Args>(args)...);
         if (!data)
             throw std::bad_alloc();
-        _systems[Netero::TypeID<BaseSystem>::GetTypeID<T>()] = data;
+        data->_query = &GetQuery(data->_includeMask, data->_excludeMask);
+        data->_jobs = &GetJobSystem();
+        data->_ownerWorld = this;
+        data->_duration = &Netero::Metrics::Registry::GetDefault().GetHistogram(
+            "ecs.system." + std::string(Netero::GetTypeName<T>()) + ".duration_ns");
+        data->_typeId = Netero::TypeID<BaseSystem>::GetTypeID<T>();
+        data->_name = Netero::GetTypeName<T>();
+        data->_history.SetCapacity(_statisticWindow);
+        _addSystem(data);
     }
 
     template<typename T>
@@ -68,26 +127,267 @@ class World {
         static_assert(
             std::is_base_of<BaseSystem, T>::value,
             "System not base on BaseSystem, your system must inherit from netero::system<>");
-        auto systemIt = _systems.find(Netero::TypeID<BaseSystem>::GetTypeID<T>());
-        if (systemIt == _systems.end())
-            return;
-        delete (*systemIt).second;
-        _systems.erase(systemIt);
+        _removeSystem(Netero::TypeID<BaseSystem>::GetTypeID<T>());
+    }
+
+    /**
+     * @brief Run the systems one after another in registration order from the calling
+     * thread, whatever their access. Off by default.
+     */
+    void SetDeterministic(bool deterministic) noexcept { _deterministic = deterministic; }
+    [[nodiscard]] bool IsDeterministic() const noexcept { return _deterministic; }
+
+    /**
+     * @brief Scheduler running the systems concurrently and their ParallelForEach, the
+     * default one if not set.
+     */
+    void SetJobSystem(Netero::JobSystem &jobs);
+    [[nodiscard]] Netero::JobSystem &GetJobSystem() const noexcept;
+
+    /**
+     * @brief Command buffer of the calling thread, played back at the end of Update.
+     * Systems running concurrently, or iterating their entities, record their structural
+     * changes there instead of calling CreateEntity, KillEntity, AddComponent...
+     * Workers of the job system and the thread which created the world use their own
+     * buffer, any other thread get one as well, played back after them.
+     */
+    CommandBuffer &GetCommandBuffer();
+
+    /**
+     * @brief Apply the commands of the buffer in order then clear it.
+     */
+    void Playback(CommandBuffer &buffer);
+
+    /**
+     * @brief Play back the command buffers of every thread, in thread order.
+     * Called at the end of Update, must not be called while the systems run.
+     */
+    void FlushCommands();
+
+    /**
+     * @brief Give the chunks freed by killed entities back to the allocator.
+     * They are otherwise kept for the next entities, a world which spawned a wave once
+     * keep its peak memory until trimmed. Must not be called while the systems run.
+     * @return Number of bytes released.
+     */
+    std::size_t TrimMemory();
+
+    /**
+     * @brief Query of the entities owning every include component and none of the exclude,
+     * created on first use and kept up to date until the world is destroyed.
+     */
+    Query &GetQuery(const ComponentMask &include, const ComponentMask &exclude);
+
+    /**
+     * @brief Call fn(components...) for every active entity owning Components, see
+     * Query::Each. Const qualified components are passed by const reference.
+     * @param since version the Changed and Added arguments are compared to, see
+     * GetChangeVersion.
+     * @code
+     * world.Each<Position, const Velocity>([](Position &position, const Velocity &velocity) {
+     *     position.x += velocity.dx;
+     * });
+     * @endcode
+     */
+    template<typename... Components, typename F>
+    void Each(F &&fn, std::uint32_t since = 0)
+    {
+        GetQuery(
+            ComponentFilter<std::remove_const_t<Detail::EachType<Components>>...>::GetMask(),
+            ComponentFilter<>::GetMask())
+            .template Each<Components...>(std::forward<F>(fn), since);
+    }
+
+    /**
+     * @brief Version stamped on the components changed now, bumped before each system run
+     * and at the end of Update. Components changed later are newer than it.
+     */
+    [[nodiscard]] std::uint32_t GetChangeVersion() const noexcept
+    {
+        return _changeVersion.load(std::memory_order_relaxed);
     }
 
-    std::size_t       Size();
+    /**
+     * @brief Live entities, enabled or not.
+     */
+    std::size_t Size();
+
+    /**
+     * @brief Entity counts, and the measures of the last Update.
+     */
     World::Statistic &GetStatistic();
 
+    /**
+     * @brief Number of Update calls kept by the rolling histograms, 128 by default.
+     * The process wide histograms of the Metrics registry, ecs.world.update.duration_ns,
+     * ecs.world.cache_rebuild.duration_ns and ecs.system.<name>.duration_ns, keep every
+     * frame of every world.
+     */
+    void SetStatisticWindow(std::size_t frames);
+
+    /**
+     * @brief Durations of the last Update calls, in nanoseconds.
+     */
+    [[nodiscard]] const Netero::Metrics::RollingHistogram &GetUpdateHistory() const noexcept
+    {
+        return _updateHistory;
+    }
+
+    /**
+     * @brief Durations of the system graph rebuild and command playback of the last
+     * Update calls, in nanoseconds.
+     */
+    [[nodiscard]] const Netero::Metrics::RollingHistogram &GetCacheRebuildHistory() const
+        noexcept
+    {
+        return _cacheRebuildHistory;
+    }
+
+    /**
+     * @brief Durations of the exec of the system over the last Update calls, in nanoseconds.
+     * @throw std::runtime_error if the system is not added.
+     * @code
+     * const auto frames = world.GetSystemHistory<MoveSystem>().GetSnapshot();
+     * if (frames.GetPercentile(99) > 2'000'000) { ... }
+     * @endcode
+     */
+    template<typename T>
+    const Netero::Metrics::RollingHistogram &GetSystemHistory() const
+    {
+        const BaseSystem *system = _findSystem(Netero::TypeID<BaseSystem>::GetTypeID<T>());
+        if (!system)
+            throw std::runtime_error("System is not added to the world.");
+        return system->_history;
+    }
+
+    /**
+     * @brief Run every system once, then play back the command buffers.
+     * Non conflicting systems run concurrently on the job system, a system throwing is
+     * then fatal. Systems run sequentially if the world is deterministic or if every
+     * system conflict with the previous one.
+     */
     void Update();
 
     private:
-    void                                    _generateCache();
-    void                                    _deleteEntities();
-    std::mutex                              _entityAllocatorLock;
-    Netero::Set<EntityContainer *>          _entitiesEnable;
-    Netero::Set<EntityContainer *>          _entitiesDisable;
-    std::map<Netero::type_id, BaseSystem *> _systems;
-    World::Statistic                        _statistic;
+    friend Entity;
+    friend Snapshot;
+
+    /**
+     * @throw std::runtime_error if the entity is not alive.
+     */
+    EntityRecord &      _getRecord(EntityId id);
+    const EntityRecord &_getRecord(EntityId id) const;
+
+    /**
+     * @brief Queries matching the archetype, computed on first use.
+     */
+    const std::vector<Query *> &_getQueries(Archetype &archetype);
+
+    /**
+     * @brief Fill the queries again from the archetypes, after a Snapshot restore.
+     */
+    void _resetQueries();
+
+    /**
+     * @brief Move the entity to another archetype and update the queries.
+     */
+    void _moveEntity(EntityId id, Archetype &target);
+
+    /**
+     * @brief Move the entity to the archetype with the component, then move construct the
+     * component from source. The entity must not own the component already.
+     * @return Address of the new component.
+     */
+    void *_addComponent(EntityId id, const ComponentInfo &component, void *source);
+    void  _deleteComponent(EntityId id, Netero::type_id component);
+
+    void              _addSystem(BaseSystem *system);
+    void              _removeSystem(Netero::type_id id);
+    const BaseSystem *_findSystem(Netero::type_id id) const noexcept;
+    void _runSystem(std::size_t index);
+
+    using QueryKey = std::pair<ComponentMask, ComponentMask>;
+
+    ArchetypeStorage                                            _storage;
+    std::mutex                                                  _entityAllocatorLock;
+    std::unordered_map<std::uint32_t, std::string>              _names; /**< By entity index. */
+    std::size_t                                                 _enabledEntities = 0;
+    std::map<QueryKey, std::unique_ptr<Query>>                  _queries;
+    std::unordered_map<const Archetype *, std::vector<Query *>> _archetypeQueries;
+    std::vector<BaseSystem *>                                   _systems; /**< In order. */
+    SystemGraph                                                 _systemGraph;
+    bool                                                        _systemGraphDirty = false;
+    bool                                                        _deterministic = false;
+    Netero::JobSystem *                                         _jobs = nullptr;
+    std::unique_ptr<Netero::PerWorker<CommandBuffer>>           _commandBuffers;
+    std::thread::id                                             _ownerThread;
+    std::mutex                                                  _foreignBuffersLock;
+    /** Buffers of the threads neither owner nor worker, in order of first use. */
+    std::vector<std::pair<std::thread::id, std::unique_ptr<CommandBuffer>>> _foreignBuffers;
+    std::atomic<std::uint32_t>                                  _changeVersion { 1 };
+    World::Statistic                                            _statistic;
+    std::size_t                                                 _statisticWindow = 128;
+    Netero::Metrics::RollingHistogram                           _updateHistory;
+    Netero::Metrics::RollingHistogram                           _cacheRebuildHistory;
+    Netero::Metrics::Histogram &                                _updateDuration;
+    Netero::Metrics::Histogram &                                _cacheRebuildDuration;
 };
 
+template<typename T, typename... Args>
+T &Entity::AddComponent(Args &&... args)
+{
+    const ComponentInfo &info = GetComponentInfo<T>();
+    EntityRecord &       record = _world->_getRecord(_id);
+    if (record.location.archetype->Has(info.id))
+        throw std::runtime_error("One entity could not own the same component twice.");
+    // Built before the move, the entity is left untouched if the constructor throw.
+    T component { std::forward<Args>(args)... };
+    return *static_cast<T *>(_world->_addComponent(_id, info, &component));
+}
+
+template<typename T>
+T &Entity::GetComponent()
+{
+    const EntityRecord &record = _world->_getRecord(_id);
+    const std::size_t   column =
+        record.location.archetype->GetColumn(ComponentTypeID::GetTypeID<T>());
+    if (column == Archetype::npos)
+        throw std::runtime_error("Entity does not own T component.");
+    // Written from a system, the component is stamped with the version of the run.
+    std::uint32_t version;
+    if (!Detail::RunVersionScope::Find(_world, version)) {
+        version = _world->GetChangeVersion();
+    }
+    record.location.archetype->MarkChanged(record.location, column, version);
+    return *static_cast<T *>(record.location.archetype->GetComponent(record.location, column));
+}
+
+template<typename T>
+const T &Entity::ReadComponent() const
+{
+    const EntityRecord &record = _world->_getRecord(_id);
+    const std::size_t   column =
+        record.location.archetype->GetColumn(ComponentTypeID::GetTypeID<T>());
+    if (column == Archetype::npos)
+        throw std::runtime_error("Entity does not own T component.");
+    return *static_cast<const T *>(
+        record.location.archetype->GetComponent(record.location, column));
+}
+
+template<typename T>
+bool Entity::HasComponent() const
+{
+    return _world->_getRecord(_id).location.archetype->Has(ComponentTypeID::GetTypeID<T>());
+}
+
+template<typename T>
+void Entity::DeleteComponent()
+{
+    const Netero::type_id componentID = ComponentTypeID::GetTypeID<T>();
+    EntityRecord &        record = _world->_getRecord(_id);
+    if (!record.location.archetype->Has(componentID))
+        throw std::runtime_error("Entity does not own T component.");
+    _world->_deleteComponent(_id, componentID);
+}
+
 } // namespace Netero::ECS
@@ -0,0 +1,165 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <string>
+#include <vector>
+
+#include <Netero/ECS/World.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Point {
+    float x;
+    float y;
+};
+
+struct Health {
+    int value;
+};
+
+struct Label {
+    std::string text;
+};
+
+struct Tracked {
+    explicit Tracked(std::string name): name(std::move(name)) { alive += 1; }
+    Tracked(Tracked &&other) noexcept: name(std::move(other.name)) { alive += 1; }
+    ~Tracked() { alive -= 1; }
+    std::string name;
+    static int  alive;
+};
+
+int Tracked::alive = 0;
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_archetype_plain_components)
+{
+    Netero::ECS::World  world;
+    Netero::ECS::Entity first = world.CreateEntity();
+    Netero::ECS::Entity second = world.CreateEntity();
+    first->AddComponent<Point>(1.f, 2.f);
+    second->AddComponent<Point>(3.f, 4.f);
+    // Same component set, same chunk, one array per component type.
+    EXPECT_EQ(&second->GetComponent<Point>(), &first->GetComponent<Point>() + 1);
+
+    first->AddComponent<Health>(10);
+    EXPECT_EQ(first->GetComponent<Point>().x, 1.f);
+    EXPECT_EQ(first->GetComponent<Health>().value, 10);
+    EXPECT_EQ(second->GetComponent<Point>().y, 4.f);
+    EXPECT_THROW(second->GetComponent<Health>(), std::runtime_error);
+
+    first->DeleteComponent<Point>();
+    EXPECT_THROW(first->GetComponent<Point>(), std::runtime_error);
+    EXPECT_EQ(first->GetComponent<Health>().value, 10);
+    EXPECT_EQ(first->GetComponentsFilter().size(), 1);
+}
+
+TEST(NeteroPatterns, ECS_archetype_chunks)
+{
+    Netero::ECS::World               world;
+    std::vector<Netero::ECS::Entity> entities;
+    for (int idx = 0; idx < 5000; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Health>(idx);
+        if (idx % 3 == 0) {
+            entities.back()->AddComponent<Point>(static_cast<float>(idx), 0.f);
+        }
+    }
+    // Killing entities move the last rows in the holes.
+    for (int idx = 0; idx < 5000; idx += 7) {
+        world.KillEntity(entities[idx]);
+    }
+    for (int idx = 0; idx < 5000; ++idx) {
+        if (idx % 7 == 0) {
+            continue;
+        }
+        EXPECT_EQ(entities[idx]->GetComponent<Health>().value, idx);
+        if (idx % 3 == 0) {
+            EXPECT_EQ(entities[idx]->GetComponent<Point>().x, static_cast<float>(idx));
+        }
+    }
+}
+
+TEST(NeteroPatterns, ECS_archetype_component_lifetime)
+{
+    {
+        Netero::ECS::World  world;
+        Netero::ECS::Entity first = world.CreateEntity();
+        Netero::ECS::Entity second = world.CreateEntity();
+        first->AddComponent<Tracked>("first");
+        second->AddComponent<Tracked>("second");
+        first->AddComponent<Health>(1);
+        EXPECT_EQ(Tracked::alive, 2);
+        EXPECT_EQ(first->GetComponent<Tracked>().name, "first");
+        first->DeleteComponent<Tracked>();
+        EXPECT_EQ(Tracked::alive, 1);
+        EXPECT_EQ(second->GetComponent<Tracked>().name, "second");
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(NeteroPatterns, ECS_create_entities)
+{
+    Netero::ECS::World  world;
+    Netero::ECS::Entity prototype = world.CreateEntity("prototype");
+    prototype->AddComponent<Point>(3.f, 4.f);
+    prototype->AddComponent<Label>("clone");
+
+    const auto clones = world.CreateEntities(5000, prototype, true);
+    ASSERT_EQ(clones.size(), 5000);
+    EXPECT_EQ(world.Size(), 5001);
+    EXPECT_EQ(world.GetStatistic().size, 5000);
+    for (auto clone : clones) {
+        ASSERT_EQ(clone->GetComponent<Point>().y, 4.f);
+        ASSERT_EQ(clone->GetComponent<Label>().text, "clone");
+        ASSERT_EQ(clone.GetName(), "unnamed");
+    }
+    int visited = 0;
+    world.Each<const Label>([&visited](const Label &) { visited += 1; });
+    EXPECT_EQ(visited, 5000);
+
+    Netero::ECS::Entity unique = world.CreateEntity();
+    unique->AddComponent<Tracked>("unique");
+    EXPECT_THROW(world.CreateEntities(2, unique), std::runtime_error);
+    EXPECT_EQ(world.Size(), 5002);
+}
+
+TEST(NeteroPatterns, ECS_chunk_pool)
+{
+    Netero::ECS::ChunkPool pool;
+    std::byte *            first = pool.Acquire(Netero::ECS::Archetype::chunkSize);
+    std::byte *            big = pool.Acquire(Netero::ECS::Archetype::chunkSize * 2);
+    pool.Release(first, Netero::ECS::Archetype::chunkSize);
+    pool.Release(big, Netero::ECS::Archetype::chunkSize * 2);
+    EXPECT_EQ(pool.GetFreeCount(), 1);
+    EXPECT_EQ(pool.Acquire(Netero::ECS::Archetype::chunkSize), first);
+    EXPECT_EQ(pool.GetFreeCount(), 0);
+    pool.Release(first, Netero::ECS::Archetype::chunkSize);
+    pool.Trim();
+    EXPECT_EQ(pool.GetFreeCount(), 0);
+}
+
+TEST(NeteroPatterns, ECS_world_trim_memory)
+{
+    Netero::ECS::World  world;
+    Netero::ECS::Entity prototype = world.CreateEntity();
+    prototype->AddComponent<Point>(Point { 1.f, 2.f });
+    std::vector<Netero::ECS::Entity> wave = world.CreateEntities(20000, prototype);
+    for (auto &entity : wave) {
+        world.KillEntity(entity);
+    }
+    const std::size_t released = world.TrimMemory();
+    EXPECT_GE(released, 20000 * sizeof(Point));
+    EXPECT_EQ(released % Netero::ECS::Archetype::chunkSize, 0);
+    EXPECT_EQ(world.TrimMemory(), 0);
+
+    // Chunks are allocated again for the next wave.
+    wave = world.CreateEntities(100, prototype, true);
+    EXPECT_EQ(wave.back()->GetComponent<Point>().y, 2.f);
+    EXPECT_EQ(prototype->GetComponent<Point>().x, 1.f);
+}
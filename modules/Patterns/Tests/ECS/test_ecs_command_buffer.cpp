@@ -0,0 +1,222 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Netero/ECS/CommandBuffer.hpp>
+#include <Netero/JobSystem.hpp>
+
+#include "test_ecs_dataset.hpp"
+
+#include <gtest/gtest.h>
+
+namespace ECS = Netero::ECS;
+
+namespace {
+
+std::atomic<int> g_spawnRuns = 0;
+std::atomic<int> g_foreignBatches = 0;
+
+/**
+ * Each entity with a Path spawn a named entity, and lose its Path, through the buffer.
+ */
+class SpawnSystem:
+    public ECS::System<ECS::ComponentFilter<Path<int>>,
+                       ECS::ComponentFilter<>,
+                       ECS::Read<Path<int>>> {
+    public:
+    explicit SpawnSystem(ECS::World &world)
+        : _world(world), _thread(std::this_thread::get_id())
+    {
+    }
+
+    void exec() final
+    {
+        ParallelForEach(
+            [this](ECS::Entity &entity) {
+                // Batches run on the job system of the world.
+                const int worker = _world.GetJobSystem().GetCurrentWorkerIndex();
+                if (worker < 0 && std::this_thread::get_id() != _thread) {
+                    g_foreignBatches += 1;
+                }
+                ECS::CommandBuffer &commands = _world.GetCommandBuffer();
+                ECS::Entity         spawned = commands.CreateEntity("spawned");
+                commands.AddComponent<Name>(spawned, "spawned");
+                commands.AddComponent<Position>(spawned, 1, 2);
+                commands.EnableEntity(spawned);
+                commands.DeleteComponent<Path<int>>(entity);
+            },
+            4);
+        g_spawnRuns += 1;
+    }
+
+    private:
+    ECS::World &          _world;
+    const std::thread::id _thread; /**< Running Update. */
+};
+
+/**
+ * Runs concurrently with SpawnSystem.
+ */
+class TextSystem:
+    public ECS::System<ECS::ComponentFilter<Text>, ECS::ComponentFilter<>, ECS::Read<Text>> {
+    public:
+    void exec() final {}
+};
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_command_buffer)
+{
+    ECS::World         world;
+    ECS::CommandBuffer commands;
+    ECS::Entity        first = world.CreateEntity();
+    ECS::Entity        second = world.CreateEntity();
+    first->AddComponent<Position>(1, 1);
+    first->AddComponent<Text>("text");
+
+    ECS::Entity created = commands.CreateEntity("created");
+    EXPECT_FALSE(created.Valid());
+    commands.AddComponent<Text>(created, "created");
+    commands.AddComponent<Position>(first, 5, 5);
+    commands.AddComponent<Name>(first, "first");
+    commands.DeleteComponent<Text>(first);
+    commands.DeleteComponent<Path<int>>(first);
+    commands.KillEntity(second);
+    commands.AddComponent<Name>(second, "dropped");
+    commands.EnableEntity(first);
+    EXPECT_EQ(commands.GetSize(), 9);
+    EXPECT_EQ(world.Size(), 2);
+
+    world.Playback(commands);
+    EXPECT_TRUE(commands.IsEmpty());
+    EXPECT_EQ(world.Size(), 2);
+    EXPECT_FALSE(second.Valid());
+    EXPECT_TRUE(first.IsEnabled());
+    EXPECT_EQ(first->GetComponent<Position>().x, 5);
+    EXPECT_EQ(first->GetComponent<Name>().name, "first");
+    EXPECT_FALSE(first->HasComponent<Text>());
+
+    ECS::Query &texts = world.GetQuery(ECS::ComponentFilter<Text>::GetMask(),
+                                       ECS::ComponentFilter<>::GetMask());
+    ASSERT_EQ(texts.GetUnactiveEntities().size(), 1);
+    ECS::Entity spawned = texts.GetUnactiveEntities()[0];
+    EXPECT_EQ(spawned.GetName(), "created");
+    EXPECT_EQ(spawned->GetComponent<Text>().text, "created");
+
+    // Components bigger than a block, and commands dropped without play back.
+    commands.AddComponent<Text>(first, std::string(20000, 'x'));
+    struct Big {
+        char data[20000];
+    };
+    commands.AddComponent<Big>(first);
+    commands.Clear();
+    EXPECT_TRUE(commands.IsEmpty());
+}
+
+TEST(NeteroPatterns, ECS_command_buffer_parallel_systems)
+{
+    Netero::JobSystem jobs(Netero::JobSystem::Options { 3 });
+    ECS::World        world;
+    world.SetJobSystem(jobs);
+    for (int idx = 0; idx < 200; ++idx) {
+        ECS::Entity entity = world.CreateEntity();
+        entity->AddComponent<Path<int>>(0, 0);
+        entity.Enable();
+    }
+    world.AddSystem<SpawnSystem>(world);
+    world.AddSystem<TextSystem>();
+    g_spawnRuns = 0;
+    world.Update();
+    EXPECT_EQ(g_spawnRuns, 1);
+    EXPECT_EQ(world.Size(), 400);
+    world.Update();
+    EXPECT_EQ(g_spawnRuns, 2);
+    EXPECT_EQ(world.Size(), 400);
+    int spawned = 0;
+    world.Each<const Name, const Position>([&spawned](const Name &name, const Position &position) {
+        spawned += name.name == "spawned" && position.y == 2;
+    });
+    EXPECT_EQ(spawned, 200);
+}
+
+TEST(NeteroPatterns, ECS_command_buffer_custom_job_system)
+{
+    Netero::JobSystem jobs(Netero::JobSystem::Options { 3 });
+    ECS::World        world;
+    world.SetJobSystem(jobs);
+    world.SetDeterministic(true);
+    for (int idx = 0; idx < 500; ++idx) {
+        ECS::Entity entity = world.CreateEntity();
+        entity->AddComponent<Path<int>>(0, 0);
+        entity.Enable();
+    }
+    world.AddSystem<SpawnSystem>(world);
+    g_foreignBatches = 0;
+    world.Update();
+    EXPECT_EQ(g_foreignBatches, 0);
+    EXPECT_EQ(world.Size(), 1000);
+
+    // Threads foreign to the job system record in buffers of their own.
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&world]() {
+            for (int idx = 0; idx < 100; ++idx) {
+                ECS::CommandBuffer &commands = world.GetCommandBuffer();
+                ECS::Entity         created = commands.CreateEntity();
+                commands.AddComponent<Position>(created, idx, idx);
+                commands.EnableEntity(created);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    world.FlushCommands();
+    EXPECT_EQ(world.Size(), 1400);
+    int recorded = 0;
+    world.Each<const Position>([&recorded](const Position &position) {
+        recorded += position.x == position.y;
+    });
+    EXPECT_EQ(recorded, 400);
+}
+
+TEST(NeteroPatterns, ECS_command_buffer_pending_handles)
+{
+    ECS::World         world;
+    ECS::CommandBuffer first;
+    ECS::CommandBuffer second;
+    first.CreateEntity("a");
+    ECS::Entity foreign = first.CreateEntity("b");
+    ECS::Entity own = second.CreateEntity("own");
+    // The handle of first match the index of an entity of second, it is dropped anyway.
+    second.CreateEntity("c");
+    second.AddComponent<Position>(foreign, 42, 42);
+    second.AddComponent<Position>(own, 1, 1);
+    world.Playback(first);
+    world.Playback(second);
+
+    // Kept past the play back, the handle is dropped by the next recording.
+    ECS::Entity stale = second.CreateEntity("stale");
+    world.Playback(second);
+    ECS::Entity next = second.CreateEntity("next");
+    second.AddComponent<Position>(next, 2, 2);
+    second.AddComponent<Position>(stale, 7, 7);
+    world.Playback(second);
+
+    std::vector<int> positions;
+    ECS::Query &     positioned = world.GetQuery(ECS::ComponentFilter<Position>::GetMask(),
+                                            ECS::ComponentFilter<>::GetMask());
+    for (auto entity : positioned.GetUnactiveEntities()) {
+        positions.push_back(entity->GetComponent<Position>().x);
+        EXPECT_EQ(entity.GetName(), entity->GetComponent<Position>().x == 1 ? "own" : "next");
+    }
+    std::sort(positions.begin(), positions.end());
+    EXPECT_EQ(positions, std::vector<int>({ 1, 2 }));
+}
@@ -3,6 +3,8 @@
  * see LICENCE.txt
  */
 
+#include <stdexcept>
+
 #include <Netero/ECS/Component.hpp>
 #include <Netero/ECS/ComponentFilter.hpp>
 
@@ -32,3 +34,45 @@ TEST(NeteroPatterns, component_filter)
     EXPECT_FALSE(filterA.IsSubsetOf(filterB));
     EXPECT_FALSE(filterAB.IsSubsetOf(filterA));
 }
+
+TEST(NeteroPatterns, component_filter_mask)
+{
+    const auto &maskAB = GroupAB::GetMask();
+    const auto &maskA = GroupA::GetMask();
+    const auto &maskB = GroupB::GetMask();
+    const auto &maskC = GroupC::GetMask();
+    EXPECT_TRUE(maskAB.Contains(maskA));
+    EXPECT_TRUE(maskAB.Contains(maskB));
+    EXPECT_TRUE(maskA.Contains(maskC));
+    EXPECT_FALSE(maskA.Contains(maskB));
+    EXPECT_FALSE(maskA.Contains(maskAB));
+    EXPECT_TRUE(maskAB.Intersects(maskA));
+    EXPECT_FALSE(maskA.Intersects(maskB));
+    EXPECT_FALSE(maskAB.Intersects(maskC));
+    EXPECT_TRUE(maskC.IsEmpty());
+    EXPECT_TRUE(maskAB.Test(Netero::ECS::ComponentTypeID::GetTypeID<CompA>()));
+}
+
+TEST(NeteroPatterns, component_mask_wide)
+{
+    using Mask = Netero::ECS::BasicComponentMask<512>;
+    Mask signature;
+    Mask include;
+    Mask exclude;
+    for (Netero::type_id id : { 0, 63, 64, 200, 511 }) {
+        signature.Set(id);
+    }
+    include.Set(64);
+    include.Set(511);
+    exclude.Set(300);
+    EXPECT_TRUE(signature.Contains(include));
+    EXPECT_FALSE(signature.Intersects(exclude));
+    exclude.Set(200);
+    EXPECT_TRUE(signature.Intersects(exclude));
+    include.Set(65);
+    EXPECT_FALSE(signature.Contains(include));
+    signature.Reset(511);
+    EXPECT_FALSE(signature.Test(511));
+    EXPECT_FALSE(signature.Test(4096));
+    EXPECT_THROW(signature.Set(512), std::length_error);
+}
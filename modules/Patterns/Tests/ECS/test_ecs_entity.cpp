@@ -32,3 +32,30 @@ TEST(NeteroPatterns, entityLocalScope)
     stat = world.GetStatistic();
     EXPECT_EQ(stat.size, 1);
 }
+
+TEST(NeteroPatterns, entityGenerationalId)
+{
+    Netero::ECS::World  world;
+    Netero::ECS::Entity first = world.CreateEntity("first");
+    Netero::ECS::Entity copy = first;
+    const auto          firstId = first.GetId();
+    EXPECT_EQ(first.GetName(), "first");
+    first.Kill();
+    EXPECT_FALSE(first.Valid());
+    // Every copy of the handle is stale, even once the slot is reused.
+    EXPECT_FALSE(copy.Valid());
+    Netero::ECS::Entity second = world.CreateEntity();
+    EXPECT_EQ(second.GetId().index, firstId.index);
+    EXPECT_EQ(second.GetId().generation, firstId.generation + 1);
+    EXPECT_EQ(second.GetName(), "unnamed");
+    EXPECT_FALSE(copy.Valid());
+    EXPECT_FALSE(world.IsAlive(copy));
+    EXPECT_THROW(copy->AddComponent<int>(1), std::runtime_error);
+    EXPECT_THROW(copy->GetComponent<int>(), std::runtime_error);
+    world.KillEntity(copy);
+    EXPECT_TRUE(second.Valid());
+    EXPECT_EQ(world.Size(), 1);
+
+    Netero::ECS::World other;
+    EXPECT_FALSE(other.IsAlive(second));
+}
@@ -0,0 +1,185 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Netero/ECS/ComponentFilter.hpp>
+
+#include "test_ecs_dataset.hpp"
+
+#include <gtest/gtest.h>
+
+namespace ECS = Netero::ECS;
+
+namespace {
+
+using Named = ECS::ComponentFilter<Name>;
+using Positioned = ECS::ComponentFilter<Position>;
+
+ECS::Query &GetNamedQuery(ECS::World &world, const ECS::ComponentMask &exclude)
+{
+    return world.GetQuery(Named::GetMask(), exclude);
+}
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_query_incremental)
+{
+    ECS::World  world;
+    ECS::Entity first = world.CreateEntity();
+    ECS::Entity second = world.CreateEntity();
+    first->AddComponent<Name>("first");
+    // Created after the entities, the query collect the existing ones.
+    ECS::Query &named = GetNamedQuery(world, ECS::ComponentFilter<>::GetMask());
+    ECS::Query &namedOnly = GetNamedQuery(world, Positioned::GetMask());
+    EXPECT_EQ(&named, &GetNamedQuery(world, ECS::ComponentFilter<>::GetMask()));
+    EXPECT_EQ(named.GetUnactiveEntities().size(), 1);
+    EXPECT_EQ(named.GetActiveEntities().size(), 0);
+
+    first.Enable();
+    second.Enable();
+    EXPECT_EQ(named.GetActiveEntities().size(), 1);
+    EXPECT_EQ(named.GetUnactiveEntities().size(), 0);
+
+    second->AddComponent<Name>("second");
+    second->AddComponent<Position>(1, 2);
+    EXPECT_EQ(named.GetActiveEntities().size(), 2);
+    EXPECT_EQ(namedOnly.GetActiveEntities().size(), 1);
+    EXPECT_TRUE(namedOnly.GetActiveEntities()[0] == first);
+
+    second.Disable();
+    EXPECT_EQ(named.GetActiveEntities().size(), 1);
+    EXPECT_EQ(named.GetUnactiveEntities().size(), 1);
+
+    second->DeleteComponent<Position>();
+    EXPECT_EQ(namedOnly.GetUnactiveEntities().size(), 1);
+    first->DeleteComponent<Name>();
+    EXPECT_EQ(named.GetActiveEntities().size(), 0);
+    EXPECT_EQ(namedOnly.GetActiveEntities().size(), 0);
+
+    world.KillEntity(second);
+    EXPECT_EQ(named.GetUnactiveEntities().size(), 0);
+    EXPECT_EQ(namedOnly.GetUnactiveEntities().size(), 0);
+    EXPECT_EQ(named.GetArchetypes().size(), 2);
+}
+
+TEST(NeteroPatterns, ECS_query_swap_remove)
+{
+    ECS::World               world;
+    std::vector<ECS::Entity> entities;
+    ECS::Query &             named = GetNamedQuery(world, ECS::ComponentFilter<>::GetMask());
+    for (int idx = 0; idx < 100; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Name>(std::to_string(idx));
+        entities.back().Enable();
+    }
+    for (int idx = 0; idx < 100; idx += 3) {
+        world.KillEntity(entities[idx]);
+    }
+    for (int idx = 1; idx < 100; idx += 3) {
+        entities[idx].Disable();
+    }
+    EXPECT_EQ(named.GetActiveEntities().size(), 33);
+    EXPECT_EQ(named.GetUnactiveEntities().size(), 33);
+    for (auto entity : named.GetActiveEntities()) {
+        EXPECT_TRUE(entity.IsEnabled());
+        EXPECT_EQ(std::stoi(entity.GetComponent<Name>().name) % 3, 2);
+    }
+}
+
+TEST(NeteroPatterns, ECS_query_each)
+{
+    ECS::World               world;
+    std::vector<ECS::Entity> entities;
+    for (int idx = 0; idx < 3000; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>(idx, 0);
+        if (idx % 2) {
+            entities.back()->AddComponent<Name>("odd");
+        }
+        entities.back().Enable();
+    }
+    for (int idx = 0; idx < 3000; idx += 10) {
+        entities[idx].Disable();
+    }
+    for (int idx = 3; idx < 3000; idx += 10) {
+        world.KillEntity(entities[idx]);
+    }
+
+    int visited = 0;
+    world.Each<Position>([&visited](Position &position) {
+        position.y = 1;
+        visited += 1;
+    });
+    EXPECT_EQ(visited, 2400);
+    visited = 0;
+    world.Each<const Name, Position>([&visited](const Name &name, Position &position) {
+        EXPECT_EQ(name.name, "odd");
+        EXPECT_EQ(position.x % 2, 1);
+        visited += position.y;
+    });
+    EXPECT_EQ(visited, 1200);
+    EXPECT_EQ(entities[0]->GetComponent<Position>().y, 0);
+    EXPECT_EQ(entities[1]->GetComponent<Position>().y, 1);
+
+    ECS::Query &named = GetNamedQuery(world, ECS::ComponentFilter<>::GetMask());
+    EXPECT_THROW(named.Each<Position>([](Position &) {}), std::runtime_error);
+}
+
+TEST(NeteroPatterns, ECS_query_changed)
+{
+    ECS::World               world;
+    std::vector<ECS::Entity> entities;
+    for (int idx = 0; idx < 3000; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>(idx, 0);
+        entities.back().Enable();
+    }
+    const std::uint32_t since = world.GetChangeVersion();
+    int                 visited = 0;
+    const auto          count = [&visited](const Position &) { visited += 1; };
+    world.Each<ECS::Changed<const Position>>(count);
+    EXPECT_EQ(visited, 3000);
+    visited = 0;
+    world.Each<ECS::Changed<const Position>>(count, since);
+    EXPECT_EQ(visited, 0);
+
+    world.Update();
+    entities[5]->GetComponent<Position>().y = 1;
+    EXPECT_EQ(entities[2500]->ReadComponent<Position>().x, 2500);
+    entities[7]->AddComponent<Name>("added");
+    // The last entity is moved in the hole of the killed one, its version follow it.
+    entities.back()->GetComponent<Position>().y = 1;
+    world.KillEntity(entities[0]);
+    world.Each<ECS::Changed<const Position>>(count, since);
+    EXPECT_EQ(visited, 2);
+    // Adding Name moved the Position of the entity, it is neither changed nor added.
+    visited = 0;
+    world.Each<ECS::Added<const Position>>(count, since);
+    EXPECT_EQ(visited, 0);
+    visited = 0;
+    world.Each<ECS::Added<const Name>, Position>(
+        [&visited](const Name &name, Position &position) {
+            EXPECT_EQ(name.name, "added");
+            position.y = 2;
+            visited += 1;
+        },
+        since);
+    EXPECT_EQ(visited, 1);
+
+    // Written components are marked as changed.
+    world.Update();
+    const std::uint32_t updated = world.GetChangeVersion();
+    world.Each<Position>([](Position &position) { position.x += 1; });
+    visited = 0;
+    world.Each<ECS::Changed<const Position>>(count, updated - 1);
+    EXPECT_EQ(visited, 2999);
+    visited = 0;
+    world.Each<ECS::Changed<const Position>>(count, updated);
+    EXPECT_EQ(visited, 0);
+}
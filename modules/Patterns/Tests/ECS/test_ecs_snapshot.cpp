@@ -0,0 +1,189 @@
+/**
+ * Netero sources under BSD-3-Clause
+ * see LICENCE.txt
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Netero/ECS/Snapshot.hpp>
+
+#include "test_ecs_dataset.hpp"
+
+#include <gtest/gtest.h>
+
+namespace ECS = Netero::ECS;
+
+namespace {
+
+struct Transform {
+    float x;
+    float y;
+};
+
+struct Health {
+    int value;
+};
+
+ECS::SnapshotRegistry MakeRegistry()
+{
+    ECS::SnapshotRegistry registry;
+    registry.Register<Transform>("Transform");
+    registry.Register<Health>("Health", 2);
+    return registry;
+}
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_snapshot_roundtrip)
+{
+    const ECS::SnapshotRegistry registry = MakeRegistry();
+    ECS::World                  world;
+    std::vector<ECS::Entity>    entities;
+    for (int idx = 0; idx < 5000; ++idx) {
+        entities.push_back(idx % 100 ? world.CreateEntity() : world.CreateEntity("named"));
+        entities.back()->AddComponent<Transform>(Transform { float(idx), 0.f });
+        if (idx % 3 == 0) {
+            entities.back()->AddComponent<Health>(Health { idx });
+        }
+        if (idx % 7) {
+            entities.back().Enable();
+        }
+    }
+    for (int idx = 1; idx < 5000; idx += 50) {
+        world.KillEntity(entities[idx]);
+    }
+    ECS::Query &transforms = world.GetQuery(ECS::ComponentFilter<Transform>::GetMask(),
+                                            ECS::ComponentFilter<>::GetMask());
+    const std::size_t active = transforms.GetActiveEntities().size();
+    const std::size_t size = world.Size();
+
+    ECS::Snapshot checkpoint;
+    checkpoint.Capture(world, registry);
+    EXPECT_FALSE(checkpoint.IsEmpty());
+
+    std::vector<ECS::Entity> killed;
+    for (int idx = 0; idx < 5000; idx += 10) {
+        killed.push_back(entities[idx]);
+        world.KillEntity(killed.back());
+    }
+    for (int idx = 0; idx < 300; ++idx) {
+        world.CreateEntity("spawned")->AddComponent<Health>(Health { -1 });
+    }
+    world.Each<Transform>([](Transform &transform) { transform.y = 1.f; });
+    entities[2]->AddComponent<Health>(Health { -2 });
+
+    const std::uint32_t since = world.GetChangeVersion();
+    checkpoint.Restore(world, registry);
+    EXPECT_EQ(world.Size(), size);
+    EXPECT_EQ(transforms.GetActiveEntities().size(), active);
+    EXPECT_EQ(world.GetStatistic().size, active);
+    for (int idx = 0; idx < 5000; ++idx) {
+        ECS::Entity &entity = entities[idx];
+        if (idx % 50 == 1) {
+            EXPECT_FALSE(entity.Valid());
+            continue;
+        }
+        ASSERT_TRUE(entity.Valid());
+        EXPECT_EQ(entity.IsEnabled(), idx % 7 != 0);
+        EXPECT_EQ(entity->ReadComponent<Transform>().x, float(idx));
+        EXPECT_EQ(entity->ReadComponent<Transform>().y, 0.f);
+        EXPECT_EQ(entity->HasComponent<Health>(), idx % 3 == 0);
+        if (idx % 3 == 0) {
+            EXPECT_EQ(entity->ReadComponent<Health>().value, idx);
+        }
+        EXPECT_EQ(entity.GetName(), idx % 100 ? "unnamed" : "named");
+    }
+
+    // Restored components count as added, the world stays usable.
+    int added = 0;
+    world.Each<ECS::Added<const Health>>([&added](const Health &) { added += 1; }, since);
+    EXPECT_EQ(added, 1400); // Enabled entities with a Health.
+    ECS::Entity spawned = world.CreateEntity();
+    spawned->AddComponent<Transform>(Transform { -1.f, -1.f });
+    spawned.Enable();
+    EXPECT_EQ(transforms.GetActiveEntities().size(), active + 1);
+}
+
+TEST(NeteroPatterns, ECS_snapshot_registry)
+{
+    const ECS::SnapshotRegistry registry = MakeRegistry();
+    ECS::World                  world;
+    ECS::Entity                 entity = world.CreateEntity();
+    entity->AddComponent<Transform>(Transform { 1.f, 2.f });
+    entity->AddComponent<Health>(Health { 3 });
+    entity.Enable();
+
+    ECS::SnapshotRegistry duplicated;
+    duplicated.Register<Health>("Health");
+    EXPECT_THROW(duplicated.Register<Transform>("Health"), std::runtime_error);
+    EXPECT_THROW(duplicated.Register<Health>("Life"), std::runtime_error);
+
+    ECS::Snapshot snapshot;
+    entity->AddComponent<Name>("name");
+    EXPECT_THROW(snapshot.Capture(world, registry), std::runtime_error);
+    entity->DeleteComponent<Name>();
+    snapshot.Capture(world, registry);
+
+    // Loaded in another world, from a copy of the bytes.
+    ECS::World    other;
+    ECS::Snapshot loaded(snapshot.GetData());
+    loaded.Restore(other, registry);
+    EXPECT_EQ(other.Size(), 1);
+    other.Each<const Transform, const Health>(
+        [](const Transform &transform, const Health &health) {
+            EXPECT_EQ(transform.y, 2.f);
+            EXPECT_EQ(health.value, 3);
+        });
+
+    // Another version of a component, or truncated data, leave the world untouched.
+    ECS::SnapshotRegistry upgraded;
+    upgraded.Register<Transform>("Transform");
+    upgraded.Register<Health>("Health", 3);
+    entity->GetComponent<Health>().value = 4;
+    EXPECT_THROW(snapshot.Restore(world, upgraded), std::runtime_error);
+    std::vector<std::byte> truncated = snapshot.GetData();
+    truncated.resize(truncated.size() - 1);
+    EXPECT_THROW(ECS::Snapshot(truncated).Restore(world, registry), std::runtime_error);
+    EXPECT_THROW(ECS::Snapshot().Restore(world, registry), std::runtime_error);
+    EXPECT_EQ(entity->GetComponent<Health>().value, 4);
+}
+
+TEST(NeteroPatterns, ECS_snapshot_stale_handles)
+{
+    const ECS::SnapshotRegistry registry = MakeRegistry();
+    ECS::World                  world;
+    ECS::Entity                 kept = world.CreateEntity();
+    ECS::Entity                 killed = world.CreateEntity();
+    kept->AddComponent<Health>(Health { 1 });
+    world.KillEntity(killed);
+    ECS::Snapshot checkpoint;
+    checkpoint.Capture(world, registry);
+
+    // Taken after the capture, in the free slot, in new slots and in the slot of kept.
+    std::vector<ECS::Entity> created;
+    for (int idx = 0; idx < 3; ++idx) {
+        created.push_back(world.CreateEntity());
+        created.back()->AddComponent<Health>(Health { 2 });
+    }
+    ECS::Entity copy = kept;
+    world.KillEntity(copy);
+    created.push_back(world.CreateEntity());
+    checkpoint.Restore(world, registry);
+    EXPECT_TRUE(kept.Valid());
+    for (const auto &entity : created) {
+        EXPECT_FALSE(entity.Valid());
+    }
+
+    // Their slots are reused, the handles stay invalid.
+    world.KillEntity(kept);
+    for (int idx = 0; idx < 10; ++idx) {
+        world.CreateEntity()->AddComponent<Health>(Health { 3 });
+    }
+    EXPECT_EQ(world.Size(), 10);
+    for (const auto &entity : created) {
+        EXPECT_FALSE(entity.Valid());
+    }
+}
@@ -3,9 +3,19 @@
  * see LICENCE.txt
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include <Netero/ECS/SystemGraph.hpp>
+#include <Netero/JobSystem.hpp>
 #include <Netero/Logger.hpp>
+#include <Netero/Parallel.hpp>
 
 #include "test_ecs_dataset.hpp"
 
@@ -93,3 +103,336 @@ TEST(NeteroPatterns, ECS_system)
     world.AddSystem<NameSystem>();
     world.Update();
 }
+
+namespace {
+
+std::atomic<int> g_moveRuns = 0;
+std::atomic<int> g_textRuns = 0;
+
+class MoveSystem:
+    public ECS::System<ECS::ComponentFilter<Position>,
+                       ECS::ComponentFilter<>,
+                       ECS::Read<Path<int>>,
+                       ECS::Write<Position>> {
+    public:
+    void exec() final
+    {
+        for (auto entity : GetActiveEntities()) {
+            entity->GetComponent<Position>().x += 1;
+        }
+        g_moveRuns += 1;
+    }
+};
+
+class TextSystem:
+    public ECS::System<ECS::ComponentFilter<Text>, ECS::ComponentFilter<>, ECS::Read<Text>> {
+    public:
+    void exec() final { g_textRuns += 1; }
+};
+
+class CountSystem: public ECS::System<ECS::ComponentFilter<Position>> {
+    public:
+    explicit CountSystem(int &count): _count(count) {}
+    void exec() final { _count = static_cast<int>(GetActiveEntities().size()); }
+
+    private:
+    int &_count;
+};
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_system_graph)
+{
+    ECS::SystemAccess exclusive;
+    ECS::SystemAccess readText;
+    ECS::SystemAccess writePosition;
+    ECS::SystemAccess readPosition;
+    readText.exclusive = false;
+    readText.read.Set(ECS::ComponentTypeID::GetTypeID<Text>());
+    writePosition.exclusive = false;
+    writePosition.write.Set(ECS::ComponentTypeID::GetTypeID<Position>());
+    readPosition.exclusive = false;
+    readPosition.read.Set(ECS::ComponentTypeID::GetTypeID<Position>());
+
+    ECS::SystemGraph graph;
+    graph.Build({ readText, writePosition, readText, readPosition, exclusive, readText });
+    EXPECT_TRUE(graph.GetDependencies(1).empty());
+    EXPECT_TRUE(graph.GetDependencies(2).empty());
+    EXPECT_EQ(graph.GetDependencies(3), std::vector<std::size_t>({ 1 }));
+    EXPECT_EQ(graph.GetDependencies(4), std::vector<std::size_t>({ 0, 1, 2, 3 }));
+    EXPECT_EQ(graph.GetDependencies(5), std::vector<std::size_t>({ 4 }));
+    EXPECT_EQ(graph.GetDepth(), 4);
+
+    Netero::JobSystem        jobs(Netero::JobSystem::Options { 2 });
+    std::vector<std::size_t> order;
+    std::mutex               orderLock;
+    graph.RunParallel(jobs, [&](std::size_t system) {
+        std::lock_guard<std::mutex> lock(orderLock);
+        order.push_back(system);
+    });
+    ASSERT_EQ(order.size(), 6);
+    const auto rank = [&](std::size_t system) {
+        return std::find(order.begin(), order.end(), system) - order.begin();
+    };
+    EXPECT_LT(rank(1), rank(3));
+    EXPECT_LT(rank(3), rank(4));
+    EXPECT_LT(rank(0), rank(4));
+    EXPECT_EQ(order.back(), 5);
+}
+
+TEST(NeteroPatterns, ECS_system_parallel_update)
+{
+    Netero::JobSystem jobs(Netero::JobSystem::Options { 2 });
+    ECS::World        world;
+    int               count = 0;
+    world.SetJobSystem(jobs);
+    for (int idx = 0; idx < 64; ++idx) {
+        ECS::Entity entity = world.CreateEntity();
+        entity->AddComponent<Position>(idx, 0);
+        entity->AddComponent<Text>("entity");
+        entity.Enable();
+    }
+    world.AddSystem<MoveSystem>();
+    world.AddSystem<TextSystem>();
+    world.AddSystem<CountSystem>(count);
+    g_moveRuns = 0;
+    g_textRuns = 0;
+    for (int frame = 0; frame < 10; ++frame) {
+        world.Update();
+    }
+    world.SetDeterministic(true);
+    world.Update();
+    EXPECT_EQ(g_moveRuns, 11);
+    EXPECT_EQ(g_textRuns, 11);
+    EXPECT_EQ(count, 64);
+    world.RemoveSystem<TextSystem>();
+    world.Update();
+    EXPECT_EQ(g_textRuns, 11);
+}
+
+namespace {
+
+class IntegrateSystem:
+    public ECS::System<ECS::ComponentFilter<Position>,
+                       ECS::ComponentFilter<>,
+                       ECS::Write<Position>> {
+    public:
+    void exec() final
+    {
+        ParallelForEach([](ECS::Entity &entity) { entity->GetComponent<Position>().y += 2; }, 16);
+    }
+};
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_system_parallel_for_each)
+{
+    ECS::World world;
+    for (int idx = 0; idx < 1000; ++idx) {
+        ECS::Entity entity = world.CreateEntity();
+        entity->AddComponent<Position>(idx, 0);
+        entity.Enable();
+    }
+    world.AddSystem<IntegrateSystem>();
+    world.Update();
+
+    ECS::Query &query = world.GetQuery(ECS::ComponentFilter<Position>::GetMask(),
+                                       ECS::ComponentFilter<>::GetMask());
+    Netero::PerWorker<int> checked(Netero::JobSystem::GetDefault(), 0);
+    query.ParallelForEach(checked, [](ECS::Entity &entity, int &count) {
+        count += entity->GetComponent<Position>().y == 2;
+    });
+    int total = 0;
+    checked.ForEach([&total](int count) { total += count; });
+    EXPECT_EQ(total, 1000);
+}
+
+namespace {
+
+class EachSystem:
+    public ECS::System<ECS::ComponentFilter<Position, Text>,
+                       ECS::ComponentFilter<>,
+                       ECS::Access<Position, const Text>> {
+    public:
+    void exec() final
+    {
+        Each<Position, const Text>([](Position &position, const Text &) { position.y += 1; });
+        EXPECT_THROW(Each<Text>([](Text &) {}), std::logic_error);
+    }
+};
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_system_each)
+{
+    const EachSystem         system;
+    const ECS::SystemAccess &access = system.GetAccess();
+    EXPECT_FALSE(access.exclusive);
+    EXPECT_TRUE(access.write.Test(ECS::ComponentTypeID::GetTypeID<Position>()));
+    EXPECT_TRUE(access.read.Test(ECS::ComponentTypeID::GetTypeID<Text>()));
+    EXPECT_FALSE(access.write.Test(ECS::ComponentTypeID::GetTypeID<Text>()));
+
+    ECS::World  world;
+    ECS::Entity entity = world.CreateEntity();
+    entity->AddComponent<Position>();
+    entity->AddComponent<Text>("text");
+    entity.Enable();
+    world.AddSystem<EachSystem>();
+    world.Update();
+    EXPECT_EQ(entity->GetComponent<Position>().y, 1);
+}
+
+namespace {
+
+int g_reacted = 0;
+
+class ReactSystem:
+    public ECS::System<ECS::ComponentFilter<Position>,
+                       ECS::ComponentFilter<>,
+                       ECS::Access<ECS::Changed<const Position>>> {
+    public:
+    void exec() final
+    {
+        Each<ECS::Changed<const Position>>([](const Position &) { g_reacted += 1; });
+    }
+};
+
+std::atomic<bool> g_concurrentStarted = false;
+std::atomic<int>  g_chased = 0;
+
+/**
+ * Write the Position it react to, while ConcurrentSystem starts and bump the version of
+ * the world.
+ */
+class ChaseSystem:
+    public ECS::System<ECS::ComponentFilter<Position>,
+                       ECS::ComponentFilter<>,
+                       ECS::Access<ECS::Changed<Position>>> {
+    public:
+    void exec() final
+    {
+        for (int wait = 0; !g_concurrentStarted && wait < 200; ++wait) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        g_concurrentStarted = false;
+        Each<ECS::Changed<Position>>([](Position &position) {
+            position.y += 1;
+            g_chased += 1;
+        });
+        // Written from the threads of the job system as well.
+        ParallelForEach([](ECS::Entity &entity) {
+            Position &position = entity->GetComponent<Position>();
+            position.y = std::min(position.y, 10);
+        });
+    }
+};
+
+class ConcurrentSystem:
+    public ECS::System<ECS::ComponentFilter<Text>, ECS::ComponentFilter<>, ECS::Read<Text>> {
+    public:
+    void exec() final { g_concurrentStarted = true; }
+};
+
+} // namespace
+
+TEST(NeteroPatterns, ECS_system_changed)
+{
+    const ReactSystem system;
+    EXPECT_TRUE(system.GetAccess().read.Test(ECS::ComponentTypeID::GetTypeID<Position>()));
+    EXPECT_TRUE(system.GetAccess().write.IsEmpty());
+
+    ECS::World               world;
+    std::vector<ECS::Entity> entities;
+    for (int idx = 0; idx < 1000; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>(idx, 0);
+        entities.back().Enable();
+    }
+    world.AddSystem<ReactSystem>();
+    world.Update();
+    EXPECT_EQ(g_reacted, 1000);
+    world.Update();
+    EXPECT_EQ(g_reacted, 1000);
+    entities[10]->GetComponent<Position>().x = 0;
+    entities[900]->GetComponent<Position>().x = 0;
+    world.Update();
+    EXPECT_EQ(g_reacted, 1002);
+
+    // Changes of a system running after are seen on the next update.
+    world.AddSystem<IntegrateSystem>();
+    world.SetDeterministic(true);
+    world.Update();
+    EXPECT_EQ(g_reacted, 1002);
+    world.Update();
+    EXPECT_EQ(g_reacted, 2002);
+}
+
+TEST(NeteroPatterns, ECS_system_changed_concurrent)
+{
+    Netero::JobSystem jobs(Netero::JobSystem::Options { 2 });
+    ECS::World        world;
+    world.SetJobSystem(jobs);
+    std::vector<ECS::Entity> entities;
+    for (int idx = 0; idx < 100; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>(idx, 0);
+        entities.back().Enable();
+    }
+    world.AddSystem<ChaseSystem>();
+    world.AddSystem<ConcurrentSystem>();
+    g_chased = 0;
+    world.Update();
+    EXPECT_EQ(g_chased, 100);
+    // Its own writes are stamped with the version of its run, not seen on the next ones.
+    for (int frame = 0; frame < 15; ++frame) {
+        world.Update();
+    }
+    EXPECT_EQ(g_chased, 100);
+    entities[3]->GetComponent<Position>().x = 5;
+    world.Update();
+    EXPECT_EQ(g_chased, 101);
+}
+
+TEST(NeteroPatterns, ECS_world_statistic)
+{
+    ECS::World               world;
+    std::vector<ECS::Entity> entities;
+    for (int idx = 0; idx < 100; ++idx) {
+        entities.push_back(world.CreateEntity());
+        entities.back()->AddComponent<Position>(idx, 0);
+        if (idx % 4) {
+            entities.back().Enable();
+        }
+    }
+    for (int idx = 0; idx < 100; idx += 10) {
+        world.KillEntity(entities[idx]);
+    }
+    world.SetStatisticWindow(4);
+    world.AddSystem<IntegrateSystem>();
+    world.AddSystem<ReactSystem>();
+    for (int frame = 0; frame < 6; ++frame) {
+        world.Update();
+    }
+
+    const ECS::World::Statistic &statistic = world.GetStatistic();
+    EXPECT_EQ(statistic.activeEntities, 70);
+    EXPECT_EQ(statistic.size, 70);
+    EXPECT_EQ(statistic.unactiveEntities, 20);
+    EXPECT_EQ(statistic.garbadgeSize, 10);
+    EXPECT_EQ(statistic.frame, 6);
+    EXPECT_GE(statistic.updateNs, statistic.cacheRebuildNs);
+    ASSERT_EQ(statistic.systems.size(), 2);
+    EXPECT_NE(statistic.systems[0].name.find("IntegrateSystem"), std::string_view::npos);
+    EXPECT_EQ(statistic.systems[0].matchedEntities, 70);
+    EXPECT_LE(statistic.systems[0].durationNs, statistic.updateNs);
+
+    EXPECT_EQ(world.GetUpdateHistory().GetSnapshot().count, 4);
+    EXPECT_EQ(world.GetCacheRebuildHistory().GetSize(), 4);
+    const auto integrate = world.GetSystemHistory<IntegrateSystem>().GetSnapshot();
+    EXPECT_EQ(integrate.count, 4);
+    EXPECT_EQ(world.GetSystemHistory<IntegrateSystem>().GetLast(),
+              statistic.systems[0].durationNs);
+    EXPECT_THROW(world.GetSystemHistory<EachSystem>(), std::runtime_error);
+    const auto overall = Netero::Metrics::Registry::GetDefault().TakeSnapshot();
+    EXPECT_GE(overall.histograms.at("ecs.world.update.duration_ns").count, 6);
+}
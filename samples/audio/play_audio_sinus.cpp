@@ -9,6 +9,7 @@
 #include <thread>
 
 #include <Netero/Audio/DeviceManager.hpp>
+#include <Netero/Clock.hpp>
 #include <Netero/Netero.hpp>
 
 int main()
@@ -44,10 +45,8 @@ int main()
 
     device->Open();
 
-    auto start = std::chrono::system_clock::now();
-    while (10 > std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() -
-                                                                 start)
-                    .count()) {
+    Netero::Stopwatch stopwatch;
+    while (stopwatch.Elapsed() < std::chrono::seconds(10)) {
         std::this_thread::yield();
     }
 
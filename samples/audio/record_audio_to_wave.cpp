@@ -8,6 +8,7 @@
 
 #include <Netero/Audio/DeviceManager.hpp>
 #include <Netero/Audio/WaveFile.hpp>
+#include <Netero/Clock.hpp>
 #include <Netero/Logger.hpp>
 
 int ChooseDevice()
@@ -69,10 +70,8 @@ int main()
 
     device->SetAcquisitionCallback(acquisitionCallback);
     device->Open();
-    auto start = std::chrono::system_clock::now();
-    while (10 > std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() -
-                                                                 start)
-                    .count()) {
+    Netero::Stopwatch stopwatch;
+    while (stopwatch.Elapsed() < std::chrono::seconds(10)) {
         std::this_thread::yield();
     }
 
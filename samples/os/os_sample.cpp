@@ -34,6 +34,16 @@ int main()
     LOG << Netero::Os::GetBundlePath() << std::endl;
     LOG << Netero::Os::GetExecutablePath() << std::endl;
 
+    // Pin the main thread on the first cpu and try to run it under a realtime policy.
+    // Without privilege the request is rejected and the thread is left untouched.
+    Netero::Os::CpuMask mask;
+    mask.set(0);
+    LOG << "Affinity: " << Netero::Os::RtCodeToString(Netero::Os::SetThreadAffinity(mask))
+        << std::endl;
+    const auto result =
+        Netero::Os::SetThreadRealtimePriority(Netero::Os::GetRealtimePriorityMin());
+    LOG << "Realtime priority: " << Netero::Os::RtCodeToString(result) << std::endl;
+
     LOG << "A raw log." << std::endl;
     LOG_INFO << "A simple log." << std::endl;
     LOG_DEBUG << "A debug log." << std::endl;